@@ -4,10 +4,12 @@
 #include "Ammo.h"
 
 #include "ShooterCharacter.h"
+#include "ShooterStats.h"
 #include "Components/BoxComponent.h"
-#include "Components/WidgetComponent.h"
 #include "Components/SphereComponent.h"
 
+DECLARE_CYCLE_STAT(TEXT("Ammo Tick"), STAT_AmmoTick, STATGROUP_Shooter);
+
 
 AAmmo::AAmmo()
 {
@@ -18,7 +20,6 @@ AAmmo::AAmmo()
 	SetRootComponent(AmmoMesh);
 
 	GetCollisionBox()->SetupAttachment(GetRootComponent());
-	GetPickupWidget()->SetupAttachment(GetRootComponent());
 	GetAreaSphere()->SetupAttachment(GetRootComponent());
 
 	AmmoCollisionSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AmmoCollisionSphere"));
@@ -91,6 +92,14 @@ void AAmmo::AmmoSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 	}
 }
 
+void AAmmo::ActivateFromPool(const FTransform& Transform, FName InPickupId)
+{
+	Super::ActivateFromPool(Transform, InPickupId);
+
+	// Turned off when the ammo was picked up
+	AmmoCollisionSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+}
+
 void AAmmo::EnableCustomDepth()
 {
 	AmmoMesh->SetRenderCustomDepth(true);
@@ -103,6 +112,7 @@ void AAmmo::DisableCustomDepth()
 
 void AAmmo::Tick(float DeltaTime)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_AmmoTick, Items);
 	Super::Tick(DeltaTime);
 }
 
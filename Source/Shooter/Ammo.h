@@ -36,6 +36,8 @@ public:
 	virtual void EnableCustomDepth() override;
 	virtual void DisableCustomDepth() override;
 
+	virtual void ActivateFromPool(const FTransform& Transform, FName InPickupId) override;
+
 private:
 	// Mesh for the ammo pickup
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Ammo, meta = (AllowPrivateAccess = "true"))
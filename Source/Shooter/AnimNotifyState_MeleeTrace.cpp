@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "AnimNotifyState_MeleeTrace.h"
+
+#include "Enemy.h"
+#include "MeleeTraceSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+
+void UAnimNotifyState_MeleeTrace::NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation,
+	float TotalDuration)
+{
+	Super::NotifyBegin(MeshComp, Animation, TotalDuration);
+
+	// Editor previews have no enemy or subsystem
+	AEnemy* Enemy = MeshComp ? Cast<AEnemy>(MeshComp->GetOwner()) : nullptr;
+	UMeleeTraceSubsystem* MeleeTrace = Enemy ? Enemy->GetWorld()->GetSubsystem<UMeleeTraceSubsystem>() : nullptr;
+	if (MeleeTrace)
+	{
+		MeleeTrace->BeginSwing(Enemy, SocketName, Radius);
+	}
+}
+
+void UAnimNotifyState_MeleeTrace::NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
+	Super::NotifyEnd(MeshComp, Animation);
+
+	AEnemy* Enemy = MeshComp ? Cast<AEnemy>(MeshComp->GetOwner()) : nullptr;
+	UMeleeTraceSubsystem* MeleeTrace = Enemy ? Enemy->GetWorld()->GetSubsystem<UMeleeTraceSubsystem>() : nullptr;
+	if (MeleeTrace)
+	{
+		MeleeTrace->EndSwing(Enemy, SocketName);
+	}
+}
+
+FString UAnimNotifyState_MeleeTrace::GetNotifyName_Implementation() const
+{
+	return FString::Printf(TEXT("Melee Trace %s"), *SocketName.ToString());
+}
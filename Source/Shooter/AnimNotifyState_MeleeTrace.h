@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotifyState.h"
+#include "AnimNotifyState_MeleeTrace.generated.h"
+
+/**
+ * Sweeps an enemy weapon socket for hits while the notify is active.
+ */
+UCLASS(meta = (DisplayName = "Melee Trace"))
+class SHOOTER_API UAnimNotifyState_MeleeTrace : public UAnimNotifyState
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NotifyBegin(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation, float TotalDuration) override;
+	virtual void NotifyEnd(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
+	virtual FString GetNotifyName_Implementation() const override;
+
+private:
+	// Socket on the enemy mesh to sweep
+	UPROPERTY(EditAnywhere, Category = Melee, meta = (AllowPrivateAccess = "true"))
+	FName SocketName{TEXT("FX_Trail_L_01")};
+
+	// Radius of the swept sphere
+	UPROPERTY(EditAnywhere, Category = Melee, meta = (AllowPrivateAccess = "true"))
+	float Radius{20.f};
+};
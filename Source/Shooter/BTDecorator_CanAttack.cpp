@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTDecorator_CanAttack.h"
+
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+
+UBTDecorator_CanAttack::UBTDecorator_CanAttack()
+{
+	NodeName = TEXT("Can Attack");
+
+	BlackboardKey.SelectedKeyName = TEXT("bCanAttack");
+	BlackboardKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTDecorator_CanAttack, BlackboardKey));
+}
+
+bool UBTDecorator_CanAttack::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	return Blackboard && Blackboard->GetValue<UBlackboardKeyType_Bool>(BlackboardKey.GetSelectedKeyID());
+}
@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Decorators/BTDecorator_BlackboardBase.h"
+#include "BTDecorator_CanAttack.generated.h"
+
+/**
+ * Passes while the enemy's attack cooldown is over.
+ * Reads the bCanAttack key, and aborts like a blackboard decorator when it changes.
+ */
+UCLASS(meta = (DisplayName = "Can Attack"))
+class SHOOTER_API UBTDecorator_CanAttack : public UBTDecorator_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	UBTDecorator_CanAttack();
+
+protected:
+	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
+};
@@ -0,0 +1,22 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTDecorator_InAttackRange.h"
+
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+
+UBTDecorator_InAttackRange::UBTDecorator_InAttackRange()
+{
+	NodeName = TEXT("In Attack Range");
+
+	BlackboardKey.SelectedKeyName = TEXT("bInAttackRange");
+	BlackboardKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTDecorator_InAttackRange, BlackboardKey));
+}
+
+bool UBTDecorator_InAttackRange::CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const
+{
+	const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	return Blackboard && Blackboard->GetValue<UBlackboardKeyType_Bool>(BlackboardKey.GetSelectedKeyID());
+}
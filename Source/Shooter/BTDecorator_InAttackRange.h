@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Decorators/BTDecorator_BlackboardBase.h"
+#include "BTDecorator_InAttackRange.generated.h"
+
+/**
+ * Passes while a player is in the enemy's combat range.
+ * Reads the bInAttackRange key, and aborts like a blackboard decorator when it changes.
+ */
+UCLASS(meta = (DisplayName = "In Attack Range"))
+class SHOOTER_API UBTDecorator_InAttackRange : public UBTDecorator_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	UBTDecorator_InAttackRange();
+
+protected:
+	virtual bool CalculateRawConditionValue(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) const override;
+};
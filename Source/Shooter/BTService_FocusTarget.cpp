@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTService_FocusTarget.h"
+
+#include "AIController.h"
+#include "ShooterStats.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+
+DECLARE_CYCLE_STAT(TEXT("Focus Target Service"), STAT_FocusTargetService, STATGROUP_Shooter);
+
+UBTService_FocusTarget::UBTService_FocusTarget()
+{
+	NodeName = TEXT("Focus Target");
+
+	bNotifyBecomeRelevant = true;
+	bNotifyCeaseRelevant = true;
+	Interval = 0.5f;
+	RandomDeviation = 0.1f;
+
+	BlackboardKey.SelectedKeyName = TEXT("Target");
+	BlackboardKey.AddObjectFilter(this, GET_MEMBER_NAME_CHECKED(UBTService_FocusTarget, BlackboardKey), AActor::StaticClass());
+}
+
+void UBTService_FocusTarget::OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	Super::OnBecomeRelevant(OwnerComp, NodeMemory);
+	UpdateFocus(OwnerComp);
+}
+
+void UBTService_FocusTarget::OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	Super::OnCeaseRelevant(OwnerComp, NodeMemory);
+
+	AAIController* Controller = OwnerComp.GetAIOwner();
+	if (Controller)
+	{
+		Controller->ClearFocus(EAIFocusPriority::Gameplay);
+	}
+}
+
+void UBTService_FocusTarget::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_FocusTargetService, AI);
+	Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
+	UpdateFocus(OwnerComp);
+}
+
+void UBTService_FocusTarget::UpdateFocus(UBehaviorTreeComponent& OwnerComp) const
+{
+	AAIController* Controller = OwnerComp.GetAIOwner();
+	const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	if (!Controller || !Blackboard) return;
+
+	AActor* Target = Cast<AActor>(Blackboard->GetValue<UBlackboardKeyType_Object>(BlackboardKey.GetSelectedKeyID()));
+	if (Target)
+	{
+		if (Controller->GetFocusActorForPriority(EAIFocusPriority::Gameplay) != Target)
+		{
+			Controller->SetFocus(Target, EAIFocusPriority::Gameplay);
+		}
+	}
+	else
+	{
+		Controller->ClearFocus(EAIFocusPriority::Gameplay);
+	}
+}
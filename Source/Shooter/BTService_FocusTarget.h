@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Services/BTService_BlackboardBase.h"
+#include "BTService_FocusTarget.generated.h"
+
+/**
+ * Keeps the controller focused on the Target key while the branch is active.
+ */
+UCLASS(meta = (DisplayName = "Focus Target"))
+class SHOOTER_API UBTService_FocusTarget : public UBTService_BlackboardBase
+{
+	GENERATED_BODY()
+
+public:
+	UBTService_FocusTarget();
+
+protected:
+	virtual void OnBecomeRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnCeaseRelevant(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+
+private:
+	void UpdateFocus(UBehaviorTreeComponent& OwnerComp) const;
+};
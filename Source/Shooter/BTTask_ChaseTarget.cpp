@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTTask_ChaseTarget.h"
+
+UBTTask_ChaseTarget::UBTTask_ChaseTarget(const FObjectInitializer& ObjectInitializer) :
+Super(ObjectInitializer)
+{
+	NodeName = TEXT("Chase Target");
+
+	BlackboardKey.SelectedKeyName = TEXT("Target");
+
+	AcceptableRadius = 50.f;
+	bObserveBlackboardValue = true;
+}
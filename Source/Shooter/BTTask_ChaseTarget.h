@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/Tasks/BTTask_MoveTo.h"
+#include "BTTask_ChaseTarget.generated.h"
+
+/**
+ * Move To preset for chasing the Target key, following the target as it moves.
+ */
+UCLASS(meta = (DisplayName = "Chase Target"))
+class SHOOTER_API UBTTask_ChaseTarget : public UBTTask_MoveTo
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_ChaseTarget(const FObjectInitializer& ObjectInitializer);
+};
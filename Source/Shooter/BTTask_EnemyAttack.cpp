@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTTask_EnemyAttack.h"
+
+#include "AIController.h"
+#include "Enemy.h"
+#include "ShooterStats.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Attack Task"), STAT_EnemyAttackTask, STATGROUP_Shooter);
+
+UBTTask_EnemyAttack::UBTTask_EnemyAttack() :
+PlayRate(1.f)
+{
+	NodeName = TEXT("Enemy Attack");
+}
+
+EBTNodeResult::Type UBTTask_EnemyAttack::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemyAttackTask, AI);
+	const AAIController* Controller = OwnerComp.GetAIOwner();
+	AEnemy* Enemy = Controller ? Cast<AEnemy>(Controller->GetPawn()) : nullptr;
+	if (!Enemy) return EBTNodeResult::Failed;
+
+	Enemy->PlayAttackMontage(Enemy->GetAttackSectionName(), PlayRate);
+	return EBTNodeResult::Succeeded;
+}
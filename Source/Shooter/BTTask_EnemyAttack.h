@@ -0,0 +1,25 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_EnemyAttack.generated.h"
+
+/**
+ * Plays a random section of the enemy's attack montage.
+ */
+UCLASS(meta = (DisplayName = "Enemy Attack"))
+class SHOOTER_API UBTTask_EnemyAttack : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_EnemyAttack();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+
+private:
+	UPROPERTY(EditAnywhere, Category = Node, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float PlayRate;
+};
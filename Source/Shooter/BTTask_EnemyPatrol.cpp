@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTTask_EnemyPatrol.h"
+
+#include "AIController.h"
+#include "ShooterStats.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Patrol Task"), STAT_EnemyPatrolTask, STATGROUP_Shooter);
+
+UBTTask_EnemyPatrol::UBTTask_EnemyPatrol() :
+AcceptableRadius(50.f)
+{
+	NodeName = TEXT("Enemy Patrol");
+
+	PatrolPoint1Key.SelectedKeyName = TEXT("PatrolPoint1");
+	PatrolPoint1Key.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_EnemyPatrol, PatrolPoint1Key));
+	PatrolPoint2Key.SelectedKeyName = TEXT("PatrolPoint2");
+	PatrolPoint2Key.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_EnemyPatrol, PatrolPoint2Key));
+}
+
+EBTNodeResult::Type UBTTask_EnemyPatrol::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemyPatrolTask, AI);
+	FBTEnemyPatrolMemory* Memory = CastInstanceNodeMemory<FBTEnemyPatrolMemory>(NodeMemory);
+	AAIController* Controller = OwnerComp.GetAIOwner();
+	const UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	if (!Controller || !Blackboard) return EBTNodeResult::Failed;
+
+	const FBlackboardKeySelector& PointKey{Memory->bToSecondPoint ? PatrolPoint2Key : PatrolPoint1Key};
+	const FVector Destination{Blackboard->GetValue<UBlackboardKeyType_Vector>(PointKey.GetSelectedKeyID())};
+
+	FAIMoveRequest MoveRequest{Destination};
+	MoveRequest.SetAcceptanceRadius(AcceptableRadius);
+	const FPathFollowingRequestResult Result{Controller->MoveTo(MoveRequest)};
+
+	switch (Result.Code)
+	{
+	case EPathFollowingRequestResult::AlreadyAtGoal:
+		Memory->bToSecondPoint = !Memory->bToSecondPoint;
+		return EBTNodeResult::Succeeded;
+	case EPathFollowingRequestResult::RequestSuccessful:
+		WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, Result.MoveId);
+		return EBTNodeResult::InProgress;
+	default:
+		return EBTNodeResult::Failed;
+	}
+}
+
+EBTNodeResult::Type UBTTask_EnemyPatrol::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	AAIController* Controller = OwnerComp.GetAIOwner();
+	if (Controller)
+	{
+		Controller->StopMovement();
+	}
+	return EBTNodeResult::Aborted;
+}
+
+void UBTTask_EnemyPatrol::OnMessage(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, FName Message,
+	int32 RequestID, bool bSuccess)
+{
+	// Only move on to the other point once this one is reached
+	if (bSuccess && Message == UBrainComponent::AIMessage_MoveFinished)
+	{
+		FBTEnemyPatrolMemory* Memory = CastInstanceNodeMemory<FBTEnemyPatrolMemory>(NodeMemory);
+		Memory->bToSecondPoint = !Memory->bToSecondPoint;
+	}
+
+	Super::OnMessage(OwnerComp, NodeMemory, Message, RequestID, bSuccess);
+}
+
+void UBTTask_EnemyPatrol::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	UBlackboardData* BlackboardAsset = GetBlackboardAsset();
+	if (BlackboardAsset)
+	{
+		PatrolPoint1Key.ResolveSelectedKey(*BlackboardAsset);
+		PatrolPoint2Key.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+uint16 UBTTask_EnemyPatrol::GetInstanceMemorySize() const
+{
+	return sizeof(FBTEnemyPatrolMemory);
+}
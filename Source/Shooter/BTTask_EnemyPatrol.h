@@ -0,0 +1,41 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_EnemyPatrol.generated.h"
+
+struct FBTEnemyPatrolMemory
+{
+	// Heading to the second patrol point
+	bool bToSecondPoint;
+};
+
+/**
+ * Moves to the next patrol point, alternating between the two each time the task runs.
+ */
+UCLASS(meta = (DisplayName = "Enemy Patrol"))
+class SHOOTER_API UBTTask_EnemyPatrol : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_EnemyPatrol();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void OnMessage(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, FName Message, int32 RequestID, bool bSuccess) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+	virtual uint16 GetInstanceMemorySize() const override;
+
+private:
+	UPROPERTY(EditAnywhere, Category = Blackboard, meta = (AllowPrivateAccess = "true"))
+	FBlackboardKeySelector PatrolPoint1Key;
+
+	UPROPERTY(EditAnywhere, Category = Blackboard, meta = (AllowPrivateAccess = "true"))
+	FBlackboardKeySelector PatrolPoint2Key;
+
+	UPROPERTY(EditAnywhere, Category = Node, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float AcceptableRadius;
+};
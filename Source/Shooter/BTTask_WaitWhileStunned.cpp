@@ -0,0 +1,70 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BTTask_WaitWhileStunned.h"
+
+#include "BehaviorTree/BehaviorTree.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+
+UBTTask_WaitWhileStunned::UBTTask_WaitWhileStunned()
+{
+	NodeName = TEXT("Wait While Stunned");
+
+	StunnedKey.SelectedKeyName = TEXT("bStunned");
+	StunnedKey.AddBoolFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_WaitWhileStunned, StunnedKey));
+}
+
+EBTNodeResult::Type UBTTask_WaitWhileStunned::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	if (!Blackboard) return EBTNodeResult::Failed;
+
+	if (!Blackboard->GetValue<UBlackboardKeyType_Bool>(StunnedKey.GetSelectedKeyID()))
+	{
+		return EBTNodeResult::Succeeded;
+	}
+
+	Blackboard->RegisterObserver(StunnedKey.GetSelectedKeyID(), this,
+		FOnBlackboardChangeNotification::CreateUObject(this, &UBTTask_WaitWhileStunned::OnStunnedChanged));
+	return EBTNodeResult::InProgress;
+}
+
+EBTNodeResult::Type UBTTask_WaitWhileStunned::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	UBlackboardComponent* Blackboard = OwnerComp.GetBlackboardComponent();
+	if (Blackboard)
+	{
+		Blackboard->UnregisterObserversFrom(this);
+	}
+	return EBTNodeResult::Aborted;
+}
+
+void UBTTask_WaitWhileStunned::InitializeFromAsset(UBehaviorTree& Asset)
+{
+	Super::InitializeFromAsset(Asset);
+
+	UBlackboardData* BlackboardAsset = GetBlackboardAsset();
+	if (BlackboardAsset)
+	{
+		StunnedKey.ResolveSelectedKey(*BlackboardAsset);
+	}
+}
+
+EBlackboardNotificationResult UBTTask_WaitWhileStunned::OnStunnedChanged(const UBlackboardComponent& Blackboard,
+	FBlackboard::FKey ChangedKeyID)
+{
+	if (Blackboard.GetValue<UBlackboardKeyType_Bool>(ChangedKeyID))
+	{
+		return EBlackboardNotificationResult::ContinueObserving;
+	}
+
+	// Node instances are shared, so finish the task on the tree this blackboard belongs to
+	UBehaviorTreeComponent* OwnerComp = Cast<UBehaviorTreeComponent>(Blackboard.GetBrainComponent());
+	if (OwnerComp && OwnerComp->GetActiveNode() == this)
+	{
+		FinishLatentTask(*OwnerComp, EBTNodeResult::Succeeded);
+	}
+	return EBlackboardNotificationResult::RemoveObserver;
+}
@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BTTaskNode.h"
+#include "BTTask_WaitWhileStunned.generated.h"
+
+/**
+ * Finishes once the stunned key is cleared. Watches the blackboard instead of ticking.
+ */
+UCLASS(meta = (DisplayName = "Wait While Stunned"))
+class SHOOTER_API UBTTask_WaitWhileStunned : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_WaitWhileStunned();
+
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void InitializeFromAsset(UBehaviorTree& Asset) override;
+
+private:
+	EBlackboardNotificationResult OnStunnedChanged(const UBlackboardComponent& Blackboard, FBlackboard::FKey ChangedKeyID);
+
+	UPROPERTY(EditAnywhere, Category = Blackboard, meta = (AllowPrivateAccess = "true"))
+	FBlackboardKeySelector StunnedKey;
+};
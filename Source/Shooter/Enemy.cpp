@@ -5,17 +5,39 @@
 
 #include "DrawDebugHelpers.h"
 #include "EnemyController.h"
+#include "EnemyCorpseSubsystem.h"
+#include "EnemyProximitySubsystem.h"
+#include "EnemySignificanceSubsystem.h"
+#include "HitNumberLayer.h"
+#include "HitZoneSubsystem.h"
+#include "Item.h"
+#include "ItemPoolSubsystem.h"
+#include "LagCompensationSubsystem.h"
+#include "MeleeTraceSubsystem.h"
+#include "ParticlePoolSubsystem.h"
+#include "Shooter.h"
+#include "ShooterBehaviorTreeComponent.h"
 #include "ShooterCharacter.h"
+#include "ShooterEventLogSubsystem.h"
+#include "ShooterGameModeBase.h"
+#include "ShooterPlayerController.h"
+#include "ShooterRandomSubsystem.h"
+#include "ShooterStats.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Blueprint/UserWidget.h"
-#include "Components/BoxComponent.h"
+#include "BrainComponent.h"
 #include "Components/CapsuleComponent.h"
-#include "Components/SphereComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 #include "Kismet/KismetMathLibrary.h"
 
+DECLARE_CYCLE_STAT(TEXT("Enemy Bullet Hit"), STAT_EnemyBulletHit, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Enemy Take Damage"), STAT_EnemyTakeDamage, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Enemy Melee Hit"), STAT_EnemyMeleeHit, STATGROUP_Shooter);
+
 // Sets default values
 AEnemy::AEnemy():
 MaxHealth(100.f),
@@ -27,39 +49,35 @@ bCanHitReact(true),
 HitNumberDestroyTime(1.5f),
 PatrolPoint1(FVector(100.f, 0.f, 0.f)),
 PatrolPoint2(FVector(200.f, 0.f, 0.f)),
+AgroRadius(1000.f),
 bStunned(false),
 StunChance(0.5f),
 bInAttackRange(false),
+CombatRangeRadius(180.f),
 AttackLFast(TEXT("AttackLFast")),
 AttackRFast(TEXT("AttackRFast")),
 AttackL(TEXT("AttackL")),
 AttackR(TEXT("AttackR")),
+MeleeTraceRadius(20.f),
 BaseDamage(10.f),
 LeftWeaponSocket(TEXT("FX_Trail_L_01")),
 RightWeaponSocket(TEXT("FX_Trail_R_01")),
 bCanAttack(true),
 AttackWaitTime(1.f),
 bDying(false),
-DeathTime(30.f)
+DeathTime(30.f),
+bPooled(false),
+CombatMemoryTime(5.f),
+LastDamageTime(-BIG_NUMBER),
+LootDropChance(0.25f)
 {
- 	// Set this character to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = true;
-
-	// Create the AgroSphere
-	AgroSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AgroSphere"));
-	AgroSphere->SetupAttachment(GetRootComponent());
-	AgroSphere->SetSphereRadius(1000.f);
-
-	// Create the CombatRangeSphere
-	CombatRangeSphere = CreateDefaultSubobject<USphereComponent>(TEXT("CombatRangeSphere"));
-	CombatRangeSphere->SetupAttachment(GetRootComponent());
-	CombatRangeSphere->SetSphereRadius(180.f);
+ 	// Hit numbers are drawn by the player controller's hit number layer, nothing left to tick
+	PrimaryActorTick.bCanEverTick = false;
 
-	// Construct weapon collision boxes
-	LeftWeaponCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("LeftWeaponBox"));
-	LeftWeaponCollision->SetupAttachment(GetMesh(), FName("LeftWeaponBone"));
-	RightWeaponCollision = CreateDefaultSubobject<UBoxComponent>(TEXT("RightWeaponBox"));
-	RightWeaponCollision->SetupAttachment(GetMesh(), FName("RightWeaponBone"));
+	// Head shots do double damage by default
+	HitZones.Add(EHitZone::EHZ_Head).DamageMultiplier = 2.f;
+	HitZones.Add(EHitZone::EHZ_Torso).DamageMultiplier = 1.f;
+	HitZones.Add(EHitZone::EHZ_Limb).DamageMultiplier = 1.f;
 }
 
 // Called when the game starts or when spawned
@@ -72,41 +90,106 @@ void AEnemy::BeginPlay()
 	GetMesh()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECC_Camera, ECR_Ignore);
 
-	// Bind functions to overlap events
-	AgroSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::AgroSphereOverlap);
-	AgroSphere->OnComponentEndOverlap.AddDynamic(this, &AEnemy::AgroSphereEndOverlap);
-	CombatRangeSphere->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::CombatRangeSphereOverlap);
-	CombatRangeSphere->OnComponentEndOverlap.AddDynamic(this, &AEnemy::CombatRangeSphereEndOverlap);
-	LeftWeaponCollision->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::OnLeftWeaponOverlap);
-	RightWeaponCollision->OnComponentBeginOverlap.AddDynamic(this, &AEnemy::OnRightWeaponOverlap);
-	
-	// Set collision presets for weapon collision
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	LeftWeaponCollision->SetCollisionObjectType(ECC_WorldDynamic);
-	LeftWeaponCollision->SetCollisionResponseToAllChannels(ECR_Ignore);
-	LeftWeaponCollision->SetCollisionResponseToChannel(ECC_Pawn,ECR_Overlap);
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	RightWeaponCollision->SetCollisionObjectType(ECC_WorldDynamic);
-	RightWeaponCollision->SetCollisionResponseToAllChannels(ECR_Ignore);
-	RightWeaponCollision->SetCollisionResponseToChannel(ECC_Pawn,ECR_Overlap);
+	// Build (or reuse) the hit zone table for our mesh
+	TMap<EHitZone, FHitZoneSettings> ZoneSettings{HitZones};
+	if (!HeadBone.IsEmpty())
+	{
+		ZoneSettings.FindOrAdd(EHitZone::EHZ_Head).Bones.AddUnique(FName(*HeadBone));
+	}
+	UHitZoneSubsystem* HitZoneSubsystem = GetWorld()->GetSubsystem<UHitZoneSubsystem>();
+	HitZoneTable = HitZoneSubsystem ? HitZoneSubsystem->FindOrBuildTable(GetMesh()->SkeletalMesh, ZoneSettings) :
+		FHitZoneTable::Build(GetMesh()->SkeletalMesh, ZoneSettings);
 
-	// Get the AIController
-	EnemyController = Cast<AEnemyController>(GetController());
+	UParticlePoolSubsystem* ParticlePool = GetWorld()->GetSubsystem<UParticlePoolSubsystem>();
+	if (ParticlePool)
+	{
+		ParticlePool->PrewarmPool(ImpactParticles);
+	}
 
-	if (EnemyController)
+	StartAI();
+	RegisterWithSubsystems();
+
+	if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("bCanAttack"), true);
+		EventLog->RecordEvent(this, TEXT("Spawn"), GetActorLocation().ToString());
 	}
+}
+
+void AEnemy::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UMeleeTraceSubsystem* MeleeTrace = GetWorld()->GetSubsystem<UMeleeTraceSubsystem>();
+	if (MeleeTrace)
+	{
+		MeleeTrace->EndAllSwings(this);
+	}
+
+	UEnemyCorpseSubsystem* Corpses = GetWorld()->GetSubsystem<UEnemyCorpseSubsystem>();
+	if (Corpses)
+	{
+		Corpses->RemoveCorpse(this);
+	}
+
+	UnregisterFromSubsystems();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AEnemy::StartAI()
+{
+	// Get the AIController
+	EnemyController = Cast<AEnemyController>(GetController());
+	if (!EnemyController) return;
+
+	EnemyController->SetCanAttack(true);
 
 	const FVector WorldPatrolPoint1 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint1);
 	const FVector WorldPatrolPoint2 = UKismetMathLibrary::TransformLocation(GetActorTransform(), PatrolPoint2);
+	EnemyController->SetPatrolPoints(WorldPatrolPoint1, WorldPatrolPoint2);
 
-	if (EnemyController)
+	// The tree should start with these values already set
+	EnemyController->FlushBlackboardWrites();
+	EnemyController->RunBehaviorTree(BehaviorTree);
+}
+
+void AEnemy::RegisterWithSubsystems()
+{
+	UEnemyProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UEnemyProximitySubsystem>();
+	if (Proximity)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(FName("PatrolPoint1"), WorldPatrolPoint1);
-		EnemyController->GetBlackboardComponent()->SetValueAsVector(FName("PatrolPoint2"), WorldPatrolPoint2);
+		Proximity->RegisterEnemy(this);
+	}
 
-		EnemyController->RunBehaviorTree(BehaviorTree);
+	UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+	if (Significance)
+	{
+		Significance->RegisterEnemy(this);
+	}
+
+	ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+	if (LagCompensation)
+	{
+		LagCompensation->RegisterCharacter(this);
+	}
+}
+
+void AEnemy::UnregisterFromSubsystems()
+{
+	UEnemyProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UEnemyProximitySubsystem>();
+	if (Proximity)
+	{
+		Proximity->UnregisterEnemy(this);
+	}
+
+	UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+	if (Significance)
+	{
+		Significance->UnregisterEnemy(this);
+	}
+
+	ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+	if (LagCompensation)
+	{
+		LagCompensation->UnregisterCharacter(this);
 	}
 }
 
@@ -120,8 +203,19 @@ void AEnemy::Die()
 {
 	if (bDying) return;
 	bDying = true;
+
+	if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
+	{
+		EventLog->RecordEvent(this, TEXT("Die"));
+	}
 	
 	HideHealthBar();
+
+	UMeleeTraceSubsystem* MeleeTrace = GetWorld()->GetSubsystem<UMeleeTraceSubsystem>();
+	if (MeleeTrace)
+	{
+		MeleeTrace->EndAllSwings(this);
+	}
 	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
 	if (AnimInstance && DeathMontage)
 	{
@@ -130,9 +224,33 @@ void AEnemy::Die()
 	
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("bDead"), true);
+		EnemyController->SetDead(true);
 		EnemyController->StopMovement();
 	}
+
+	DropLoot();
+
+	AShooterGameModeBase* GameMode = GetWorld()->GetAuthGameMode<AShooterGameModeBase>();
+	if (bPooled && GameMode)
+	{
+		GameMode->EnemyKilled(this);
+	}
+}
+
+void AEnemy::DropLoot()
+{
+	if (!LootClass) return;
+
+	const float Roll{UShooterRandomSubsystem::GetStream(this, EShooterRandomStream::Loot).FRand()};
+	if (Roll >= LootDropChance) return;
+
+	const FVector Feet{GetActorLocation() - FVector(0.f, 0.f, GetCapsuleComponent()->GetScaledCapsuleHalfHeight())};
+	UItemPoolSubsystem::AcquireOrSpawn(this, LootClass, FTransform(GetActorRotation(), Feet));
+
+	if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
+	{
+		EventLog->RecordEvent(this, TEXT("DropLoot"), LootClass->GetName());
+	}
 }
 
 void AEnemy::PlayHitMontage(FName Section, float PlayRate)
@@ -146,7 +264,8 @@ void AEnemy::PlayHitMontage(FName Section, float PlayRate)
 			AnimInstance->Montage_JumpToSection(Section, HitMontage);
 		}
 		bCanHitReact = false;
-		const float HitReactTime{FMath::FRandRange(HitReactTimeMin, HitReactTimeMax)};
+		FRandomStream& CombatStream = UShooterRandomSubsystem::GetStream(this, EShooterRandomStream::Combat);
+		const float HitReactTime{CombatStream.FRandRange(HitReactTimeMin, HitReactTimeMax)};
 		GetWorldTimerManager().SetTimer(HitReactTimer, this, &AEnemy::ResetHitReactTimer, HitReactTime);
 	}
 }
@@ -158,87 +277,76 @@ void AEnemy::ResetHitReactTimer()
 
 void AEnemy::StoreHitNumber(UUserWidget* HitNumber, FVector Location)
 {
-	HitNumbers.Add(HitNumber, Location);
-
-	FTimerHandle HitNumberTimer;
-	FTimerDelegate HitNumberDelegate;
-	HitNumberDelegate.BindUFunction(this, FName("DestroyHitNumber"), HitNumber);
-	GetWorld()->GetTimerManager().SetTimer(HitNumberTimer, HitNumberDelegate, HitNumberDestroyTime, false);
+	UHitNumberLayer* HitNumberLayer = GetHitNumberLayer();
+	if (HitNumberLayer)
+	{
+		HitNumberLayer->AddHitNumberWidget(HitNumber, Location, HitNumberDestroyTime);
+	}
+	else if (HitNumber)
+	{
+		HitNumber->RemoveFromParent();
+	}
 }
 
 void AEnemy::DestroyHitNumber(UUserWidget* HitNumber)
 {
-	HitNumbers.Remove(HitNumber);
-	HitNumber->RemoveFromParent();
-}
-
-void AEnemy::UpdateHitNumbers()
-{
-	for (auto& HitPair : HitNumbers)
+	UHitNumberLayer* HitNumberLayer = GetHitNumberLayer();
+	if (HitNumberLayer)
 	{
-		UUserWidget* HitNumber{HitPair.Key};
-		const FVector Location{HitPair.Value};
-		FVector2D ScreenPosition;
-		UGameplayStatics::ProjectWorldToScreen(GetWorld()->GetFirstPlayerController(), Location, ScreenPosition);
-		HitNumber->SetPositionInViewport(ScreenPosition);
+		HitNumberLayer->RemoveHitNumberWidget(HitNumber);
+	}
+	else if (HitNumber)
+	{
+		HitNumber->RemoveFromParent();
 	}
 }
 
-void AEnemy::AgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+UHitNumberLayer* AEnemy::GetHitNumberLayer() const
 {
-	if (!OtherActor) return;
-	auto Character = Cast<AShooterCharacter>(OtherActor);
-	if (Character && EnemyController)
-	{
-		// Assign Character to the Target blackboard key
-		EnemyController->GetBlackboardComponent()->SetValueAsObject(FName("Target"), Character);
-	}
+	const AShooterPlayerController* ShooterController = Cast<AShooterPlayerController>(GetWorld()->GetFirstPlayerController());
+	return ShooterController ? ShooterController->GetHitNumberLayer() : nullptr;
 }
 
-void AEnemy::AgroSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+void AEnemy::ShowHitNumber_Implementation(int32 Damage, FVector Hitlocation, bool bHeadShot)
 {
-	if (!OtherActor) return;
-	auto Character = Cast<AShooterCharacter>(OtherActor);
-	if (Character && EnemyController)
+	if (!ShouldPlayCosmetics(this)) return;
+
+	UHitNumberLayer* HitNumberLayer = GetHitNumberLayer();
+	if (HitNumberLayer)
 	{
-		// Clear the Target blackboard key
-		//EnemyController->GetBlackboardComponent()->ClearValue(FName("Target"));
+		HitNumberLayer->AddHitNumber(Damage, Hitlocation, bHeadShot, HitNumberDestroyTime);
 	}
 }
 
 void AEnemy::SetStunned(bool Stunned)
 {
+	if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
+	{
+		EventLog->RecordEvent(this, Stunned ? TEXT("Stunned") : TEXT("Recovered"));
+	}
+
 	bStunned = Stunned;
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("bStunned"), Stunned);
+		EnemyController->SetStunned(Stunned);
 	}
 }
 
-void AEnemy::CombatRangeSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AEnemy::AgroTargetEntered(AShooterCharacter* Character)
 {
-	if (!OtherActor) return;
-	auto Character = Cast<AShooterCharacter>(OtherActor);
 	if (Character && EnemyController)
 	{
-		bInAttackRange = true;
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("bInAttackRange"), true);
+		// Assign Character to the Target blackboard key
+		EnemyController->SetTarget(Character);
 	}
 }
 
-void AEnemy::CombatRangeSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+void AEnemy::SetInCombatRange(bool bInRange)
 {
-	if (!OtherActor) return;
-	auto Character = Cast<AShooterCharacter>(OtherActor);
-	if (Character && EnemyController)
-	{
-		bInAttackRange = false;
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("bInAttackRange"), false);
-	}
+	if (!EnemyController) return;
+
+	bInAttackRange = bInRange;
+	EnemyController->SetInAttackRange(bInRange);
 }
 
 void AEnemy::PlayAttackMontage(FName Section, float PlayRate)
@@ -253,14 +361,14 @@ void AEnemy::PlayAttackMontage(FName Section, float PlayRate)
 	GetWorldTimerManager().SetTimer(AttackWaitTimer, this, &AEnemy::ResetCanAttack, AttackWaitTime);
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("bCanAttack"), false);
+		EnemyController->SetCanAttack(false);
 	}
 }
 
 FName AEnemy::GetAttackSectionName()
 {
 	FName SectionName;
-	const int32 Section{FMath::RandRange(1,4)};
+	const int32 Section{UShooterRandomSubsystem::GetStream(this, EShooterRandomStream::AI).RandRange(1, 4)};
 	switch (Section)
 	{
 	case 1:
@@ -276,51 +384,59 @@ FName AEnemy::GetAttackSectionName()
 		SectionName = AttackR;
 		break;
 	}
-	return SectionName;
-}
 
-void AEnemy::OnLeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-	auto ShooterCharacter = Cast<AShooterCharacter>(OtherActor);
-	if (ShooterCharacter)
+	if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
 	{
-		DoDamage(ShooterCharacter);
-		SpawnBlood(ShooterCharacter, LeftWeaponSocket);
-		StunCharacter(ShooterCharacter);
+		EventLog->RecordEvent(this, TEXT("AttackSection"), SectionName.ToString());
 	}
+	return SectionName;
 }
 
-void AEnemy::OnRightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
-	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void AEnemy::MeleeHit(AShooterCharacter* ShooterCharacter, FName WeaponSocket)
 {
-	auto ShooterCharacter = Cast<AShooterCharacter>(OtherActor);
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemyMeleeHit, Enemies);
 	if (ShooterCharacter)
 	{
 		DoDamage(ShooterCharacter);
-		SpawnBlood(ShooterCharacter, RightWeaponSocket);
+		SpawnBlood(ShooterCharacter, WeaponSocket);
 		StunCharacter(ShooterCharacter);
 	}
 }
 
 void AEnemy::ActivateLeftWeapon()
 {
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	UMeleeTraceSubsystem* MeleeTrace = GetWorld()->GetSubsystem<UMeleeTraceSubsystem>();
+	if (MeleeTrace)
+	{
+		MeleeTrace->BeginSwing(this, LeftWeaponSocket, MeleeTraceRadius);
+	}
 }
 
 void AEnemy::DeactivateLeftWeapon()
 {
-	LeftWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	UMeleeTraceSubsystem* MeleeTrace = GetWorld()->GetSubsystem<UMeleeTraceSubsystem>();
+	if (MeleeTrace)
+	{
+		MeleeTrace->EndSwing(this, LeftWeaponSocket);
+	}
 }
 
 void AEnemy::ActivateRightWeapon()
 {
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+	UMeleeTraceSubsystem* MeleeTrace = GetWorld()->GetSubsystem<UMeleeTraceSubsystem>();
+	if (MeleeTrace)
+	{
+		MeleeTrace->BeginSwing(this, RightWeaponSocket, MeleeTraceRadius);
+	}
 }
 
 void AEnemy::DeactivateRightWeapon()
 {
-	RightWeaponCollision->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	UMeleeTraceSubsystem* MeleeTrace = GetWorld()->GetSubsystem<UMeleeTraceSubsystem>();
+	if (MeleeTrace)
+	{
+		MeleeTrace->EndSwing(this, RightWeaponSocket);
+	}
 }
 
 void AEnemy::DoDamage(AShooterCharacter* ShooterCharacter)
@@ -328,7 +444,7 @@ void AEnemy::DoDamage(AShooterCharacter* ShooterCharacter)
 	if (ShooterCharacter && EnemyController)
 	{
 		UGameplayStatics::ApplyDamage(ShooterCharacter, BaseDamage, EnemyController, this, UDamageType::StaticClass());
-		if (ShooterCharacter->GetMeleeImpactSound())
+		if (ShooterCharacter->GetMeleeImpactSound() && ShouldPlayCosmetics(this))
 		{
 			UGameplayStatics::PlaySoundAtLocation(this, ShooterCharacter->GetMeleeImpactSound(), GetActorLocation());
 		}
@@ -343,7 +459,7 @@ void AEnemy::SpawnBlood(AShooterCharacter* ShooterCharacter, FName WeaponSocket)
 		const FTransform SocketTransform{TipSocket->GetSocketTransform(GetMesh())};
 		if (ShooterCharacter->GetBloodParticles())
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ShooterCharacter->GetBloodParticles(),
+			UParticlePoolSubsystem::SpawnEmitter(this, ShooterCharacter->GetBloodParticles(),
 				SocketTransform);
 		}
 	}
@@ -353,9 +469,13 @@ void AEnemy::StunCharacter(AShooterCharacter* ShooterCharacter)
 {
 	if (ShooterCharacter)
 	{
-		const float Stun{FMath::FRandRange(0.f, 1.f)};
+		const float Stun{UShooterRandomSubsystem::GetStream(this, EShooterRandomStream::Combat).FRand()};
 		if (Stun <= ShooterCharacter->GetStunChance())
 		{
+			if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
+			{
+				EventLog->RecordEvent(ShooterCharacter, TEXT("Stunned"), FString::Printf(TEXT("by %s"), *GetClass()->GetName()));
+			}
 			ShooterCharacter->Stun();
 		}
 	}
@@ -366,29 +486,149 @@ void AEnemy::ResetCanAttack()
 	bCanAttack = true;
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("bCanAttack"), true);
+		EnemyController->SetCanAttack(true);
 	}
 }
 
 void AEnemy::FinishDeath()
 {
-	GetMesh()->bPauseAnims = true;
+	FreezeCorpse();
 
 	GetWorldTimerManager().SetTimer(DeathTimer, this, &AEnemy::DestroyEnemy, DeathTime);
+
+	UEnemyCorpseSubsystem* Corpses = GetWorld()->GetSubsystem<UEnemyCorpseSubsystem>();
+	if (Corpses)
+	{
+		Corpses->AddCorpse(this);
+	}
+}
+
+void AEnemy::FreezeCorpse()
+{
+	// Keep the last pose without evaluating or ticking the mesh again
+	USkeletalMeshComponent* EnemyMesh = GetMesh();
+	EnemyMesh->bPauseAnims = true;
+	EnemyMesh->bNoSkeletonUpdate = true;
+	EnemyMesh->SetComponentTickEnabled(false);
+	EnemyMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	GetCharacterMovement()->SetComponentTickEnabled(false);
+
+	if (EnemyController && EnemyController->GetBrainComponent())
+	{
+		EnemyController->GetBrainComponent()->StopLogic(TEXT("Dead"));
+	}
+
+	UnregisterFromSubsystems();
+}
+
+void AEnemy::FadeOutCorpse(float FadeTime)
+{
+	OnCorpseFadeOut(FadeTime);
+
+	if (FadeTime > 0.f)
+	{
+		GetWorldTimerManager().SetTimer(DeathTimer, this, &AEnemy::DestroyEnemy, FadeTime);
+	}
+	else
+	{
+		DestroyEnemy();
+	}
 }
 
 void AEnemy::DestroyEnemy()
 {
-	Destroy();
+	AShooterGameModeBase* GameMode = GetWorld()->GetAuthGameMode<AShooterGameModeBase>();
+	if (bPooled && GameMode)
+	{
+		GameMode->ReleaseEnemy(this);
+	}
+	else
+	{
+		Destroy();
+	}
 }
 
-// Called every frame
-void AEnemy::Tick(float DeltaTime)
+void AEnemy::ResetForPool()
 {
-	Super::Tick(DeltaTime);
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	HideHealthBar();
 
-	UpdateHitNumbers();
+	UMeleeTraceSubsystem* MeleeTrace = GetWorld()->GetSubsystem<UMeleeTraceSubsystem>();
+	if (MeleeTrace)
+	{
+		MeleeTrace->EndAllSwings(this);
+	}
 
+	UEnemyCorpseSubsystem* Corpses = GetWorld()->GetSubsystem<UEnemyCorpseSubsystem>();
+	if (Corpses)
+	{
+		Corpses->RemoveCorpse(this);
+	}
+
+	// A dormant enemy is a hidden corpse with its controller still attached
+	EnemyController = Cast<AEnemyController>(GetController());
+	FreezeCorpse();
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	if (EnemyController)
+	{
+		EnemyController->SetActorTickEnabled(false);
+	}
+}
+
+void AEnemy::ActivateFromPool(const FTransform& Transform)
+{
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	// Undo FreezeCorpse, collision goes back to the class defaults
+	const AEnemy* DefaultEnemy = GetClass()->GetDefaultObject<AEnemy>();
+	USkeletalMeshComponent* EnemyMesh = GetMesh();
+	EnemyMesh->bPauseAnims = false;
+	EnemyMesh->bNoSkeletonUpdate = false;
+	EnemyMesh->SetComponentTickEnabled(true);
+	EnemyMesh->SetCollisionEnabled(DefaultEnemy->GetMesh()->GetCollisionEnabled());
+	GetCapsuleComponent()->SetCollisionEnabled(DefaultEnemy->GetCapsuleComponent()->GetCollisionEnabled());
+	UAnimInstance* AnimInstance = EnemyMesh->GetAnimInstance();
+	if (AnimInstance)
+	{
+		AnimInstance->StopAllMontages(0.f);
+	}
+
+	GetCharacterMovement()->SetComponentTickEnabled(true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	Health = MaxHealth;
+	bDying = false;
+	bStunned = false;
+	bCanAttack = true;
+	bInAttackRange = false;
+	bCanHitReact = true;
+	LastDamageTime = -BIG_NUMBER;
+
+	// Clear what the last life left on the blackboard
+	EnemyController = Cast<AEnemyController>(GetController());
+	if (EnemyController)
+	{
+		EnemyController->SetActorTickEnabled(true);
+		EnemyController->SetTarget(nullptr);
+		EnemyController->SetStunned(false);
+		EnemyController->SetInAttackRange(false);
+		EnemyController->SetDead(false);
+	}
+
+	StartAI();
+	RegisterWithSubsystems();
+
+	if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
+	{
+		EventLog->RecordEvent(this, TEXT("Spawn"), GetActorLocation().ToString());
+	}
 }
 
 // Called to bind functionality to input
@@ -400,35 +640,85 @@ void AEnemy::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
 
 void AEnemy::BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* ShooterController)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemyBulletHit, Enemies);
 	IBulletHitInterface::BulletHit_Implementation(HitResult, Shooter, ShooterController);
 
-	if (ImpactSound)
+	PlayBulletImpact(HitResult.Location);
+}
+
+void AEnemy::PlayBulletImpact(const FVector& HitLocation)
+{
+	if (ImpactSound && ShouldPlayCosmetics(this))
 	{
 		UGameplayStatics::PlaySoundAtLocation(this, ImpactSound, GetActorLocation());
 	}
 	if (ImpactParticles)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, HitResult.Location, FRotator(0.f), true);
+		UParticlePoolSubsystem::SpawnEmitter(this, ImpactParticles, HitLocation);
+	}
+}
+
+EHitZone AEnemy::GetHitZone(FName BoneName) const
+{
+	if (!HitZoneTable.IsValid()) return EHitZone::EHZ_Torso;
+	return HitZoneTable->GetZone(GetMesh()->GetBoneIndex(BoneName));
+}
+
+float AEnemy::GetHitZoneDamageMultiplier(EHitZone Zone) const
+{
+	if (!HitZoneTable.IsValid()) return 1.f;
+	return HitZoneTable->GetDamageMultiplier(Zone);
+}
+
+bool AEnemy::IsInCombat() const
+{
+	return bInAttackRange || bStunned || bDying || !bCanAttack ||
+		GetWorld()->TimeSince(LastDamageTime) < CombatMemoryTime;
+}
+
+void AEnemy::ApplySignificanceTier(const FEnemySignificanceTier& Tier)
+{
+	GetCharacterMovement()->SetComponentTickInterval(Tier.MovementTickInterval);
+
+	USkeletalMeshComponent* EnemyMesh = GetMesh();
+	EnemyMesh->SetComponentTickInterval(Tier.MeshTickInterval);
+	EnemyMesh->bEnableUpdateRateOptimizations = Tier.MeshTickInterval > 0.f;
+	EnemyMesh->VisibilityBasedAnimTickOption = Tier.bOnlyTickPoseWhenRendered ?
+		EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered :
+		EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+	if (EnemyController && EnemyController->GetBehaviorTreeComponent())
+	{
+		EnemyController->GetBehaviorTreeComponent()->SetThrottleInterval(Tier.BehaviorTreeTickInterval);
+	}
+
+	UEnemyProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UEnemyProximitySubsystem>();
+	if (Proximity)
+	{
+		Proximity->SetEnemyEnabled(this, Tier.bUpdateProximity);
 	}
 }
 
 float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator,
                          AActor* DamageCauser)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemyTakeDamage, Enemies);
+	LastDamageTime = GetWorld()->GetTimeSeconds();
+
 	// Set the Target blackboard key to agro the enemy
 	if (EnemyController)
 	{
-		EnemyController->GetBlackboardComponent()->SetValueAsObject(FName("Target"), DamageCauser);
+		EnemyController->SetTarget(DamageCauser);
 	}
 	
-	if (Health - DamageAmount <= 0.f)
+	Health = FMath::Max(Health - DamageAmount, 0.f);
+	if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
 	{
-		Health = 0.f;
-		Die();
+		EventLog->RecordEvent(this, TEXT("Damage"), FString::Printf(TEXT("%.2f health %.2f"), DamageAmount, Health));
 	}
-	else
+	if (Health <= 0.f)
 	{
-		Health -= DamageAmount;
+		Die();
 	}
 
 	if (bDying) return DamageAmount;
@@ -436,7 +726,7 @@ float AEnemy::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AC
 	ShowHealthBar();
 	
 	// Determine whether BulletHit stuns
-	const float Stunned = FMath::FRandRange(0.f, 1.f);
+	const float Stunned = UShooterRandomSubsystem::GetStream(this, EShooterRandomStream::Combat).FRand();
 	if (Stunned <= StunChance)
 	{
 		// Stun the enemy
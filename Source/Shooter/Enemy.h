@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "BulletHitInterface.h"
+#include "HitZone.h"
 #include "GameFramework/Character.h"
 #include "Enemy.generated.h"
 
@@ -20,6 +21,14 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Sets up the blackboard for the current location and starts the behavior tree
+	void StartAI();
+
+	void RegisterWithSubsystems();
+	void UnregisterFromSubsystems();
+
 	UFUNCTION(BlueprintNativeEvent)
 	void ShowHealthBar();
 	void ShowHealthBar_Implementation();
@@ -29,58 +38,27 @@ protected:
 	
 	void Die();
 
+	// Rolls for LootClass and drops it at the enemy's feet
+	void DropLoot();
+
 	void PlayHitMontage(FName Section, float PlayRate = 1.0);
 
 	void ResetHitReactTimer();
 
+	// Hands a hit number widget created in blueprint to the controller's hit number layer
 	UFUNCTION(BlueprintCallable)
 	void StoreHitNumber(UUserWidget* HitNumber, FVector Location);
 
 	UFUNCTION()
 	void DestroyHitNumber(UUserWidget* HitNumber);
 
-	void UpdateHitNumbers();
-
-	// Called when overlapping AgroSphere
-	UFUNCTION()
-	void AgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	// Called when overlapping with AgroSphere ended
-	UFUNCTION()
-	void AgroSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex);
+	// Hit number layer of the local player controller
+	class UHitNumberLayer* GetHitNumberLayer() const;
 
 	UFUNCTION(BlueprintCallable)
 	void SetStunned(bool Stunned);
 
-	// Called when overlapping CombatRangeSphere
-	UFUNCTION()
-	void CombatRangeSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	// Called when overlapping with CombatRangeSphere ended
-	UFUNCTION()
-	void CombatRangeSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex);
-
-	UFUNCTION(BlueprintCallable)
-	void PlayAttackMontage(FName Section, float PlayRate = 1.0);
-
-	UFUNCTION(BlueprintPure)
-	FName GetAttackSectionName();
-
-	// Called when left weapon collides with the character
-	UFUNCTION()
-	void OnLeftWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	// Called when right weapon collides with the character
-	UFUNCTION()
-	void OnRightWeaponOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
-		int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-	// Activate/Deactivate collision for weapons
+	// Start/stop sweeping the weapon sockets, for montages that don't use the Melee Trace notify state
 	UFUNCTION(BlueprintCallable)
 	void ActivateLeftWeapon();
 	UFUNCTION(BlueprintCallable)
@@ -102,6 +80,13 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void FinishDeath();
 
+	// Stops everything on the corpse from updating, the pose stays as it is
+	void FreezeCorpse();
+
+	// Lets the blueprint play a fade or dissolve before the corpse is destroyed
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnCorpseFadeOut(float FadeTime);
+
     UFUNCTION()
 	void DestroyEnemy();
 	
@@ -122,10 +107,17 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float Health;
 
-	// Name of the head bone
+	// Name of the head bone, added to the head hit zone
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	FString HeadBone;
 
+	// Bones and damage multiplier for each hit zone. Bones not listed use their parent's zone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	TMap<EHitZone, FHitZoneSettings> HitZones;
+
+	// Bone index to hit zone lookup, shared by all enemies with the same mesh
+	TSharedPtr<const FHitZoneTable> HitZoneTable;
+
 	//Time to display HealthBar once shot
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float HealthBarDisplayTime;
@@ -146,10 +138,6 @@ private:
 
 	bool bCanHitReact;
 
-	// Map to store hit number widgets and their hit locations
-	UPROPERTY(VisibleAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	TMap<UUserWidget*, FVector> HitNumbers;
-
 	// Time before a hit number removed from the screen
 	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float HitNumberDestroyTime;
@@ -166,9 +154,9 @@ private:
 
 	class AEnemyController* EnemyController;
 
-	// Overlap sphere for when the enemy become hostile
+	// Distance from the player at which the enemy becomes hostile
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	class USphereComponent* AgroSphere;
+	float AgroRadius;
 
 	// True when playing the GetHit animation
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -182,9 +170,9 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	bool bInAttackRange;
 
-	// Overlap sphere for when the enemy can attack
+	// Distance from the player at which the enemy can attack
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	USphereComponent* CombatRangeSphere;
+	float CombatRangeRadius;
 
 	// Montage containing attack animations
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -196,11 +184,9 @@ private:
 	FName AttackL;
 	FName AttackR;
 
-	// Collision volumes for the weapons
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	class UBoxComponent* LeftWeaponCollision;
-	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
-	UBoxComponent* RightWeaponCollision;
+	// Radius swept along the weapon sockets by ActivateLeftWeapon and ActivateRightWeapon
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float MeleeTraceRadius;
 
 	// Base damage for enemy
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
@@ -233,23 +219,90 @@ private:
 	// Time after death until Destroy()
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Combat, meta = (AllowPrivateAccess = "true"))
 	float DeathTime;
+
+	// Owned by the game mode's enemy pool, which gets it back instead of it being destroyed
+	bool bPooled;
+
+	// Time after taking damage that the enemy still counts as in combat for significance
+	UPROPERTY(EditAnywhere, Category = Combat, meta = (AllowPrivateAccess = "true"))
+	float CombatMemoryTime;
+
+	// World time the enemy last took damage
+	float LastDamageTime;
+
+	// Item dropped through the item pool when the enemy dies
+	UPROPERTY(EditAnywhere, Category = Loot, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class AItem> LootClass;
+
+	// Chance of dropping LootClass
+	UPROPERTY(EditAnywhere, Category = Loot, meta = (AllowPrivateAccess = "true", ClampMin = "0", ClampMax = "1"))
+	float LootDropChance;
 	
 public:	
-	// Called every frame
-	virtual void Tick(float DeltaTime) override;
-
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
 	virtual void BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* ShooterController) override;
 
+	// Impact sound and particles only. Shooting clients play them before the server confirms the hit
+	void PlayBulletImpact(const FVector& HitLocation);
+
 	// Take combat damage
 	virtual float TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator, AActor* DamageCauser) override;
 
 	FORCEINLINE FString GetHeadBone() const { return HeadBone; }
 
-	UFUNCTION(BlueprintImplementableEvent)
+	// Hit zone for a bone hit by a trace
+	EHitZone GetHitZone(FName BoneName) const;
+
+	float GetHitZoneDamageMultiplier(EHitZone Zone) const;
+
+	// Shows the number with a pooled widget from the hit number layer. Blueprints can still override it
+	UFUNCTION(BlueprintNativeEvent)
 	void ShowHitNumber(int32 Damage, FVector Hitlocation, bool bHeadShot);
+	void ShowHitNumber_Implementation(int32 Damage, FVector Hitlocation, bool bHeadShot);
 
 	FORCEINLINE UBehaviorTree* GetBehaviorTree() const { return BehaviorTree; }
+
+	// Only takes effect before BeginPlay, which starts the tree
+	FORCEINLINE void SetBehaviorTree(UBehaviorTree* Tree) { BehaviorTree = Tree; }
+
+	UFUNCTION(BlueprintCallable)
+	void PlayAttackMontage(FName Section, float PlayRate = 1.0);
+
+	UFUNCTION(BlueprintPure)
+	FName GetAttackSectionName();
+
+	FORCEINLINE float GetAgroRadius() const { return AgroRadius; }
+	FORCEINLINE float GetCombatRangeRadius() const { return CombatRangeRadius; }
+
+	// Called by the proximity subsystem when a player comes within AgroRadius
+	void AgroTargetEntered(class AShooterCharacter* Character);
+
+	// Called by the proximity subsystem when a player enters or leaves CombatRangeRadius
+	void SetInCombatRange(bool bInRange);
+
+	// Attacking, in attack range, stunned, dying or recently damaged
+	bool IsInCombat() const;
+
+	// Called by the melee trace subsystem when a weapon socket sweep hits a character
+	void MeleeHit(AShooterCharacter* ShooterCharacter, FName WeaponSocket);
+
+	// Hides the enemy and stops everything on it until it's activated again
+	void ResetForPool();
+
+	// Brings a pooled enemy back at full health at the given transform
+	void ActivateFromPool(const FTransform& Transform);
+
+	FORCEINLINE void SetPooled(bool bInPooled) { bPooled = bInPooled; }
+	FORCEINLINE bool IsDying() const { return bDying; }
+
+	// Full health at this maximum, call before BeginPlay
+	FORCEINLINE void SetMaxHealth(float InMaxHealth) { MaxHealth = InMaxHealth; Health = InMaxHealth; }
+
+	// Called by the corpse subsystem when the corpse budget is exceeded
+	void FadeOutCorpse(float FadeTime);
+
+	// Sets the tick rates and overlap updates for a significance tier
+	void ApplySignificanceTier(const struct FEnemySignificanceTier& Tier);
 };
@@ -4,17 +4,29 @@
 #include "EnemyController.h"
 
 #include "Enemy.h"
+#include "ShooterBehaviorTreeComponent.h"
+#include "ShooterStats.h"
 #include "BehaviorTree/BehaviorTree.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blackboard Writes Queued"), STAT_BlackboardWritesQueued, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Blackboard Writes Applied"), STAT_BlackboardWritesApplied, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Blackboard Flush"), STAT_BlackboardFlush, STATGROUP_Shooter);
 
 AEnemyController::AEnemyController()
 {
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
 	check(BlackboardComponent);
 	
-	BehaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
+	BehaviorTreeComponent = CreateDefaultSubobject<UShooterBehaviorTreeComponent>(TEXT("BehaviorTreeComponent"));
 	check(BehaviorTreeComponent);
+
+	// RunBehaviorTree creates a component of its own unless the brain is already one
+	BrainComponent = BehaviorTreeComponent;
 }
 
 void AEnemyController::OnPossess(APawn* InPawn)
@@ -28,6 +40,138 @@ void AEnemyController::OnPossess(APawn* InPawn)
 		if (Enemy->GetBehaviorTree())
 		{
 			BlackboardComponent->InitializeBlackboard(*(Enemy->GetBehaviorTree()->BlackboardAsset));
+			CacheBlackboardKeys();
+		}
+	}
+}
+
+void AEnemyController::SetTarget(UObject* Target)
+{
+	QueueObject(TargetKey, Target);
+}
+
+void AEnemyController::SetCanAttack(bool bCanAttack)
+{
+	QueueBool(CanAttackKey, bCanAttack);
+}
+
+void AEnemyController::SetStunned(bool bStunned)
+{
+	QueueBool(StunnedKey, bStunned);
+}
+
+void AEnemyController::SetInAttackRange(bool bInAttackRange)
+{
+	QueueBool(InAttackRangeKey, bInAttackRange);
+}
+
+void AEnemyController::SetDead(bool bDead)
+{
+	QueueBool(DeadKey, bDead);
+}
+
+void AEnemyController::SetCharacterDead(bool bCharacterDead)
+{
+	QueueBool(CharacterDeadKey, bCharacterDead);
+}
+
+void AEnemyController::SetPatrolPoints(const FVector& PatrolPoint1, const FVector& PatrolPoint2)
+{
+	QueueVector(PatrolPoint1Key, PatrolPoint1);
+	QueueVector(PatrolPoint2Key, PatrolPoint2);
+}
+
+void AEnemyController::FlushBlackboardWrites()
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_BlackboardFlush, AI);
+	bFlushScheduled = false;
+
+	// SetValue only notifies observers when the value actually changes
+	for (const auto& Write : PendingBools)
+	{
+		BlackboardComponent->SetValue<UBlackboardKeyType_Bool>(Write.Key, Write.Value);
+	}
+	for (const auto& Write : PendingObjects)
+	{
+		BlackboardComponent->SetValue<UBlackboardKeyType_Object>(Write.Key, Write.Value.Get());
+	}
+	for (const auto& Write : PendingVectors)
+	{
+		BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(Write.Key, Write.Value);
+	}
+	INC_DWORD_STAT_BY(STAT_BlackboardWritesApplied, PendingBools.Num() + PendingObjects.Num() + PendingVectors.Num());
+
+	PendingBools.Reset();
+	PendingObjects.Reset();
+	PendingVectors.Reset();
+}
+
+void AEnemyController::CacheBlackboardKeys()
+{
+	TargetKey = BlackboardComponent->GetKeyID(FName("Target"));
+	CanAttackKey = BlackboardComponent->GetKeyID(FName("bCanAttack"));
+	StunnedKey = BlackboardComponent->GetKeyID(FName("bStunned"));
+	InAttackRangeKey = BlackboardComponent->GetKeyID(FName("bInAttackRange"));
+	DeadKey = BlackboardComponent->GetKeyID(FName("bDead"));
+	CharacterDeadKey = BlackboardComponent->GetKeyID(FName("bCharacterDead"));
+	PatrolPoint1Key = BlackboardComponent->GetKeyID(FName("PatrolPoint1"));
+	PatrolPoint2Key = BlackboardComponent->GetKeyID(FName("PatrolPoint2"));
+}
+
+void AEnemyController::QueueBool(FBlackboard::FKey Key, bool bValue)
+{
+	if (Key == FBlackboard::InvalidKey) return;
+	INC_DWORD_STAT(STAT_BlackboardWritesQueued);
+
+	for (auto& Write : PendingBools)
+	{
+		if (Write.Key == Key)
+		{
+			Write.Value = bValue;
+			return;
+		}
+	}
+	PendingBools.Emplace(Key, bValue);
+	ScheduleFlush();
+}
+
+void AEnemyController::QueueObject(FBlackboard::FKey Key, UObject* Value)
+{
+	if (Key == FBlackboard::InvalidKey) return;
+	INC_DWORD_STAT(STAT_BlackboardWritesQueued);
+
+	for (auto& Write : PendingObjects)
+	{
+		if (Write.Key == Key)
+		{
+			Write.Value = Value;
+			return;
+		}
+	}
+	PendingObjects.Emplace(Key, Value);
+	ScheduleFlush();
+}
+
+void AEnemyController::QueueVector(FBlackboard::FKey Key, const FVector& Value)
+{
+	if (Key == FBlackboard::InvalidKey) return;
+	INC_DWORD_STAT(STAT_BlackboardWritesQueued);
+
+	for (auto& Write : PendingVectors)
+	{
+		if (Write.Key == Key)
+		{
+			Write.Value = Value;
+			return;
 		}
 	}
+	PendingVectors.Emplace(Key, Value);
+	ScheduleFlush();
+}
+
+void AEnemyController::ScheduleFlush()
+{
+	if (bFlushScheduled) return;
+	bFlushScheduled = true;
+	GetWorldTimerManager().SetTimerForNextTick(this, &AEnemyController::FlushBlackboardWrites);
 }
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "AIController.h"
+#include "BehaviorTree/BlackboardData.h"
 #include "EnemyController.generated.h"
 
 /**
@@ -19,19 +20,57 @@ public:
 
 	virtual void OnPossess(APawn* InPawn) override;
 
+	// Typed blackboard setters. Writes are queued and applied once at the start of the next frame,
+	// so the behavior tree hears about each key at most once per frame
+	void SetTarget(UObject* Target);
+	void SetCanAttack(bool bCanAttack);
+	void SetStunned(bool bStunned);
+	void SetInAttackRange(bool bInAttackRange);
+	void SetDead(bool bDead);
+	void SetCharacterDead(bool bCharacterDead);
+	void SetPatrolPoints(const FVector& PatrolPoint1, const FVector& PatrolPoint2);
+
+	// Applies the queued writes now
+	void FlushBlackboardWrites();
+
 private:
+	// Looks up the key IDs for the blackboard asset in use
+	void CacheBlackboardKeys();
+
+	void QueueBool(FBlackboard::FKey Key, bool bValue);
+	void QueueObject(FBlackboard::FKey Key, UObject* Value);
+	void QueueVector(FBlackboard::FKey Key, const FVector& Value);
+	void ScheduleFlush();
+
+	// Key IDs resolved in OnPossess
+	FBlackboard::FKey TargetKey{FBlackboard::InvalidKey};
+	FBlackboard::FKey CanAttackKey{FBlackboard::InvalidKey};
+	FBlackboard::FKey StunnedKey{FBlackboard::InvalidKey};
+	FBlackboard::FKey InAttackRangeKey{FBlackboard::InvalidKey};
+	FBlackboard::FKey DeadKey{FBlackboard::InvalidKey};
+	FBlackboard::FKey CharacterDeadKey{FBlackboard::InvalidKey};
+	FBlackboard::FKey PatrolPoint1Key{FBlackboard::InvalidKey};
+	FBlackboard::FKey PatrolPoint2Key{FBlackboard::InvalidKey};
+
+	// Writes waiting for the next flush, latest value per key
+	TArray<TPair<FBlackboard::FKey, bool>> PendingBools;
+	TArray<TPair<FBlackboard::FKey, TWeakObjectPtr<UObject>>> PendingObjects;
+	TArray<TPair<FBlackboard::FKey, FVector>> PendingVectors;
+
+	bool bFlushScheduled{false};
+
 	// BlackboardComponent for this enemy
 	UPROPERTY(BlueprintReadWrite, Category = AIBehavior, meta = (AllowPrivateAccess = "true"))
 	class UBlackboardComponent* BlackboardComponent;
 
-	// BehaviorTreeComponent for this enemy
+	// BehaviorTreeComponent for this enemy, also its brain so RunBehaviorTree uses it
 	UPROPERTY(BlueprintReadWrite, Category = AIBehavior, meta = (AllowPrivateAccess = "true"))
-	class UBehaviorTreeComponent* BehaviorTreeComponent;
+	class UShooterBehaviorTreeComponent* BehaviorTreeComponent;
 
 public:
 
 	FORCEINLINE UBlackboardComponent* GetBlackboardComponent() const { return BlackboardComponent; }
 
-	FORCEINLINE UBehaviorTreeComponent* GetBehaviorTreeComponent() const { return BehaviorTreeComponent; }
+	FORCEINLINE UShooterBehaviorTreeComponent* GetBehaviorTreeComponent() const { return BehaviorTreeComponent; }
 	
 };
@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyCorpseSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterStats.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Live Corpses"), STAT_LiveCorpses, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Corpses Recycled"), STAT_CorpsesRecycled, STATGROUP_Shooter);
+DECLARE_MEMORY_STAT(TEXT("Corpse Memory Recovered"), STAT_CorpseMemoryRecovered, STATGROUP_Shooter);
+
+void UEnemyCorpseSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_LiveCorpses, Corpses.Num());
+	Corpses.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyCorpseSubsystem::AddCorpse(AEnemy* Enemy)
+{
+	if (!Enemy || Corpses.Contains(Enemy)) return;
+
+	Corpses.Add(Enemy);
+	INC_DWORD_STAT(STAT_LiveCorpses);
+
+	while (Corpses.Num() > FMath::Max(MaxLiveCorpses, 0))
+	{
+		FadeOutCorpse(Corpses[0]);
+	}
+}
+
+void UEnemyCorpseSubsystem::RemoveCorpse(AEnemy* Enemy)
+{
+	if (Corpses.Remove(Enemy) > 0)
+	{
+		DEC_DWORD_STAT(STAT_LiveCorpses);
+	}
+}
+
+void UEnemyCorpseSubsystem::FadeOutCorpse(AEnemy* Enemy)
+{
+	RemoveCorpse(Enemy);
+	if (!IsValid(Enemy)) return;
+
+	INC_DWORD_STAT(STAT_CorpsesRecycled);
+#if STATS
+	// Instance memory of the corpse's components, the assets they use stay loaded
+	TInlineComponentArray<UActorComponent*> Components(Enemy);
+	for (const UActorComponent* Component : Components)
+	{
+		INC_MEMORY_STAT_BY(STAT_CorpseMemoryRecovered, Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive));
+	}
+#endif
+
+	Enemy->FadeOutCorpse(FadeOutTime);
+}
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyCorpseSubsystem.generated.h"
+
+class AEnemy;
+
+/**
+ * Keeps the number of frozen enemy corpses in the world under a budget, fading out the oldest
+ * ones when more enemies die.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UEnemyCorpseSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Adds a frozen corpse, fading out the oldest ones if this goes over the budget
+	void AddCorpse(AEnemy* Enemy);
+
+	void RemoveCorpse(AEnemy* Enemy);
+
+	FORCEINLINE int32 GetNumCorpses() const { return Corpses.Num(); }
+
+private:
+	void FadeOutCorpse(AEnemy* Enemy);
+
+	// Oldest first
+	UPROPERTY()
+	TArray<AEnemy*> Corpses;
+
+	// Corpses allowed in the world before the oldest start to fade out
+	UPROPERTY(config)
+	int32 MaxLiveCorpses{12};
+
+	// Time a corpse over the budget takes to fade out before it's destroyed
+	UPROPERTY(config)
+	float FadeOutTime{1.f};
+};
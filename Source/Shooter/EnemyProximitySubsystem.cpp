@@ -0,0 +1,250 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemyProximitySubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterCharacter.h"
+#include "ShooterStats.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Proximity Update"), STAT_EnemyProximityUpdate, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Proximity Enemies"), STAT_ProximityEnemies, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Proximity Pair Tests"), STAT_ProximityPairTests, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Proximity Transitions"), STAT_ProximityTransitions, STATGROUP_Shooter);
+
+void UEnemyProximitySubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_ProximityEnemies, Enemies.Num());
+	Enemies.Empty();
+	Positions.Empty();
+	AgroRadii.Empty();
+	CombatRangeRadii.Empty();
+	EnemyFlags.Empty();
+	EnemyIndices.Empty();
+	Targets.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemyProximitySubsystem::Tick(float DeltaTime)
+{
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.f) return;
+	TimeUntilUpdate = UpdateInterval;
+
+	UpdateProximity();
+}
+
+bool UEnemyProximitySubsystem::IsTickable() const
+{
+	return Enemies.Num() > 0 && !IsTemplate();
+}
+
+TStatId UEnemyProximitySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemyProximitySubsystem, STATGROUP_Tickables);
+}
+
+void UEnemyProximitySubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (!Enemy || EnemyIndices.Contains(Enemy)) return;
+
+	EnemyIndices.Add(Enemy, Enemies.Add(Enemy));
+	Positions.Add(Enemy->GetActorLocation());
+	AgroRadii.Add(Enemy->GetAgroRadius());
+	CombatRangeRadii.Add(Enemy->GetCombatRangeRadius());
+	EnemyFlags.Add(FlagEnabled);
+	MaxRadius = FMath::Max3(MaxRadius, Enemy->GetAgroRadius(), Enemy->GetCombatRangeRadius());
+	INC_DWORD_STAT(STAT_ProximityEnemies);
+}
+
+void UEnemyProximitySubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	const int32* Index = EnemyIndices.Find(Enemy);
+	if (!Index) return;
+
+	RemoveEnemyAt(*Index);
+}
+
+void UEnemyProximitySubsystem::SetEnemyEnabled(AEnemy* Enemy, bool bEnabled)
+{
+	const int32* Index = EnemyIndices.Find(Enemy);
+	if (!Index) return;
+
+	if (bEnabled)
+	{
+		EnemyFlags[*Index] |= FlagEnabled;
+	}
+	else
+	{
+		EnemyFlags[*Index] &= ~FlagEnabled;
+	}
+}
+
+void UEnemyProximitySubsystem::UpdateProximity()
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemyProximityUpdate, Enemies);
+
+	// Gather the players
+	Targets.Reset();
+	TargetPositions.Reset();
+	TargetRadii.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		AShooterCharacter* Character = PlayerController ? Cast<AShooterCharacter>(PlayerController->GetPawn()) : nullptr;
+		if (!Character) continue;
+
+		Targets.Add(Character);
+		TargetPositions.Add(Character->GetActorLocation());
+		// The spheres used to overlap the capsule, not its center
+		TargetRadii.Add(Character->GetCapsuleComponent()->GetScaledCapsuleRadius());
+	}
+
+	// Anything that was destroyed without unregistering is dropped here
+	for (int32 i = Enemies.Num() - 1; i >= 0; --i)
+	{
+		if (IsValid(Enemies[i]))
+		{
+			Positions[i] = Enemies[i]->GetActorLocation();
+		}
+		else
+		{
+			RemoveEnemyAt(i);
+		}
+	}
+
+	BuildSpatialHash();
+
+	// Disabled enemies keep what they had
+	const int32 NumEnemies{Enemies.Num()};
+	NewFlags.SetNumUninitialized(NumEnemies);
+	NewAgroTargets.Init(INDEX_NONE, NumEnemies);
+	for (int32 i = 0; i < NumEnemies; ++i)
+	{
+		NewFlags[i] = (EnemyFlags[i] & FlagEnabled) ? FlagEnabled : EnemyFlags[i];
+	}
+
+	// Test the enemies in the cells around each player
+	int32 NumPairTests{0};
+	for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+	{
+		const FVector& TargetPosition{TargetPositions[TargetIndex]};
+		const float QueryRadius{MaxRadius + TargetRadii[TargetIndex]};
+		const FIntVector MinCell{GetCell(TargetPosition - FVector(QueryRadius))};
+		const FIntVector MaxCell{GetCell(TargetPosition + FVector(QueryRadius))};
+
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+				{
+					const int32 Bucket{GetBucket(FIntVector(X, Y, Z))};
+					for (int32 Sorted = BucketStarts[Bucket]; Sorted < BucketStarts[Bucket + 1]; ++Sorted)
+					{
+						const int32 i{SortedEnemies[Sorted]};
+						++NumPairTests;
+
+						const float Distance{FVector::Dist(Positions[i], TargetPosition) - TargetRadii[TargetIndex]};
+						if (Distance <= AgroRadii[i] && !(NewFlags[i] & FlagInAgro))
+						{
+							NewFlags[i] |= FlagInAgro;
+							NewAgroTargets[i] = TargetIndex;
+						}
+						if (Distance <= CombatRangeRadii[i])
+						{
+							NewFlags[i] |= FlagInCombatRange;
+						}
+					}
+				}
+			}
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_ProximityPairTests, NumPairTests);
+
+	// Push the transitions
+	for (int32 i = 0; i < NumEnemies; ++i)
+	{
+		const uint8 OldFlags{EnemyFlags[i]};
+		const uint8 Flags{NewFlags[i]};
+		EnemyFlags[i] = Flags;
+		if (OldFlags == Flags) continue;
+
+		AEnemy* Enemy = Enemies[i];
+		if ((Flags & FlagInAgro) && !(OldFlags & FlagInAgro))
+		{
+			INC_DWORD_STAT(STAT_ProximityTransitions);
+			Enemy->AgroTargetEntered(Targets[NewAgroTargets[i]]);
+		}
+		if ((Flags & FlagInCombatRange) != (OldFlags & FlagInCombatRange))
+		{
+			INC_DWORD_STAT(STAT_ProximityTransitions);
+			Enemy->SetInCombatRange((Flags & FlagInCombatRange) != 0);
+		}
+	}
+}
+
+void UEnemyProximitySubsystem::BuildSpatialHash()
+{
+	// Counting sort of enemy indices by bucket, only enabled enemies go in
+	const int32 NumEnemies{Enemies.Num()};
+	const int32 NumBuckets{static_cast<int32>(FMath::RoundUpToPowerOfTwo(FMath::Max(NumEnemies * 2, 16)))};
+	BucketStarts.Init(0, NumBuckets + 1);
+	EnemyBuckets.SetNumUninitialized(NumEnemies);
+
+	for (int32 i = 0; i < NumEnemies; ++i)
+	{
+		EnemyBuckets[i] = (EnemyFlags[i] & FlagEnabled) ? GetBucket(GetCell(Positions[i])) : INDEX_NONE;
+		if (EnemyBuckets[i] != INDEX_NONE)
+		{
+			++BucketStarts[EnemyBuckets[i]];
+		}
+	}
+
+	// Running total gives the end of each bucket, filling backwards leaves the start
+	for (int32 Bucket = 1; Bucket <= NumBuckets; ++Bucket)
+	{
+		BucketStarts[Bucket] += BucketStarts[Bucket - 1];
+	}
+	SortedEnemies.SetNumUninitialized(BucketStarts[NumBuckets]);
+	for (int32 i = 0; i < NumEnemies; ++i)
+	{
+		if (EnemyBuckets[i] != INDEX_NONE)
+		{
+			SortedEnemies[--BucketStarts[EnemyBuckets[i]]] = i;
+		}
+	}
+}
+
+int32 UEnemyProximitySubsystem::GetBucket(const FIntVector& Cell) const
+{
+	const uint32 Hash{static_cast<uint32>(Cell.X) * 73856093u ^ static_cast<uint32>(Cell.Y) * 19349663u ^ static_cast<uint32>(Cell.Z) * 83492791u};
+	return static_cast<int32>(Hash & static_cast<uint32>(BucketStarts.Num() - 2));
+}
+
+FIntVector UEnemyProximitySubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void UEnemyProximitySubsystem::RemoveEnemyAt(int32 Index)
+{
+	EnemyIndices.Remove(Enemies[Index]);
+	Enemies.RemoveAtSwap(Index, 1, false);
+	Positions.RemoveAtSwap(Index, 1, false);
+	AgroRadii.RemoveAtSwap(Index, 1, false);
+	CombatRangeRadii.RemoveAtSwap(Index, 1, false);
+	EnemyFlags.RemoveAtSwap(Index, 1, false);
+	if (Enemies.IsValidIndex(Index))
+	{
+		EnemyIndices.Add(Enemies[Index], Index);
+	}
+	DEC_DWORD_STAT(STAT_ProximityEnemies);
+}
@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemyProximitySubsystem.generated.h"
+
+class AEnemy;
+class AShooterCharacter;
+
+/**
+ * Works out which enemies have a player inside their agro radius or combat range, replacing a pair of
+ * overlap spheres per enemy. Enemy positions are bucketed into a flat spatial hash every update and only
+ * the buckets around each player are tested. Transitions are pushed to the enemies, which write them
+ * to their blackboards.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UEnemyProximitySubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	// Disabled enemies keep their current agro and combat range state until enabled again
+	void SetEnemyEnabled(AEnemy* Enemy, bool bEnabled);
+
+private:
+	void UpdateProximity();
+
+	// Fills BucketStarts and SortedEnemies from Positions
+	void BuildSpatialHash();
+
+	int32 GetBucket(const FIntVector& Cell) const;
+
+	FIntVector GetCell(const FVector& Location) const;
+
+	void RemoveEnemyAt(int32 Index);
+
+	// Bits in EnemyFlags
+	static constexpr uint8 FlagEnabled{1 << 0};
+	static constexpr uint8 FlagInAgro{1 << 1};
+	static constexpr uint8 FlagInCombatRange{1 << 2};
+
+	// Per enemy, all indexed the same way
+	UPROPERTY()
+	TArray<AEnemy*> Enemies;
+	TArray<FVector> Positions;
+	TArray<float> AgroRadii;
+	TArray<float> CombatRangeRadii;
+	TArray<uint8> EnemyFlags;
+
+	TMap<AEnemy*, int32> EnemyIndices;
+
+	// Players found this update
+	UPROPERTY()
+	TArray<AShooterCharacter*> Targets;
+	TArray<FVector> TargetPositions;
+	TArray<float> TargetRadii;
+
+	// Spatial hash, enemies in bucket B are SortedEnemies[BucketStarts[B]] up to SortedEnemies[BucketStarts[B + 1]]
+	TArray<int32> BucketStarts;
+	TArray<int32> SortedEnemies;
+	TArray<int32> EnemyBuckets;
+
+	// Scratch per enemy results for an update
+	TArray<uint8> NewFlags;
+	TArray<int32> NewAgroTargets;
+
+	// Width of a spatial hash cell
+	UPROPERTY(config)
+	float CellSize{1000.f};
+
+	// Time between updates, zero updates every frame
+	UPROPERTY(config)
+	float UpdateInterval{0.f};
+
+	float TimeUntilUpdate{0.f};
+
+	// Largest agro or combat radius of any registered enemy
+	float MaxRadius{0.f};
+};
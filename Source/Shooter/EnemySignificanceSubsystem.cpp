@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "EnemySignificanceSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Misc/App.h"
+
+DECLARE_CYCLE_STAT(TEXT("Enemy Significance Update"), STAT_EnemySignificanceUpdate, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies At Full Fidelity"), STAT_EnemiesFullFidelity, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Enemies Throttled"), STAT_EnemiesThrottled, STATGROUP_Shooter);
+
+void UEnemySignificanceSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (Tiers.Num() == 0)
+	{
+		// Only full fidelity if nothing is configured
+		Tiers.AddDefaulted();
+	}
+}
+
+void UEnemySignificanceSubsystem::Deinitialize()
+{
+	SET_DWORD_STAT(STAT_EnemiesFullFidelity, 0);
+	SET_DWORD_STAT(STAT_EnemiesThrottled, 0);
+	Enemies.Empty();
+
+	Super::Deinitialize();
+}
+
+void UEnemySignificanceSubsystem::Tick(float DeltaTime)
+{
+	TimeUntilUpdate -= DeltaTime;
+	if (TimeUntilUpdate > 0.f) return;
+	TimeUntilUpdate = UpdateInterval;
+
+	UpdateSignificance();
+}
+
+bool UEnemySignificanceSubsystem::IsTickable() const
+{
+	return Enemies.Num() > 0 && !IsTemplate();
+}
+
+TStatId UEnemySignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UEnemySignificanceSubsystem, STATGROUP_Tickables);
+}
+
+void UEnemySignificanceSubsystem::RegisterEnemy(AEnemy* Enemy)
+{
+	if (!Enemy || Enemies.Contains(Enemy)) return;
+
+	// New enemies start at full fidelity until the next update
+	Enemies.Add(Enemy, 0);
+	Enemy->ApplySignificanceTier(Tiers[0]);
+	INC_DWORD_STAT(STAT_EnemiesFullFidelity);
+}
+
+void UEnemySignificanceSubsystem::UnregisterEnemy(AEnemy* Enemy)
+{
+	int32 Tier{0};
+	if (!Enemies.RemoveAndCopyValue(Enemy, Tier)) return;
+
+	if (Tier == 0)
+	{
+		DEC_DWORD_STAT(STAT_EnemiesFullFidelity);
+	}
+	else
+	{
+		DEC_DWORD_STAT(STAT_EnemiesThrottled);
+	}
+}
+
+int32 UEnemySignificanceSubsystem::GetNumThrottledEnemies() const
+{
+	int32 NumThrottled{0};
+	for (const auto& EnemyPair : Enemies)
+	{
+		if (EnemyPair.Value > 0)
+		{
+			++NumThrottled;
+		}
+	}
+	return NumThrottled;
+}
+
+void UEnemySignificanceSubsystem::UpdateSignificance()
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_EnemySignificanceUpdate, Enemies);
+
+	// Without a player there's nobody to be significant to, leave everything as it is
+	GetPlayerLocations(PlayerLocations);
+	if (PlayerLocations.Num() == 0) return;
+
+	// Dedicated servers and -nullrhi runs never render a mesh, so being off screen means nothing there
+	const bool bCanRender{FApp::CanEverRender() && GetWorld()->GetNetMode() != NM_DedicatedServer};
+
+	int32 NumFullFidelity{0};
+	for (auto& EnemyPair : Enemies)
+	{
+		AEnemy* Enemy = EnemyPair.Key;
+		if (!Enemy) continue;
+
+		const int32 Tier{GetTierForEnemy(Enemy, PlayerLocations, bCanRender)};
+		if (Tier != EnemyPair.Value)
+		{
+			EnemyPair.Value = Tier;
+			Enemy->ApplySignificanceTier(Tiers[Tier]);
+		}
+		if (Tier == 0)
+		{
+			++NumFullFidelity;
+		}
+	}
+	SET_DWORD_STAT(STAT_EnemiesFullFidelity, NumFullFidelity);
+	SET_DWORD_STAT(STAT_EnemiesThrottled, Enemies.Num() - NumFullFidelity);
+}
+
+void UEnemySignificanceSubsystem::GetPlayerLocations(TArray<FVector>& OutLocations) const
+{
+	OutLocations.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PlayerController = It->Get();
+		const APawn* PlayerPawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+		if (PlayerPawn)
+		{
+			OutLocations.Add(PlayerPawn->GetActorLocation());
+		}
+	}
+}
+
+int32 UEnemySignificanceSubsystem::GetTierForEnemy(const AEnemy* Enemy, const TArray<FVector>& PlayerLocations,
+	bool bCanRender) const
+{
+	// Anything fighting a player keeps full fidelity
+	if (Enemy->IsInCombat()) return 0;
+
+	// Scored against the nearest player
+	const FVector EnemyLocation{Enemy->GetActorLocation()};
+	float DistanceSquared{TNumericLimits<float>::Max()};
+	for (const FVector& PlayerLocation : PlayerLocations)
+	{
+		DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(EnemyLocation, PlayerLocation));
+	}
+	int32 Tier{Tiers.Num() - 1};
+	for (int32 i = 0; i < Tiers.Num(); ++i)
+	{
+		if (DistanceSquared <= FMath::Square(Tiers[i].MaxDistance))
+		{
+			Tier = i;
+			break;
+		}
+	}
+
+	// Off screen, one tier less significant
+	const USkeletalMeshComponent* Mesh = Enemy->GetMesh();
+	if (bCanRender && Mesh && !Mesh->WasRecentlyRendered(RecentlyRenderedTime))
+	{
+		Tier = FMath::Min(Tier + 1, Tiers.Num() - 1);
+	}
+	return Tier;
+}
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "EnemySignificanceSubsystem.generated.h"
+
+class AEnemy;
+
+// How much work an enemy in a significance tier gets to do
+USTRUCT()
+struct FEnemySignificanceTier
+{
+	GENERATED_BODY()
+
+	// Enemies up to this far from the player fall in the tier
+	UPROPERTY(config)
+	float MaxDistance{0.f};
+
+	// Tick interval for the character movement component
+	UPROPERTY(config)
+	float MovementTickInterval{0.f};
+
+	// Tick interval for the skeletal mesh, which drives the anim instance
+	UPROPERTY(config)
+	float MeshTickInterval{0.f};
+
+	// Only tick the pose while the mesh is on screen
+	UPROPERTY(config)
+	bool bOnlyTickPoseWhenRendered{false};
+
+	// Least time between behavior tree ticks
+	UPROPERTY(config)
+	float BehaviorTreeTickInterval{0.f};
+
+	// Keep checking agro and combat range in the proximity subsystem
+	UPROPERTY(config)
+	bool bUpdateProximity{true};
+};
+
+/**
+ * Scores enemies by distance to the nearest player, whether they are on screen and whether they are in combat,
+ * and throttles the movement, animation, behavior tree and proximity updates of the less significant ones.
+ * Tier 0 is full fidelity.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UEnemySignificanceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterEnemy(AEnemy* Enemy);
+	void UnregisterEnemy(AEnemy* Enemy);
+
+	FORCEINLINE int32 GetNumTiers() const { return Tiers.Num(); }
+
+	FORCEINLINE int32 GetNumEnemies() const { return Enemies.Num(); }
+
+	// Enemies below full fidelity as of the last update
+	int32 GetNumThrottledEnemies() const;
+
+private:
+	// Rescores every enemy and moves the ones whose tier changed
+	void UpdateSignificance();
+
+	// Locations of every player's pawn, the server scores enemies for all of them
+	void GetPlayerLocations(TArray<FVector>& OutLocations) const;
+
+	int32 GetTierForEnemy(const AEnemy* Enemy, const TArray<FVector>& PlayerLocations, bool bCanRender) const;
+
+	// Enemies and the tier they are in
+	UPROPERTY()
+	TMap<AEnemy*, int32> Enemies;
+
+	// Most significant first. Enemies beyond every MaxDistance use the last tier
+	UPROPERTY(config)
+	TArray<FEnemySignificanceTier> Tiers;
+
+	// Time between significance updates
+	UPROPERTY(config)
+	float UpdateInterval{0.25f};
+
+	// Enemies that haven't been rendered for this long drop one tier. Not used where nothing renders
+	UPROPERTY(config)
+	float RecentlyRenderedTime{0.5f};
+
+	// Kept between updates to avoid reallocating
+	TArray<FVector> PlayerLocations;
+
+	float TimeUntilUpdate{0.f};
+};
@@ -3,11 +3,16 @@
 
 #include "Explosive.h"
 
+#include "ParticlePoolSubsystem.h"
+#include "Shooter.h"
+#include "ShooterStats.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/Character.h"
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 
+DECLARE_CYCLE_STAT(TEXT("Explosive Bullet Hit"), STAT_ExplosiveBulletHit, STATGROUP_Shooter);
+
 // Sets default values
 AExplosive::AExplosive() :
 Damage(50.f)
@@ -39,15 +44,16 @@ void AExplosive::Tick(float DeltaTime)
 
 void AExplosive::BulletHit_Implementation(FHitResult HitResult, AActor* Shooter, AController* ShooterController)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ExplosiveBulletHit, Weapons);
 	IBulletHitInterface::BulletHit_Implementation(HitResult, Shooter, ShooterController);
 
-	if (ExplosionSound)
+	if (ExplosionSound && ShouldPlayCosmetics(this))
 	{
 		UGameplayStatics::PlaySoundAtLocation(this, ExplosionSound, GetActorLocation());
 	}
 	if (ExplosionParticles)
 	{
-		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ExplosionParticles, HitResult.Location, FRotator(0.f), true);
+		UParticlePoolSubsystem::SpawnEmitter(this, ExplosionParticles, HitResult.Location);
 	}
 
 	// Apply explosion damage
@@ -4,18 +4,53 @@
 #include "GruxAnimInstance.h"
 
 #include "Enemy.h"
+#include "ShooterStats.h"
 
-void UGruxAnimInstance::UpdateAnimationProperties(float DeltaTime)
+DECLARE_CYCLE_STAT(TEXT("Grux Anim PreUpdate"), STAT_GruxAnimPreUpdate, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Grux Anim Update"), STAT_GruxAnimUpdate, STATGROUP_Shooter);
+
+void FGruxAnimInstanceProxy::Initialize(UAnimInstance* InAnimInstance)
+{
+	FAnimInstanceProxy::Initialize(InAnimInstance);
+	GruxAnimInstance = Cast<UGruxAnimInstance>(InAnimInstance);
+}
+
+void FGruxAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
 {
-	if (!Enemy)
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_GruxAnimPreUpdate, Animation);
+	FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+	if (!GruxAnimInstance) return;
+
+	if (!GruxAnimInstance->Enemy)
 	{
-		Enemy = Cast<AEnemy>(TryGetPawnOwner());
+		GruxAnimInstance->Enemy = Cast<AEnemy>(GruxAnimInstance->TryGetPawnOwner());
 	}
-	
-	if (Enemy)
+
+	bHasEnemy = GruxAnimInstance->Enemy != nullptr;
+	if (bHasEnemy)
 	{
-		FVector Velocity = Enemy->GetVelocity();
-		Velocity.Z = 0.f;
-		Speed = Velocity.Size();
+		Velocity = GruxAnimInstance->Enemy->GetVelocity();
 	}
 }
+
+void FGruxAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_GruxAnimUpdate, Animation);
+	FAnimInstanceProxy::Update(DeltaSeconds);
+
+	// Worker thread
+	if (!GruxAnimInstance || !bHasEnemy) return;
+
+	FVector LateralVelocity{Velocity};
+	LateralVelocity.Z = 0.f;
+	GruxAnimInstance->Speed = LateralVelocity.Size();
+}
+
+void UGruxAnimInstance::UpdateAnimationProperties(float DeltaTime)
+{
+}
+
+FAnimInstanceProxy* UGruxAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FGruxAnimInstanceProxy(this);
+}
@@ -4,8 +4,34 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "GruxAnimInstance.generated.h"
 
+/**
+ * Copies the enemy's velocity on the game thread and works out Speed on an anim worker thread,
+ * so crowds of enemies animate in parallel.
+ */
+USTRUCT()
+struct FGruxAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FGruxAnimInstanceProxy() {}
+	FGruxAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+protected:
+	virtual void Initialize(UAnimInstance* InAnimInstance) override;
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	class UGruxAnimInstance* GruxAnimInstance{nullptr};
+
+	// Enemy state copied in PreUpdate
+	bool bHasEnemy{false};
+	FVector Velocity{FVector::ZeroVector};
+};
+
 /**
  * 
  */
@@ -15,10 +41,16 @@ class SHOOTER_API UGruxAnimInstance : public UAnimInstance
 	GENERATED_BODY()
 	
 public:
-	UFUNCTION(BlueprintCallable)
+	// Speed is updated by FGruxAnimInstanceProxy on a worker thread, this does nothing now
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Properties are updated natively, remove this call"))
 	void UpdateAnimationProperties(float DeltaTime);
+
+protected:
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
 	
 private:
+	friend struct FGruxAnimInstanceProxy;
+
 	// Lateral movement speed
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true", MakeEditWidget = "true"))
 	float Speed;
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitNumberLayer.h"
+
+#include "ShooterStats.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hit Number Update"), STAT_HitNumberUpdate, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hit Numbers On Screen"), STAT_HitNumbersOnScreen, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Number Widgets Created"), STAT_HitNumberWidgetsCreated, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hit Number Widgets Moved"), STAT_HitNumberWidgetsMoved, STATGROUP_Shooter);
+
+void UHitNumberLayer::Initialize(APlayerController* InOwner, TSubclassOf<UHitNumberWidget> WidgetClass, int32 Capacity)
+{
+	Owner = InOwner;
+	Entries.SetNum(FMath::Max(Capacity, 1));
+	NextSlot = 0;
+
+	if (!Owner || !WidgetClass) return;
+
+	Pool.Reserve(Entries.Num());
+	for (int32 i = 0; i < Entries.Num(); ++i)
+	{
+		UHitNumberWidget* Widget = CreateWidget<UHitNumberWidget>(Owner, WidgetClass);
+		if (!Widget) break;
+		INC_DWORD_STAT(STAT_HitNumberWidgetsCreated);
+		++NumWidgetsCreated;
+
+		Widget->AddToViewport();
+		Widget->SetVisibility(ESlateVisibility::Collapsed);
+		Pool.Add(Widget);
+	}
+}
+
+bool UHitNumberLayer::AddHitNumber(int32 Damage, const FVector& Location, bool bHeadShot, float Lifetime)
+{
+	if (!HasWidgetPool() || !Owner) return false;
+
+	FHitNumberEntry& Entry = ClaimSlot();
+	if (Pool.Num() == 0) return false;
+
+	UHitNumberWidget* Widget = Pool.Pop(false);
+	++NumPooledInUse;
+	Entry.Widget = Widget;
+	Entry.Location = Location;
+	Entry.ExpireTime = Owner->GetWorld()->GetTimeSeconds() + Lifetime;
+	Entry.bPooled = true;
+	INC_DWORD_STAT(STAT_HitNumbersOnScreen);
+
+	Widget->SetVisibility(ESlateVisibility::HitTestInvisible);
+	Widget->OnHitNumberShown(Damage, bHeadShot);
+	return true;
+}
+
+void UHitNumberLayer::AddHitNumberWidget(UUserWidget* Widget, const FVector& Location, float Lifetime)
+{
+	if (!Widget || !Owner) return;
+	++NumWidgetsCreated;
+
+	FHitNumberEntry& Entry = ClaimSlot();
+	Entry.Widget = Widget;
+	Entry.Location = Location;
+	Entry.ExpireTime = Owner->GetWorld()->GetTimeSeconds() + Lifetime;
+	Entry.bPooled = false;
+	INC_DWORD_STAT(STAT_HitNumbersOnScreen);
+}
+
+void UHitNumberLayer::RemoveHitNumberWidget(UUserWidget* Widget)
+{
+	if (!Widget) return;
+
+	for (FHitNumberEntry& Entry : Entries)
+	{
+		if (Entry.Widget == Widget)
+		{
+			ReleaseEntry(Entry);
+			return;
+		}
+	}
+	// Not tracked by the layer, remove it anyway
+	Widget->RemoveFromParent();
+}
+
+void UHitNumberLayer::Update()
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_HitNumberUpdate, UI);
+	if (!Owner) return;
+
+	const uint64 StartCycles{FPlatformTime::Cycles64()};
+	const float Now{Owner->GetWorld()->GetTimeSeconds()};
+	for (FHitNumberEntry& Entry : Entries)
+	{
+		if (!Entry.Widget) continue;
+
+		if (Now >= Entry.ExpireTime)
+		{
+			ReleaseEntry(Entry);
+			continue;
+		}
+
+		FVector2D ScreenPosition;
+		Owner->ProjectWorldLocationToScreen(Entry.Location, ScreenPosition);
+		Entry.Widget->SetPositionInViewport(ScreenPosition);
+		INC_DWORD_STAT(STAT_HitNumberWidgetsMoved);
+	}
+	UpdateCycles += FPlatformTime::Cycles64() - StartCycles;
+}
+
+FHitNumberEntry& UHitNumberLayer::ClaimSlot()
+{
+	FHitNumberEntry& Entry = Entries[NextSlot];
+	NextSlot = (NextSlot + 1) % Entries.Num();
+
+	// Ring is full, drop the oldest number
+	ReleaseEntry(Entry);
+	return Entry;
+}
+
+void UHitNumberLayer::ReleaseEntry(FHitNumberEntry& Entry)
+{
+	if (!Entry.Widget) return;
+	DEC_DWORD_STAT(STAT_HitNumbersOnScreen);
+
+	if (Entry.bPooled)
+	{
+		UHitNumberWidget* Widget = CastChecked<UHitNumberWidget>(Entry.Widget);
+		Widget->SetVisibility(ESlateVisibility::Collapsed);
+		Pool.Add(Widget);
+		--NumPooledInUse;
+	}
+	else
+	{
+		Entry.Widget->RemoveFromParent();
+	}
+	Entry.Widget = nullptr;
+}
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HitNumberLayer.generated.h"
+
+class APlayerController;
+
+/**
+ * Hit number widget the layer can reuse. The blueprint subclass sets its text and plays its animation
+ */
+UCLASS()
+class SHOOTER_API UHitNumberWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	// Called every time the widget is reused for a new hit
+	UFUNCTION(BlueprintImplementableEvent, Category = HitNumber)
+	void OnHitNumberShown(int32 Damage, bool bHeadShot);
+};
+
+// A hit number on screen
+USTRUCT()
+struct FHitNumberEntry
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	UUserWidget* Widget{nullptr};
+
+	// World location the number sticks to
+	FVector Location{FVector::ZeroVector};
+
+	// World time the number is removed at
+	float ExpireTime{0.f};
+
+	// Pooled widgets are collapsed when they expire, others are removed from the viewport
+	bool bPooled{false};
+};
+
+/**
+ * Every hit number on screen, kept in a fixed size ring buffer and projected in one pass per frame.
+ * Owned by the player controller. When the ring is full the oldest number is dropped.
+ */
+UCLASS()
+class SHOOTER_API UHitNumberLayer : public UObject
+{
+	GENERATED_BODY()
+
+public:
+	// Sets the ring size and pre-creates Capacity widgets of WidgetClass, if there is one
+	void Initialize(APlayerController* InOwner, TSubclassOf<UHitNumberWidget> WidgetClass, int32 Capacity);
+
+	// Shows a number with a pooled widget. Returns false if the layer has no widget class
+	bool AddHitNumber(int32 Damage, const FVector& Location, bool bHeadShot, float Lifetime);
+
+	// Tracks a widget created elsewhere until it expires
+	void AddHitNumberWidget(UUserWidget* Widget, const FVector& Location, float Lifetime);
+
+	// Removes a number before it expires
+	void RemoveHitNumberWidget(UUserWidget* Widget);
+
+	// Expires old numbers and moves the rest to their projected screen positions
+	void Update();
+
+	FORCEINLINE bool HasWidgetPool() const { return Pool.Num() > 0 || NumPooledInUse > 0; }
+
+	// Totals since the layer was created, for benchmarks. Widgets created elsewhere count when they're added
+	FORCEINLINE int32 GetNumWidgetsCreated() const { return NumWidgetsCreated; }
+	FORCEINLINE uint64 GetUpdateCycles() const { return UpdateCycles; }
+
+private:
+	// Claims the next ring slot, dropping whatever was in it
+	FHitNumberEntry& ClaimSlot();
+
+	void ReleaseEntry(FHitNumberEntry& Entry);
+
+	UPROPERTY()
+	APlayerController* Owner;
+
+	UPROPERTY()
+	TArray<FHitNumberEntry> Entries;
+
+	// Free pooled widgets, collapsed in the viewport
+	UPROPERTY()
+	TArray<UHitNumberWidget*> Pool;
+
+	// Next ring slot to use
+	int32 NextSlot{0};
+
+	int32 NumPooledInUse{0};
+
+	int32 NumWidgetsCreated{0};
+
+	uint64 UpdateCycles{0};
+};
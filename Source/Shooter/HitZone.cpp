@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitZone.h"
+
+#include "Engine/SkeletalMesh.h"
+
+TSharedPtr<const FHitZoneTable> FHitZoneTable::Build(const USkeletalMesh* Mesh,
+	const TMap<EHitZone, FHitZoneSettings>& ZoneSettings)
+{
+	if (!Mesh) return nullptr;
+
+	TSharedPtr<FHitZoneTable> Table = MakeShared<FHitZoneTable>();
+	for (int32 i = 0; i < static_cast<int32>(EHitZone::EHZ_MAX); i++)
+	{
+		Table->DamageMultipliers[i] = 1.f;
+	}
+
+	// Bones listed in the settings start a zone
+	const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+	const int32 NumBones{RefSkeleton.GetNum()};
+	TArray<bool> bZoneRoot;
+	bZoneRoot.Init(false, NumBones);
+	Table->BoneZones.Init(EHitZone::EHZ_Torso, NumBones);
+	for (const auto& ZonePair : ZoneSettings)
+	{
+		Table->DamageMultipliers[static_cast<int32>(ZonePair.Key)] = ZonePair.Value.DamageMultiplier;
+		for (const FName& BoneName : ZonePair.Value.Bones)
+		{
+			const int32 BoneIndex{RefSkeleton.FindBoneIndex(BoneName)};
+			if (BoneIndex != INDEX_NONE)
+			{
+				Table->BoneZones[BoneIndex] = ZonePair.Key;
+				bZoneRoot[BoneIndex] = true;
+			}
+		}
+	}
+
+	// Every other bone takes the zone of its parent. Parents always come before their children
+	for (int32 BoneIndex = 1; BoneIndex < NumBones; BoneIndex++)
+	{
+		if (!bZoneRoot[BoneIndex])
+		{
+			Table->BoneZones[BoneIndex] = Table->BoneZones[RefSkeleton.GetParentIndex(BoneIndex)];
+		}
+	}
+
+	return Table;
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HitZone.generated.h"
+
+UENUM(BlueprintType)
+enum class EHitZone : uint8
+{
+	EHZ_Head	UMETA(DisplayName = "Head"),
+	EHZ_Torso	UMETA(DisplayName = "Torso"),
+	EHZ_Limb	UMETA(DisplayName = "Limb"),
+
+	EHZ_MAX		UMETA(DisplayName = "DefaultMAX")
+};
+
+USTRUCT(BlueprintType)
+struct FHitZoneSettings
+{
+	GENERATED_BODY()
+
+	// Bones that start this zone, their child bones belong to it too
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FName> Bones;
+
+	// Multiplier applied to the weapon damage for hits in this zone
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float DamageMultiplier{1.f};
+
+	FORCEINLINE bool operator==(const FHitZoneSettings& Other) const
+	{
+		return DamageMultiplier == Other.DamageMultiplier && Bones == Other.Bones;
+	}
+};
+
+// Hit zone of every bone in a skeletal mesh, indexed by bone index
+struct SHOOTER_API FHitZoneTable
+{
+	// Zone for each bone in the reference skeleton
+	TArray<EHitZone> BoneZones;
+
+	// Damage multiplier for each zone
+	float DamageMultipliers[static_cast<int32>(EHitZone::EHZ_MAX)];
+
+	FORCEINLINE EHitZone GetZone(int32 BoneIndex) const
+	{
+		return BoneZones.IsValidIndex(BoneIndex) ? BoneZones[BoneIndex] : EHitZone::EHZ_Torso;
+	}
+
+	FORCEINLINE float GetDamageMultiplier(EHitZone Zone) const
+	{
+		return DamageMultipliers[static_cast<int32>(Zone)];
+	}
+
+	// Builds the table for this mesh. UHitZoneSubsystem shares them between enemies
+	static TSharedPtr<const FHitZoneTable> Build(const class USkeletalMesh* Mesh,
+		const TMap<EHitZone, FHitZoneSettings>& ZoneSettings);
+};
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitZoneSubsystem.h"
+
+#include "Engine/SkeletalMesh.h"
+
+static bool SameZoneSettings(const TMap<EHitZone, FHitZoneSettings>& A, const TMap<EHitZone, FHitZoneSettings>& B)
+{
+	if (A.Num() != B.Num()) return false;
+	for (const auto& ZonePair : A)
+	{
+		const FHitZoneSettings* Other = B.Find(ZonePair.Key);
+		if (!Other || !(*Other == ZonePair.Value)) return false;
+	}
+	return true;
+}
+
+void UHitZoneSubsystem::Deinitialize()
+{
+	Tables.Empty();
+
+	Super::Deinitialize();
+}
+
+TSharedPtr<const FHitZoneTable> UHitZoneSubsystem::FindOrBuildTable(const USkeletalMesh* Mesh,
+	const TMap<EHitZone, FHitZoneSettings>& ZoneSettings)
+{
+	if (!Mesh) return nullptr;
+
+	TArray<const FCachedTable*> MeshTables;
+	Tables.MultiFindPointer(Mesh, MeshTables);
+	for (const FCachedTable* Cached : MeshTables)
+	{
+		if (SameZoneSettings(Cached->ZoneSettings, ZoneSettings))
+		{
+			return Cached->Table;
+		}
+	}
+
+	FCachedTable Cached;
+	Cached.ZoneSettings = ZoneSettings;
+	Cached.Table = FHitZoneTable::Build(Mesh, ZoneSettings);
+	Tables.Add(Mesh, Cached);
+	return Cached.Table;
+}
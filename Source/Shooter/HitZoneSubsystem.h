@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HitZone.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HitZoneSubsystem.generated.h"
+
+class USkeletalMesh;
+
+/**
+ * Shares hit zone tables between enemies with the same mesh and zone settings. Tables live as long as
+ * the world, so a new PIE session or a reimported mesh builds them again.
+ */
+UCLASS()
+class SHOOTER_API UHitZoneSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Returns the table for this mesh and zone settings, building it the first time it's asked for
+	TSharedPtr<const FHitZoneTable> FindOrBuildTable(const USkeletalMesh* Mesh,
+		const TMap<EHitZone, FHitZoneSettings>& ZoneSettings);
+
+	FORCEINLINE int32 GetNumTables() const { return Tables.Num(); }
+
+private:
+	struct FCachedTable
+	{
+		TMap<EHitZone, FHitZoneSettings> ZoneSettings;
+		TSharedPtr<const FHitZoneTable> Table;
+	};
+
+	// Enemies can override the zones per instance, so each mesh can have several tables
+	TMultiMap<TObjectKey<USkeletalMesh>, FCachedTable> Tables;
+};
@@ -0,0 +1,164 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HitscanSubsystem.h"
+
+#include "ShooterStats.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Hitscan Resolve"), STAT_HitscanResolve, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Hitscan Traces"), STAT_HitscanTraces, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarAsyncHitscan(
+	TEXT("Shooter.Hitscan.Async"),
+	1,
+	TEXT("0: trace shots synchronously on the game thread\n")
+	TEXT("1: trace shots through the async trace API and resolve them on the next frame"),
+	ECVF_Default);
+
+EHitscanMode UHitscanSubsystem::GetMode()
+{
+	return CVarAsyncHitscan.GetValueOnGameThread() != 0 ? EHitscanMode::EHM_Asynchronous : EHitscanMode::EHM_Synchronous;
+}
+
+void UHitscanSubsystem::QueueShot(const FVector& MuzzleLocation, const FVector& CrosshairStart,
+	const FVector& CrosshairEnd, FOnShotResolved OnResolved, FOnCrosshairTraced OnCrosshairTraced)
+{
+	FHitscanShot Shot;
+	Shot.MuzzleLocation = MuzzleLocation;
+	Shot.CrosshairStart = CrosshairStart;
+	Shot.CrosshairEnd = CrosshairEnd;
+	Shot.OnResolved = MoveTemp(OnResolved);
+	Shot.OnCrosshairTraced = MoveTemp(OnCrosshairTraced);
+
+	if (GetMode() == EHitscanMode::EHM_Synchronous)
+	{
+		ResolveShotSync(Shot);
+		return;
+	}
+
+	const uint32 ShotId{NextShotId++};
+	PendingShots.Add(ShotId, MoveTemp(Shot));
+	TraceCrosshairAsync(ShotId);
+}
+
+void UHitscanSubsystem::QueueBarrelShot(const FVector& MuzzleLocation, const FVector& BeamTarget,
+	FOnShotResolved OnResolved)
+{
+	FHitscanShot Shot;
+	Shot.MuzzleLocation = MuzzleLocation;
+	Shot.CrosshairStart = MuzzleLocation;
+	Shot.CrosshairEnd = BeamTarget;
+	Shot.OnResolved = MoveTemp(OnResolved);
+
+	if (GetMode() == EHitscanMode::EHM_Synchronous)
+	{
+		ResolveBarrelSync(Shot, BeamTarget);
+		return;
+	}
+
+	const uint32 ShotId{NextShotId++};
+	PendingShots.Add(ShotId, MoveTemp(Shot));
+	TraceBarrelAsync(ShotId, BeamTarget);
+}
+
+void UHitscanSubsystem::TraceCrosshairAsync(uint32 ShotId)
+{
+	const FHitscanShot& Shot = PendingShots[ShotId];
+
+	FTraceDelegate TraceDelegate;
+	TraceDelegate.BindUObject(this, &UHitscanSubsystem::OnCrosshairTraceDone);
+	INC_DWORD_STAT(STAT_HitscanTraces);
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Shot.CrosshairStart, Shot.CrosshairEnd,
+		ECollisionChannel::ECC_Visibility, FCollisionQueryParams::DefaultQueryParam,
+		FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, ShotId);
+}
+
+void UHitscanSubsystem::TraceBarrelAsync(uint32 ShotId, const FVector& BeamTarget)
+{
+	const FHitscanShot& Shot = PendingShots[ShotId];
+
+	FTraceDelegate TraceDelegate;
+	TraceDelegate.BindUObject(this, &UHitscanSubsystem::OnBarrelTraceDone);
+	INC_DWORD_STAT(STAT_HitscanTraces);
+	GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Shot.MuzzleLocation,
+		GetBarrelTraceEnd(Shot.MuzzleLocation, BeamTarget), ECollisionChannel::ECC_Visibility,
+		FCollisionQueryParams::DefaultQueryParam, FCollisionResponseParams::DefaultResponseParam, &TraceDelegate, ShotId);
+}
+
+void UHitscanSubsystem::OnCrosshairTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FHitscanShot* Shot = PendingShots.Find(Datum.UserData);
+	if (!Shot) return;
+
+	// Beam target is the crosshair hit, or the end of the crosshair ray if nothing was hit
+	FHitResult CrosshairHitResult;
+	if (Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit)
+	{
+		CrosshairHitResult = Datum.OutHits[0];
+		Shot->CrosshairEnd = CrosshairHitResult.Location;
+	}
+	Shot->OnCrosshairTraced.ExecuteIfBound(CrosshairHitResult);
+
+	// The barrel trace stays off the game thread too, the shot resolves once it comes back
+	TraceBarrelAsync(Datum.UserData, Shot->CrosshairEnd);
+}
+
+void UHitscanSubsystem::OnBarrelTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+	FHitscanShot Shot;
+	if (!PendingShots.RemoveAndCopyValue(Datum.UserData, Shot)) return;
+
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_HitscanResolve, Weapons);
+
+	FHitResult BeamHitResult;
+	bool bBeamEnd{false};
+	if (Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit)
+	{
+		BeamHitResult = Datum.OutHits[0];
+		bBeamEnd = true;
+	}
+	else
+	{
+		// Nothing between the barrel and the beam end point
+		BeamHitResult.Location = Shot.CrosshairEnd;
+	}
+	Shot.OnResolved.ExecuteIfBound(BeamHitResult, bBeamEnd);
+}
+
+void UHitscanSubsystem::ResolveShotSync(FHitscanShot& Shot)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_HitscanResolve, Weapons);
+
+	// Check for crosshair trace hit
+	FHitResult CrosshairHitResult;
+	INC_DWORD_STAT(STAT_HitscanTraces);
+	GetWorld()->LineTraceSingleByChannel(CrosshairHitResult, Shot.CrosshairStart, Shot.CrosshairEnd,
+		ECollisionChannel::ECC_Visibility);
+	const FVector BeamTarget{CrosshairHitResult.bBlockingHit ? CrosshairHitResult.Location : Shot.CrosshairEnd};
+	Shot.OnCrosshairTraced.ExecuteIfBound(CrosshairHitResult);
+
+	ResolveBarrelSync(Shot, BeamTarget);
+}
+
+void UHitscanSubsystem::ResolveBarrelSync(FHitscanShot& Shot, const FVector& BeamTarget)
+{
+	// Perform a second trace, this time from the gun barrel
+	FHitResult BeamHitResult;
+	INC_DWORD_STAT(STAT_HitscanTraces);
+	GetWorld()->LineTraceSingleByChannel(BeamHitResult, Shot.MuzzleLocation,
+		GetBarrelTraceEnd(Shot.MuzzleLocation, BeamTarget), ECollisionChannel::ECC_Visibility);
+	const bool bBeamEnd{BeamHitResult.bBlockingHit};
+	if (!bBeamEnd)
+	{
+		BeamHitResult.Location = BeamTarget;
+	}
+	Shot.OnResolved.ExecuteIfBound(BeamHitResult, bBeamEnd);
+}
+
+FVector UHitscanSubsystem::GetBarrelTraceEnd(const FVector& MuzzleLocation, const FVector& BeamTarget)
+{
+	const FVector StartToEnd{BeamTarget - MuzzleLocation};
+	return BeamTarget + StartToEnd * 1.25f;
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "WorldCollision.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HitscanSubsystem.generated.h"
+
+UENUM(BlueprintType)
+enum class EHitscanMode : uint8
+{
+	EHM_Synchronous		UMETA(DisplayName = "Synchronous"),
+	EHM_Asynchronous	UMETA(DisplayName = "Asynchronous"),
+
+	EHM_MAX				UMETA(DisplayName = "DefaultMAX")
+};
+
+// Called once the beam trace of a shot is done. bBeamEnd is true when the barrel trace hit something
+DECLARE_DELEGATE_TwoParams(FOnShotResolved, const FHitResult& /*BeamHitResult*/, bool /*bBeamEnd*/);
+
+// Called with the crosshair trace of a shot, before its barrel trace
+DECLARE_DELEGATE_OneParam(FOnCrosshairTraced, const FHitResult& /*CrosshairHitResult*/);
+
+// A shot waiting for its traces to come back
+struct FHitscanShot
+{
+	// Location of the weapon's barrel socket
+	FVector MuzzleLocation;
+
+	// Crosshair ray in world space. The end becomes the beam target once the crosshair trace is done
+	FVector CrosshairStart;
+	FVector CrosshairEnd;
+
+	FOnShotResolved OnResolved;
+
+	FOnCrosshairTraced OnCrosshairTraced;
+};
+
+/**
+ * Resolves hitscan shots. In asynchronous mode the crosshair and barrel traces of a shot both go through
+ * the async trace API, one frame each, keeping them off the game thread. A shot queued with its crosshair
+ * trace already known resolves on the next frame.
+ */
+UCLASS()
+class SHOOTER_API UHitscanSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Queue a shot from the muzzle toward whatever is under the crosshair ray. OnCrosshairTraced lets the
+	// shooter keep the crosshair trace for other queries
+	void QueueShot(const FVector& MuzzleLocation, const FVector& CrosshairStart, const FVector& CrosshairEnd,
+		FOnShotResolved OnResolved, FOnCrosshairTraced OnCrosshairTraced = FOnCrosshairTraced());
+
+	// Queue a shot whose crosshair trace is already known, only the barrel trace is left
+	void QueueBarrelShot(const FVector& MuzzleLocation, const FVector& BeamTarget, FOnShotResolved OnResolved);
+
+	// Mode currently selected with Shooter.Hitscan.Async
+	static EHitscanMode GetMode();
+
+	FORCEINLINE int32 GetNumPendingShots() const { return PendingShots.Num(); }
+
+private:
+	void TraceCrosshairAsync(uint32 ShotId);
+	void TraceBarrelAsync(uint32 ShotId, const FVector& BeamTarget);
+
+	void OnCrosshairTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+	void OnBarrelTraceDone(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+	// Same traces as the async path, done immediately on the game thread
+	void ResolveShotSync(FHitscanShot& Shot);
+	void ResolveBarrelSync(FHitscanShot& Shot, const FVector& BeamTarget);
+
+	// Barrel trace end point, past the beam target so we don't stop short of the surface
+	static FVector GetBarrelTraceEnd(const FVector& MuzzleLocation, const FVector& BeamTarget);
+
+	// Shots waiting on an async trace, keyed by the id passed as trace user data
+	TMap<uint32, FHitscanShot> PendingShots;
+
+	uint32 NextShotId{1};
+};
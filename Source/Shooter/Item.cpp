@@ -3,7 +3,12 @@
 
 #include "Item.h"
 
+#include "ItemGlowSubsystem.h"
+#include "ItemSpatialSubsystem.h"
+#include "Shooter.h"
 #include "ShooterCharacter.h"
+#include "ShooterDataRegistry.h"
+#include "ShooterStats.h"
 #include "Camera/CameraComponent.h"
 #include "Components/BoxComponent.h"
 #include "Components/SphereComponent.h"
@@ -12,6 +17,15 @@
 #include "Kismet/GameplayStatics.h"
 #include "Sound/SoundCue.h"
 
+DECLARE_CYCLE_STAT(TEXT("Item Tick"), STAT_ItemTick, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Item Interp"), STAT_ItemInterp, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Item Update Pulse"), STAT_ItemUpdatePulse, STATGROUP_Shooter);
+
+// Custom primitive data layout used when bUseCustomPrimitiveGlow is set
+static constexpr int32 GlowDataIndex_Pulse{0};			// GlowAmount, FresnelExponent, FresnelReflectFraction
+static constexpr int32 GlowDataIndex_FresnelColor{3};	// RGB
+static constexpr int32 GlowDataIndex_GlowBlendAlpha{6};
+
 // Sets default values
 AItem::AItem():
 ItemName(FString("ItemName")),
@@ -35,8 +49,10 @@ PulseCurveTime(5.f),
 GlowAmount(150.f),
 FresnelExponent(3.f),
 FresnelReflectFraction(4.f),
+bUseCustomPrimitiveGlow(false),
 SlotIndex(0),
-bCharacterInventoryFull(false)
+bCharacterInventoryFull(false),
+RespawnTime(0.f)
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -49,9 +65,6 @@ bCharacterInventoryFull(false)
 	CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 
-	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
-	PickupWidget->SetupAttachment(RootComponent);
-
 	AreaSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AreaSphere"));
 	AreaSphere->SetupAttachment(RootComponent);
 }
@@ -60,8 +73,15 @@ bCharacterInventoryFull(false)
 void AItem::BeginPlay()
 {
 	Super::BeginPlay();
+
+	PickupTransform = GetActorTransform();
+	if (PickupId.IsNone() && IsNameStableForNetworking())
+	{
+		PickupId = GetFName();
+	}
 	
 	// Hide pickup widget
+	CreatePickupWidget();
 	if (PickupWidget)
 	{
 		PickupWidget->SetVisibility(false);
@@ -76,11 +96,30 @@ void AItem::BeginPlay()
 
 	// Set ItemProperties based on ItemState
 	SetItemProperties(ItemState);
+	UpdateSubsystemRegistration();
 
 	// Set custom depth to disabled
 	InitializeCustomDepth();
 
 	StartPulseTimer();
+
+	UpdateTickEnabled();
+}
+
+void AItem::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	UItemSpatialSubsystem* ItemSpatial = GetWorld()->GetSubsystem<UItemSpatialSubsystem>();
+	if (ItemSpatial)
+	{
+		ItemSpatial->UnregisterItem(this);
+	}
+	UItemGlowSubsystem* ItemGlow = GetWorld()->GetSubsystem<UItemGlowSubsystem>();
+	if (ItemGlow)
+	{
+		ItemGlow->UnregisterItem(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
@@ -112,11 +151,8 @@ void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor*
 
 void AItem::SetActiveStars()
 {
-	// 0 element isn't used
-	for (int32 i=0; i <=5; i++)
-	{
-		ActiveStars.Add(false);
-	}
+	// 0 element isn't used. Reset so pooled items can be set up again
+	ActiveStars.Init(false, 6);
 	
 	switch (ItemRarity) // Using fall-trough: Cases below the correct case also activated(?)
 	{
@@ -182,7 +218,10 @@ void AItem::SetItemProperties(EItemState State)
 		CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
 		break;
 	case EItemState::EIS_Equipped:
-		PickupWidget->SetVisibility(false);
+		if (PickupWidget)
+		{
+			PickupWidget->SetVisibility(false);
+		}
 		// Set ItemMesh properties
 		ItemMesh->SetSimulatePhysics(false);
 		ItemMesh->SetEnableGravity(false);
@@ -212,7 +251,10 @@ void AItem::SetItemProperties(EItemState State)
 		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		break;
 	case EItemState::EIS_EquipInterping:
-		PickupWidget->SetVisibility(false);
+		if (PickupWidget)
+		{
+			PickupWidget->SetVisibility(false);
+		}
 		// Set ItemMesh properties
 		ItemMesh->SetSimulatePhysics(false);
 		ItemMesh->SetEnableGravity(false);
@@ -227,7 +269,10 @@ void AItem::SetItemProperties(EItemState State)
 		CollisionBox->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		break;
 	case EItemState::EIS_PickedUp:
-		PickupWidget->SetVisibility(false);
+		if (PickupWidget)
+		{
+			PickupWidget->SetVisibility(false);
+		}
 		// Set mesh properties
 		ItemMesh->SetSimulatePhysics(false);
 		ItemMesh->SetEnableGravity(false);
@@ -247,13 +292,15 @@ void AItem::SetItemProperties(EItemState State)
 void AItem::FinishInterping()
 {
 	bInterping = false;
-	if (Character)
+	// Picking up ammo returns it to the pool, which clears Character
+	AShooterCharacter* PickupCharacter = Character;
+	if (PickupCharacter)
 	{
 		// Subtract 1 from the item count of the InterpLocation struct
-		Character->IncrementInterpLocItemCount(InterpLocIndex, -1);
-		Character->GetPickupItem(this);
+		PickupCharacter->IncrementInterpLocItemCount(InterpLocIndex, -1);
+		PickupCharacter->GetPickupItem(this);
 
-		Character->UnHighlightInventorySlot();
+		PickupCharacter->UnHighlightInventorySlot();
 	}
 	// Set scale back to normal
 	SetActorScale3D(FVector(1.f));
@@ -261,11 +308,13 @@ void AItem::FinishInterping()
 	bCanChangeCustomDepth = true;
 	DisableGlowMaterial();
 	DisableCustomDepth();
-	
+
+	UpdateTickEnabled();
 }
 
 void AItem::ItemInterp(float DeltaTime)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ItemInterp, Items);
 	if (!bInterping) return;
 
 	if (Character && ItemZCurve)
@@ -328,7 +377,7 @@ FVector AItem::GetInterpLocation()
 
 void AItem::PlayPickupSound(bool bForcePlaySound)
 {
-	if (Character)
+	if (Character && ShouldPlayCosmetics(this))
 	{
 		if (bForcePlaySound)
 		{
@@ -373,33 +422,49 @@ void AItem::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
-	// Load the date in the ItemRarityDataTable
+	ApplyRarity();
+	
+	if (bUseCustomPrimitiveGlow)
+	{
+		EnableGlowMaterial();
+	}
+	else if (MaterialInstance)
+	{
+		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
+		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GlowColor);
+		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
+		EnableGlowMaterial();
+	}
+}
+
+void AItem::CreatePickupWidget()
+{
+	if (!PickupWidgetClass || PickupWidget || !ShouldPlayCosmetics(this)) return;
+
+	PickupWidget = NewObject<UWidgetComponent>(this, TEXT("PickupWidget"));
+	PickupWidget->SetWidgetSpace(EWidgetSpace::Screen);
+	PickupWidget->SetDrawAtDesiredSize(true);
+	PickupWidget->SetWidgetClass(PickupWidgetClass);
+	PickupWidget->SetupAttachment(GetRootComponent());
+	PickupWidget->RegisterComponent();
+
+	// Where the shared prompt would be drawn
+	PickupWidget->SetWorldLocation(GetPickupPromptLocation());
+}
 
-	// Path to the ItemRarityDataTable
-	FString RarityTablePath{TEXT("DataTable'/Game/_Game/DataTables/ItemRarityDataTable.ItemRarityDataTable'")};
-	UDataTable* RarityTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *RarityTablePath));
-	if (RarityTableObject)
+FVector AItem::GetPickupPromptLocation() const
+{
+	const FBoxSphereBounds& Bounds = CollisionBox->Bounds;
+	return Bounds.Origin + FVector(0.f, 0.f, Bounds.BoxExtent.Z);
+}
+
+void AItem::ApplyRarity()
+{
+	// Rarity data, cached by the registry
+	UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
+	if (DataRegistry)
 	{
-		FItemRarityTable* RarityRow = nullptr;
-		switch (ItemRarity)
-		{
-		case EItemRarity::EIR_Damaged:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Damaged"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Common:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Common"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Uncommon:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Uncommon"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Rare:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Rare"), TEXT(""));
-			break;
-		case EItemRarity::EIR_Legendary:
-			RarityRow = RarityTableObject->FindRow<FItemRarityTable>(FName("Legendary"), TEXT(""));
-			break;
-		}
-		
+		const FItemRarityTable* RarityRow = DataRegistry->GetRarityRow(ItemRarity);
 		if (RarityRow)
 		{
 			GlowColor = RarityRow->GlowColor;
@@ -410,19 +475,64 @@ void AItem::OnConstruction(const FTransform& Transform)
 			GetItemMesh()->SetCustomDepthStencilValue(RarityRow->CustomDepthStencil);
 		}
 	}
-	
-	if (MaterialInstance)
+
+	if (bUseCustomPrimitiveGlow)
+	{
+		ItemMesh->SetCustomPrimitiveDataVector3(GlowDataIndex_FresnelColor, FVector(GlowColor));
+	}
+	else if (DynamicMaterialInstance)
 	{
-		DynamicMaterialInstance = UMaterialInstanceDynamic::Create(MaterialInstance, this);
 		DynamicMaterialInstance->SetVectorParameterValue(TEXT("FresnelColor"), GlowColor);
-		ItemMesh->SetMaterial(MaterialIndex, DynamicMaterialInstance);
-		EnableGlowMaterial();
 	}
 }
 
+void AItem::ResetForPool()
+{
+	GetWorldTimerManager().ClearAllTimersForObject(this);
+	Character = nullptr;
+	bInterping = false;
+	bCharacterInventoryFull = false;
+	bCanChangeCustomDepth = true;
+
+	// Back to the class defaults
+	const AItem* DefaultItem = GetClass()->GetDefaultObject<AItem>();
+	ItemCount = DefaultItem->ItemCount;
+	ItemRarity = DefaultItem->ItemRarity;
+	RespawnTime = DefaultItem->RespawnTime;
+	ApplyRarity();
+	SetActiveStars();
+
+	SetItemState(EItemState::EIS_PickedUp);
+	DisableGlowMaterial();
+	DisableCustomDepth();
+	SetActorScale3D(FVector(1.f));
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	// Out of the pickup lookup by now, the next pickup is named when it's acquired
+	PickupId = NAME_None;
+}
+
+void AItem::ActivateFromPool(const FTransform& Transform, FName InPickupId)
+{
+	SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	PickupTransform = Transform;
+	PickupId = InPickupId;
+
+	SetItemState(EItemState::EIS_Pickup);
+	EnableGlowMaterial();
+	StartPulseTimer();
+}
+
 void AItem::EnableGlowMaterial()
 {
-	if (DynamicMaterialInstance)
+	if (bUseCustomPrimitiveGlow)
+	{
+		ItemMesh->SetCustomPrimitiveDataFloat(GlowDataIndex_GlowBlendAlpha, 0.f);
+	}
+	else if (DynamicMaterialInstance)
 	{
 		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 0.0);
 	}
@@ -430,26 +540,45 @@ void AItem::EnableGlowMaterial()
 
 void AItem::UpdatePulse()
 {
-	float ElapsedTime{};
-	FVector CurveValue{};
-	switch (ItemState)
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ItemUpdatePulse, Items);
+
+	if (!ShouldPlayCosmetics(this)) return;
+
+	// Idle pickups are pulsed by UItemGlowSubsystem, unless it's turned off
+	if (ItemState == EItemState::EIS_Pickup)
 	{
-	case EItemState::EIS_Pickup:
-		if (PulseCurve)
-		{
-			ElapsedTime = GetWorldTimerManager().GetTimerElapsed(PulseTimer);
-			CurveValue = PulseCurve->GetVectorValue(ElapsedTime);
-		}
-		break;
-	case EItemState::EIS_EquipInterping:
-		if (InterpPulseCurve)
+		if (!UItemGlowSubsystem::IsEnabled())
 		{
-			ElapsedTime = GetWorldTimerManager().GetTimerElapsed(ItemInterpTimer);
-			CurveValue = InterpPulseCurve->GetVectorValue(ElapsedTime);
+			ApplyPulse(EvaluatePickupPulse());
 		}
-		break;
+		return;
+	}
+
+	FVector CurveValue{};
+	if (ItemState == EItemState::EIS_EquipInterping && InterpPulseCurve)
+	{
+		const float ElapsedTime{GetWorldTimerManager().GetTimerElapsed(ItemInterpTimer)};
+		CurveValue = InterpPulseCurve->GetVectorValue(ElapsedTime);
+	}
+	ApplyPulse(CurveValue);
+}
+
+FVector AItem::EvaluatePickupPulse() const
+{
+	if (!PulseCurve) return FVector::ZeroVector;
+
+	const float ElapsedTime{GetWorldTimerManager().GetTimerElapsed(PulseTimer)};
+	return PulseCurve->GetVectorValue(ElapsedTime);
+}
+
+void AItem::ApplyPulse(const FVector& CurveValue)
+{
+	if (bUseCustomPrimitiveGlow)
+	{
+		ItemMesh->SetCustomPrimitiveDataVector3(GlowDataIndex_Pulse,
+			FVector(CurveValue.X * GlowAmount, CurveValue.Y * FresnelExponent, CurveValue.Z * FresnelReflectFraction));
 	}
-	if (DynamicMaterialInstance)
+	else if (DynamicMaterialInstance)
 	{
 		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowAmount"), CurveValue.X * GlowAmount);
 		DynamicMaterialInstance->SetScalarParameterValue(TEXT("FresnelExponent"), CurveValue.Y * FresnelExponent);
@@ -459,7 +588,11 @@ void AItem::UpdatePulse()
 
 void AItem::DisableGlowMaterial()
 {
-	if (DynamicMaterialInstance)
+	if (bUseCustomPrimitiveGlow)
+	{
+		ItemMesh->SetCustomPrimitiveDataFloat(GlowDataIndex_GlowBlendAlpha, 1.f);
+	}
+	else if (DynamicMaterialInstance)
 	{
 		DynamicMaterialInstance->SetScalarParameterValue(TEXT("GlowBlendAlpha"), 1);
 	}
@@ -467,7 +600,7 @@ void AItem::DisableGlowMaterial()
 
 void AItem::PlayEquipSound(bool bForcePlaySound)
 {
-	if (Character)
+	if (Character && ShouldPlayCosmetics(this))
 	{
 		if (bForcePlaySound)
 		{
@@ -490,6 +623,7 @@ void AItem::PlayEquipSound(bool bForcePlaySound)
 // Called every frame
 void AItem::Tick(float DeltaTime)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ItemTick, Items);
 	Super::Tick(DeltaTime);
 
 	// Handle item interpolation when in the EquipInterping state
@@ -517,6 +651,55 @@ void AItem::SetItemState(EItemState State)
 {
 	ItemState = State;
 	SetItemProperties(State);
+	UpdateSubsystemRegistration();
+	UpdateTickEnabled();
+}
+
+void AItem::UpdateSubsystemRegistration()
+{
+	UWorld* World = GetWorld();
+	if (!World) return;
+
+	const bool bPickup{ItemState == EItemState::EIS_Pickup};
+	UItemSpatialSubsystem* ItemSpatial = World->GetSubsystem<UItemSpatialSubsystem>();
+	if (ItemSpatial)
+	{
+		if (bPickup)
+		{
+			ItemSpatial->RegisterItem(this);
+		}
+		else
+		{
+			ItemSpatial->UnregisterItem(this);
+		}
+	}
+
+	// Only items with a glow material need pulsing
+	UItemGlowSubsystem* ItemGlow = World->GetSubsystem<UItemGlowSubsystem>();
+	if (ItemGlow)
+	{
+		if (bPickup && (bUseCustomPrimitiveGlow || DynamicMaterialInstance) && UItemGlowSubsystem::IsEnabled())
+		{
+			ItemGlow->RegisterItem(this);
+		}
+		else
+		{
+			ItemGlow->UnregisterItem(this);
+		}
+	}
+}
+
+bool AItem::ShouldTickItem() const
+{
+	// Without the glow subsystem every item ticks, idle or not
+	if (!UItemGlowSubsystem::IsEnabled()) return true;
+
+	return bInterping || ItemState == EItemState::EIS_Falling;
+}
+
+void AItem::UpdateTickEnabled()
+{
+	SetActorTickEnabled(ShouldTickItem());
 }
 
 void AItem::StartItemCurve(AShooterCharacter* Char, bool bForcePlaySound)
@@ -76,6 +76,8 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Called when overlapping AreaSphere
 	UFUNCTION()
 	void OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
@@ -89,9 +91,19 @@ protected:
 	// Sets the ActiveStars array of bools based on item rarity
 	void SetActiveStars();
 
+	// Creates PickupWidget for items that opt in with a PickupWidgetClass
+	void CreatePickupWidget();
+
 	// Sets properties of the item's components based on state
 	virtual void SetItemProperties(EItemState State);
 
+	// Keeps the item in the world's item grid and glow driver while it can be picked up
+	void UpdateSubsystemRegistration();
+
+	// Only interpolating or falling items need to tick
+	virtual bool ShouldTickItem() const;
+	void UpdateTickEnabled();
+
 	// Called when ItemInterpTimer is finished
 	void FinishInterping();
 
@@ -109,11 +121,20 @@ protected:
 
 	void EnableGlowMaterial();
 
+	// Sets the rarity colors, stencil and glow color from the rarity data
+	void ApplyRarity();
+
 	void StartPulseTimer();
 	void ResetPulseTimer();
 	void UpdatePulse();
 
 public:	
+	// Pulse curve value for an idle pickup at the current time
+	FVector EvaluatePickupPulse() const;
+
+	// Pushes a pulse curve value to the glow material
+	void ApplyPulse(const FVector& CurveValue);
+
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
@@ -124,6 +145,12 @@ public:
 	virtual void DisableCustomDepth();
 	void DisableGlowMaterial();
 
+	// Called by UItemPoolSubsystem. Resets the item to its class defaults and hides it
+	virtual void ResetForPool();
+
+	// Called by UItemPoolSubsystem. Places the item in the world as a pickup
+	virtual void ActivateFromPool(const FTransform& Transform, FName InPickupId);
+
 private:
 	// Skeletal mesh for the item
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
@@ -133,14 +160,31 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
 	class UBoxComponent* CollisionBox;
 
-	// Pop-up widget when the player looks at the item
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
+	// Pop-up widget when the player looks at the item, only created for items with a PickupWidgetClass
+	UPROPERTY(VisibleInstanceOnly, Transient, BlueprintReadOnly, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
 	class UWidgetComponent* PickupWidget;
 
+	// Widget shown over this item instead of the player controller's shared pickup prompt. Each one is a
+	// ticking component and a widget per item, so leave it unset unless the item needs its own
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<class UUserWidget> PickupWidgetClass;
+
 	// Enables item tracing when overlapped
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
 	class USphereComponent* AreaSphere;
 
+	// Time after being picked up until the item pool puts it back where it was, 0 for never
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = ItemProperties, meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	float RespawnTime;
+
+	// Where the item was placed or dropped as a pickup, it respawns here
+	FTransform PickupTransform;
+
+	// Names the pickup the same on the server and every client, since items aren't replicated. Items placed
+	// in the level use their own name, respawns take the name of the item picked up. None for items only
+	// one machine spawned
+	FName PickupId;
+
 	// The name which appears on the PickupWidget
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
 	FString ItemName;
@@ -251,6 +295,11 @@ private:
 	UPROPERTY(VisibleAnywhere, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
 	float FresnelReflectFraction;
 
+	// Write the glow parameters to the mesh's custom primitive data instead of the dynamic material.
+	// Needs a material that reads them from custom primitive data
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = ItemProperties, meta = (AllowPrivateAccess = "true"))
+	bool bUseCustomPrimitiveGlow;
+
 	// The icon for this item in the inventory
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	UTexture2D* IconItem;
@@ -295,6 +344,9 @@ public:
 
 	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return PickupWidget; }
 
+	// Only takes effect before BeginPlay
+	FORCEINLINE void SetPickupWidgetClass(TSubclassOf<UUserWidget> WidgetClass) { PickupWidgetClass = WidgetClass; }
+
 	FORCEINLINE USphereComponent* GetAreaSphere() const { return AreaSphere; }
 
 	FORCEINLINE UBoxComponent* GetCollisionBox() const { return CollisionBox; }
@@ -318,6 +370,27 @@ public:
 
 	FORCEINLINE int32 GetItemCount() const { return ItemCount; }
 
+	FORCEINLINE const FString& GetItemName() const { return ItemName; }
+
+	FORCEINLINE const TArray<bool>& GetActiveStars() const { return ActiveStars; }
+
+	FORCEINLINE FLinearColor GetLightColor() const { return LightColor; }
+
+	FORCEINLINE FLinearColor GetDarkColor() const { return DarkColor; }
+
+	FORCEINLINE bool GetCharacterInventoryFull() const { return bCharacterInventoryFull; }
+
+	// World location the shared pickup prompt is drawn at, the top of the collision box
+	FVector GetPickupPromptLocation() const;
+
+	FORCEINLINE float GetRespawnTime() const { return RespawnTime; }
+
+	FORCEINLINE void SetRespawnTime(float Time) { RespawnTime = Time; }
+
+	FORCEINLINE const FTransform& GetPickupTransform() const { return PickupTransform; }
+
+	FORCEINLINE FName GetPickupId() const { return PickupId; }
+
 	FORCEINLINE void SetItemType(EItemType Type) { ItemType = Type; }
 
 	FORCEINLINE int32 GetSlotIndex() const { return SlotIndex; }
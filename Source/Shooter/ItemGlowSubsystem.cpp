@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemGlowSubsystem.h"
+
+#include "Item.h"
+#include "Shooter.h"
+#include "ShooterStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item Glow Tick"), STAT_ItemGlowTick, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Glowing Items"), STAT_GlowingItems, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Pulses Updated"), STAT_ItemPulsesUpdated, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Pulses Skipped"), STAT_ItemPulsesSkipped, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarItemGlowSubsystem(
+	TEXT("Shooter.Items.GlowSubsystem"),
+	1,
+	TEXT("0: every item ticks and pulses its own glow, seen or not. Applies to items spawned afterwards\n")
+	TEXT("1: the glow subsystem pulses idle pickups that were recently rendered"),
+	ECVF_Default);
+
+bool UItemGlowSubsystem::IsEnabled()
+{
+	return CVarItemGlowSubsystem.GetValueOnGameThread() != 0;
+}
+
+void UItemGlowSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_GlowingItems, Items.Num());
+	Items.Empty();
+
+	Super::Deinitialize();
+}
+
+void UItemGlowSubsystem::Tick(float DeltaTime)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ItemGlowTick, Items);
+
+	for (AItem* Item : Items)
+	{
+		if (!Item) continue;
+
+		// Nobody can see the pulse, leave the material alone
+		const USkeletalMeshComponent* ItemMesh = Item->GetItemMesh();
+		if (!ItemMesh || !ItemMesh->WasRecentlyRendered(RecentlyRenderedTime))
+		{
+			INC_DWORD_STAT(STAT_ItemPulsesSkipped);
+			continue;
+		}
+
+		Item->ApplyPulse(Item->EvaluatePickupPulse());
+		INC_DWORD_STAT(STAT_ItemPulsesUpdated);
+	}
+}
+
+bool UItemGlowSubsystem::IsTickable() const
+{
+	return Items.Num() > 0 && !IsTemplate();
+}
+
+TStatId UItemGlowSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UItemGlowSubsystem, STATGROUP_Tickables);
+}
+
+void UItemGlowSubsystem::RegisterItem(AItem* Item)
+{
+	// Without anyone to see the pulse there's nothing to tick
+	if (!Item || !ShouldPlayCosmetics(this)) return;
+
+	bool bAlreadyRegistered{false};
+	Items.Add(Item, &bAlreadyRegistered);
+	if (!bAlreadyRegistered)
+	{
+		INC_DWORD_STAT(STAT_GlowingItems);
+	}
+}
+
+void UItemGlowSubsystem::UnregisterItem(AItem* Item)
+{
+	if (Items.Remove(Item) > 0)
+	{
+		DEC_DWORD_STAT(STAT_GlowingItems);
+	}
+}
@@ -0,0 +1,46 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemGlowSubsystem.generated.h"
+
+class AItem;
+
+/**
+ * Drives the pulsing glow of every item waiting to be picked up from a single tick,
+ * so idle pickups don't need an actor tick of their own.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UItemGlowSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterItem(AItem* Item);
+	void UnregisterItem(AItem* Item);
+
+	FORCEINLINE int32 GetNumItems() const { return Items.Num(); }
+
+	// False when Shooter.Items.GlowSubsystem has every pickup tick and pulse itself instead
+	static bool IsEnabled();
+
+private:
+	// Items currently pulsing
+	UPROPERTY()
+	TSet<AItem*> Items;
+
+	// Items that haven't been rendered for this long are skipped
+	UPROPERTY(config)
+	float RecentlyRenderedTime{0.2f};
+};
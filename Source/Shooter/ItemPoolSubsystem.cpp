@@ -0,0 +1,153 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemPoolSubsystem.h"
+
+#include "Item.h"
+#include "ShooterStats.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Items Spawned"), STAT_PooledItemsSpawned, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Pooled Items Free"), STAT_PooledItemsFree, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Pool Reuses"), STAT_ItemPoolReuses, STATGROUP_Shooter);
+
+void UItemPoolSubsystem::Deinitialize()
+{
+	// The actors go away with the world
+	for (const auto& PoolPair : Pools)
+	{
+		DEC_DWORD_STAT_BY(STAT_PooledItemsFree, PoolPair.Value.Free.Num());
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+AItem* UItemPoolSubsystem::AcquireItem(TSubclassOf<AItem> ItemClass, const FTransform& Transform, FName PickupId)
+{
+	if (!ItemClass) return nullptr;
+
+	AItem* Item{nullptr};
+	FItemPool* Pool = Pools.Find(ItemClass.Get());
+	while (Pool && Pool->Free.Num() > 0 && !Item)
+	{
+		// Skip anything destroyed while it was in the pool
+		Item = Pool->Free.Pop(false);
+		DEC_DWORD_STAT(STAT_PooledItemsFree);
+		if (IsValid(Item))
+		{
+			INC_DWORD_STAT(STAT_ItemPoolReuses);
+		}
+		else
+		{
+			Item = nullptr;
+		}
+	}
+	if (!Item)
+	{
+		Item = SpawnItem(ItemClass);
+	}
+	if (!Item) return nullptr;
+
+	Item->ActivateFromPool(Transform, PickupId);
+	return Item;
+}
+
+void UItemPoolSubsystem::ReleaseItem(AItem* Item)
+{
+	if (!IsValid(Item)) return;
+
+	FItemPool& Pool = Pools.FindOrAdd(Item->GetClass());
+	if (Pool.Free.Contains(Item)) return;
+
+	const float RespawnTime{Item->GetRespawnTime()};
+	if (RespawnTime > 0.f)
+	{
+		FTimerHandle RespawnTimer;
+		GetWorld()->GetTimerManager().SetTimer(RespawnTimer, FTimerDelegate::CreateUObject(this,
+			&UItemPoolSubsystem::RespawnItem, TSubclassOf<AItem>(Item->GetClass()), Item->GetPickupTransform(),
+			RespawnTime, Item->GetPickupId()), RespawnTime, false);
+	}
+
+	Item->ResetForPool();
+	Pool.Free.Add(Item);
+	INC_DWORD_STAT(STAT_PooledItemsFree);
+}
+
+void UItemPoolSubsystem::PrewarmPool(TSubclassOf<AItem> ItemClass, int32 Count)
+{
+	if (!ItemClass) return;
+
+	FItemPool& Pool = Pools.FindOrAdd(ItemClass.Get());
+	while (Pool.Free.Num() < Count)
+	{
+		AItem* Item = SpawnItem(ItemClass);
+		if (!Item) break;
+
+		Item->ResetForPool();
+		Pool.Free.Add(Item);
+		INC_DWORD_STAT(STAT_PooledItemsFree);
+	}
+}
+
+int32 UItemPoolSubsystem::GetNumFreeItems(TSubclassOf<AItem> ItemClass) const
+{
+	const FItemPool* Pool = Pools.Find(ItemClass.Get());
+	return Pool ? Pool->Free.Num() : 0;
+}
+
+void UItemPoolSubsystem::ReleaseOrDestroy(AItem* Item)
+{
+	if (!Item) return;
+
+	UItemPoolSubsystem* ItemPool = Item->GetWorld() ? Item->GetWorld()->GetSubsystem<UItemPoolSubsystem>() : nullptr;
+	if (ItemPool)
+	{
+		ItemPool->ReleaseItem(Item);
+	}
+	else
+	{
+		Item->Destroy();
+	}
+}
+
+AItem* UItemPoolSubsystem::AcquireOrSpawn(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass,
+	const FTransform& Transform)
+{
+	UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	if (!World || !ItemClass) return nullptr;
+
+	UItemPoolSubsystem* ItemPool = World->GetSubsystem<UItemPoolSubsystem>();
+	if (ItemPool)
+	{
+		return ItemPool->AcquireItem(ItemClass, Transform);
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AItem>(ItemClass, Transform, SpawnParams);
+}
+
+void UItemPoolSubsystem::RespawnItem(TSubclassOf<AItem> ItemClass, FTransform Transform, float RespawnTime,
+	FName PickupId)
+{
+	// Whichever pooled item comes back takes over the respawn time and name of the one that was picked up
+	AItem* Item = AcquireItem(ItemClass, Transform, PickupId);
+	if (Item)
+	{
+		Item->SetRespawnTime(RespawnTime);
+	}
+}
+
+AItem* UItemPoolSubsystem::SpawnItem(TSubclassOf<AItem> ItemClass)
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AItem* Item = GetWorld()->SpawnActor<AItem>(ItemClass, FTransform::Identity, SpawnParams);
+	if (Item)
+	{
+		INC_DWORD_STAT(STAT_PooledItemsSpawned);
+	}
+	return Item;
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemPoolSubsystem.generated.h"
+
+class AItem;
+
+// Hidden items of a single class, ready to be reused
+USTRUCT()
+struct FItemPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AItem*> Free;
+};
+
+/**
+ * Keeps released items hidden in the world and hands them out again, instead of destroying
+ * picked up items and spawning new ones.
+ */
+UCLASS()
+class SHOOTER_API UItemPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Takes an item of this class from the pool, or spawns one if the pool is empty. The item starts as a pickup,
+	// named PickupId if the other machines acquire the same one
+	AItem* AcquireItem(TSubclassOf<AItem> ItemClass, const FTransform& Transform, FName PickupId = NAME_None);
+
+	template<class T>
+	T* AcquireItem(TSubclassOf<T> ItemClass, const FTransform& Transform, FName PickupId = NAME_None)
+	{
+		return Cast<T>(AcquireItem(TSubclassOf<AItem>(ItemClass.Get()), Transform, PickupId));
+	}
+
+	// Resets and hides the item until it's acquired again. Items with a respawn time are acquired back at
+	// their pickup transform once it's up
+	void ReleaseItem(AItem* Item);
+
+	// Spawns hidden items until the pool for this class holds Count of them
+	void PrewarmPool(TSubclassOf<AItem> ItemClass, int32 Count);
+
+	int32 GetNumFreeItems(TSubclassOf<AItem> ItemClass) const;
+
+	// Releases to the item's world pool, or destroys the item if there is none
+	static void ReleaseOrDestroy(AItem* Item);
+
+	// Drops an item of this class at the location through the pool, e.g. enemy loot
+	static AItem* AcquireOrSpawn(const UObject* WorldContextObject, TSubclassOf<AItem> ItemClass,
+		const FTransform& Transform);
+
+private:
+	AItem* SpawnItem(TSubclassOf<AItem> ItemClass);
+
+	void RespawnItem(TSubclassOf<AItem> ItemClass, FTransform Transform, float RespawnTime, FName PickupId);
+
+	UPROPERTY()
+	TMap<UClass*, FItemPool> Pools;
+};
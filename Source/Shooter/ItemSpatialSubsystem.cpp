@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemSpatialSubsystem.h"
+
+#include "Item.h"
+#include "ShooterStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Item View Query"), STAT_ItemViewQuery, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Item Line Of Sight Traces"), STAT_ItemLineOfSightTraces, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Items In Spatial Grid"), STAT_ItemsInSpatialGrid, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarItemSpatialQuery(
+	TEXT("Shooter.Items.SpatialQuery"),
+	1,
+	TEXT("0: find the item under the crosshairs with a visibility trace\n")
+	TEXT("1: find it with a view cone query against the item grid"),
+	ECVF_Default);
+
+bool UItemSpatialSubsystem::IsQueryEnabled()
+{
+	return CVarItemSpatialQuery.GetValueOnGameThread() != 0;
+}
+
+void UItemSpatialSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_ItemsInSpatialGrid, ItemCells.Num());
+	Cells.Empty();
+	ItemCells.Empty();
+	PickupIds.Empty();
+
+	Super::Deinitialize();
+}
+
+void UItemSpatialSubsystem::RegisterItem(AItem* Item)
+{
+	if (!Item) return;
+
+	// Moving an item that's already registered
+	UnregisterItem(Item);
+
+	FItemSpatialEntry Entry;
+	Entry.Item = Item;
+	Entry.Location = GetItemLocation(Item);
+
+	const FIntVector Cell{GetCell(Entry.Location)};
+	Cells.FindOrAdd(Cell).Add(Entry);
+	ItemCells.Add(Item, Cell);
+	INC_DWORD_STAT(STAT_ItemsInSpatialGrid);
+
+	if (!Item->GetPickupId().IsNone())
+	{
+		PickupIds.Add(Item->GetPickupId(), Item);
+	}
+}
+
+void UItemSpatialSubsystem::UnregisterItem(AItem* Item)
+{
+	FIntVector Cell;
+	if (!ItemCells.RemoveAndCopyValue(Item, Cell)) return;
+	DEC_DWORD_STAT(STAT_ItemsInSpatialGrid);
+
+	// Unless another item has taken the ID over since
+	const FName PickupId{Item->GetPickupId()};
+	if (!PickupId.IsNone() && PickupIds.FindRef(PickupId).Get() == Item)
+	{
+		PickupIds.Remove(PickupId);
+	}
+
+	TArray<FItemSpatialEntry>* CellItems = Cells.Find(Cell);
+	if (!CellItems) return;
+
+	CellItems->RemoveAllSwap([Item](const FItemSpatialEntry& Entry) { return Entry.Item.Get() == Item; });
+	if (CellItems->Num() == 0)
+	{
+		Cells.Remove(Cell);
+	}
+}
+
+AItem* UItemSpatialSubsystem::FindBestItemInView(const FVector& Origin, const FVector& Direction, float MaxRange,
+	float MaxAngleDegrees) const
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ItemViewQuery, Items);
+
+	const FVector ViewDirection{Direction.GetSafeNormal()};
+	const float MinDot{FMath::Cos(FMath::DegreesToRadians(MaxAngleDegrees))};
+	const float MaxRangeSquared{MaxRange * MaxRange};
+
+	const FIntVector MinCell{GetCell(Origin - FVector(MaxRange))};
+	const FIntVector MaxCell{GetCell(Origin + FVector(MaxRange))};
+
+	AItem* BestItem{nullptr};
+	float BestDot{MinDot};
+	float BestDistanceSquared{MaxRangeSquared};
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<FItemSpatialEntry>* CellItems = Cells.Find(FIntVector(X, Y, Z));
+				if (!CellItems) continue;
+
+				for (const FItemSpatialEntry& Entry : *CellItems)
+				{
+					const FVector ToItem{Entry.Location - Origin};
+					const float DistanceSquared{ToItem.SizeSquared()};
+					if (DistanceSquared > MaxRangeSquared || DistanceSquared < KINDA_SMALL_NUMBER) continue;
+
+					const float Dot{FVector::DotProduct(ToItem * FMath::InvSqrt(DistanceSquared), ViewDirection)};
+					if (Dot < MinDot) continue;
+
+					// Prefer the item nearest the crosshairs, then the closer one
+					const bool bBetter{Dot > BestDot + KINDA_SMALL_NUMBER ||
+						(FMath::IsNearlyEqual(Dot, BestDot) && DistanceSquared < BestDistanceSquared)};
+					if (bBetter && Entry.Item.IsValid())
+					{
+						BestItem = Entry.Item.Get();
+						BestDot = Dot;
+						BestDistanceSquared = DistanceSquared;
+					}
+				}
+			}
+		}
+	}
+	return BestItem;
+}
+
+AItem* UItemSpatialSubsystem::FindItemByPickupId(FName PickupId) const
+{
+	return PickupId.IsNone() ? nullptr : PickupIds.FindRef(PickupId).Get();
+}
+
+bool UItemSpatialSubsystem::HasLineOfSight(const FVector& Origin, const AItem* Item, const AActor* IgnoredActor) const
+{
+	if (!Item) return false;
+
+	INC_DWORD_STAT(STAT_ItemLineOfSightTraces);
+	FCollisionQueryParams QueryParams{SCENE_QUERY_STAT(ItemLineOfSight)};
+	QueryParams.AddIgnoredActor(IgnoredActor);
+	FHitResult HitResult;
+	GetWorld()->LineTraceSingleByChannel(HitResult, Origin, GetItemLocation(Item), ECollisionChannel::ECC_Visibility,
+		QueryParams);
+	return !HitResult.bBlockingHit || HitResult.GetActor() == Item;
+}
+
+FVector UItemSpatialSubsystem::GetItemLocation(const AItem* Item)
+{
+	return Item->GetItemMesh() ? Item->GetItemMesh()->Bounds.Origin : Item->GetActorLocation();
+}
+
+FIntVector UItemSpatialSubsystem::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
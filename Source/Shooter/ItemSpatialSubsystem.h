@@ -0,0 +1,69 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemSpatialSubsystem.generated.h"
+
+class AItem;
+
+// An item in the grid, with the location it was registered at
+struct FItemSpatialEntry
+{
+	TWeakObjectPtr<AItem> Item;
+	FVector Location;
+};
+
+/**
+ * Uniform grid of every item that can be picked up. Lets the character find the item it's looking at
+ * without tracing against the world every frame.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UItemSpatialSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Adds the item at its current location, or moves it if it's already in the grid
+	void RegisterItem(AItem* Item);
+	void UnregisterItem(AItem* Item);
+
+	/**
+	 * Best item within MaxRange of Origin and within MaxAngleDegrees of Direction.
+	 * Items closest to the center of the view cone win, distance breaks ties
+	 */
+	AItem* FindBestItemInView(const FVector& Origin, const FVector& Direction, float MaxRange, float MaxAngleDegrees) const;
+
+	// One visibility trace from Origin to the item. The view query doesn't know about walls, run this on its result
+	bool HasLineOfSight(const FVector& Origin, const AItem* Item, const AActor* IgnoredActor = nullptr) const;
+
+	// False when Shooter.Items.SpatialQuery selects the crosshair trace instead
+	static bool IsQueryEnabled();
+
+	FORCEINLINE int32 GetNumItems() const { return ItemCells.Num(); }
+
+	// The item with this pickup ID, if it can be picked up. Resolves the items clients pick up on the server
+	AItem* FindItemByPickupId(FName PickupId) const;
+
+private:
+	FIntVector GetCell(const FVector& Location) const;
+
+	// Where the item is in the grid, the center of its mesh
+	static FVector GetItemLocation(const AItem* Item);
+
+	// Items in each occupied cell
+	TMap<FIntVector, TArray<FItemSpatialEntry>> Cells;
+
+	// Cell each registered item is in
+	TMap<TObjectKey<AItem>, FIntVector> ItemCells;
+
+	// Registered items that have a pickup ID
+	TMap<FName, TWeakObjectPtr<AItem>> PickupIds;
+
+	// Edge length of a grid cell
+	UPROPERTY(config)
+	float CellSize{500.f};
+};
@@ -0,0 +1,242 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LagCompensationSubsystem.h"
+
+#include "Shooter.h"
+#include "ShooterStats.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Character.h"
+
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Record"), STAT_LagCompensationRecord, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Rewind"), STAT_LagCompensationRewind, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Lag Compensation Bone"), STAT_LagCompensationBone, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Lag Compensated Characters"), STAT_LagCompensatedCharacters, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shots Confirmed"), STAT_ShotsConfirmed, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Shots Rejected"), STAT_ShotsRejected, STATGROUP_Shooter);
+DECLARE_MEMORY_STAT(TEXT("Lag Compensation History"), STAT_LagCompensationMemory, STATGROUP_Shooter);
+
+void ULagCompensationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Interpolating needs two frames
+	HistoryLength = FMath::Max(HistoryLength, 2);
+	MaxCharacters = FMath::Max(MaxCharacters, 1);
+}
+
+void ULagCompensationSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_LagCompensatedCharacters, Slots.Num());
+	DEC_MEMORY_STAT_BY(STAT_LagCompensationMemory, Locations.GetAllocatedSize() + FrameTimes.GetAllocatedSize());
+	Characters.Empty();
+	Slots.Empty();
+	FreeSlots.Empty();
+	Locations.Empty();
+	FrameTimes.Empty();
+
+	Super::Deinitialize();
+}
+
+void ULagCompensationSubsystem::Tick(float DeltaTime)
+{
+	RecordFrame();
+}
+
+bool ULagCompensationSubsystem::IsTickable() const
+{
+	return Slots.Num() > 0 && !IsTemplate();
+}
+
+TStatId ULagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULagCompensationSubsystem, STATGROUP_Tickables);
+}
+
+void ULagCompensationSubsystem::RegisterCharacter(ACharacter* Character)
+{
+	if (!Character || Slots.Contains(Character)) return;
+
+	// Clients and standalone games resolve shots themselves
+	const ENetMode NetMode{GetWorld()->GetNetMode()};
+	if (NetMode != NM_DedicatedServer && NetMode != NM_ListenServer) return;
+
+	if (Locations.Num() == 0)
+	{
+		// The whole history is allocated once, recording only overwrites it
+		Characters.SetNumZeroed(MaxCharacters);
+		Locations.SetNumZeroed(HistoryLength * MaxCharacters);
+		FrameTimes.SetNumZeroed(HistoryLength);
+		FreeSlots.Reserve(MaxCharacters);
+		for (int32 Slot = MaxCharacters - 1; Slot >= 0; --Slot)
+		{
+			FreeSlots.Add(Slot);
+		}
+		INC_MEMORY_STAT_BY(STAT_LagCompensationMemory, Locations.GetAllocatedSize() + FrameTimes.GetAllocatedSize());
+	}
+
+	if (FreeSlots.Num() == 0)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Lag compensation is full, shots at %s won't be rewound"), *Character->GetName());
+		return;
+	}
+
+	const int32 Slot{FreeSlots.Pop(false)};
+	Characters[Slot] = Character;
+	Slots.Add(Character, Slot);
+
+	// Older frames belong to whoever had the slot before, the character was here as far as they're concerned
+	const FVector Location{Character->GetActorLocation()};
+	for (int32 Frame = 0; Frame < HistoryLength; ++Frame)
+	{
+		Locations[GetFrameOffset(Frame) + Slot] = Location;
+	}
+	INC_DWORD_STAT(STAT_LagCompensatedCharacters);
+}
+
+void ULagCompensationSubsystem::UnregisterCharacter(ACharacter* Character)
+{
+	int32 Slot{INDEX_NONE};
+	if (!Slots.RemoveAndCopyValue(Character, Slot)) return;
+
+	Characters[Slot] = nullptr;
+	FreeSlots.Add(Slot);
+	DEC_DWORD_STAT(STAT_LagCompensatedCharacters);
+}
+
+bool ULagCompensationSubsystem::ConfirmShot(const ACharacter* Shooter, const FShooterFireRequest& Request,
+	FHitResult& OutHitResult) const
+{
+	if (!Shooter) return false;
+
+	// The shot has to leave from about where we have the shooter
+	bool bConfirmed{FVector::DistSquared(Request.TraceStart, Shooter->GetActorLocation()) <= FMath::Square(MaxMuzzleError)};
+	if (bConfirmed)
+	{
+		const ACharacter* HitCharacter = Cast<ACharacter>(Request.HitActor);
+		bConfirmed = HitCharacter && IsTracked(HitCharacter) ?
+			ConfirmRewoundHit(HitCharacter, Request.ClientTime, Request.TraceStart, Request.HitLocation, OutHitResult) :
+			ConfirmCurrentHit(Shooter, Request, OutHitResult);
+	}
+
+	if (bConfirmed)
+	{
+		INC_DWORD_STAT(STAT_ShotsConfirmed);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_ShotsRejected);
+	}
+	return bConfirmed;
+}
+
+void ULagCompensationSubsystem::RecordFrame()
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_LagCompensationRecord, Weapons);
+
+	NewestFrame = (NewestFrame + 1) % HistoryLength;
+	NumFrames = FMath::Min(NumFrames + 1, HistoryLength);
+	FrameTimes[NewestFrame] = GetWorld()->GetTimeSeconds();
+
+	FVector* FrameLocations = &Locations[GetFrameOffset(NewestFrame)];
+	for (int32 Slot = 0; Slot < MaxCharacters; ++Slot)
+	{
+		const ACharacter* Character = Characters[Slot];
+		if (IsValid(Character))
+		{
+			FrameLocations[Slot] = Character->GetActorLocation();
+		}
+	}
+}
+
+FVector ULagCompensationSubsystem::GetRewoundLocation(int32 Slot, float Time) const
+{
+	// Walk back from the newest frame to the first one at or before Time
+	int32 Newer{NewestFrame};
+	for (int32 i = 1; i < NumFrames; ++i)
+	{
+		const int32 Older{(NewestFrame - i + HistoryLength) % HistoryLength};
+		if (FrameTimes[Older] <= Time)
+		{
+			const float Span{FrameTimes[Newer] - FrameTimes[Older]};
+			const float Alpha{Span > 0.f ? FMath::Clamp((Time - FrameTimes[Older]) / Span, 0.f, 1.f) : 1.f};
+			return FMath::Lerp(Locations[GetFrameOffset(Older) + Slot], Locations[GetFrameOffset(Newer) + Slot], Alpha);
+		}
+		Newer = Older;
+	}
+
+	// Further back than the history goes, the oldest frame is the best we have
+	return Locations[GetFrameOffset(Newer) + Slot];
+}
+
+bool ULagCompensationSubsystem::ConfirmRewoundHit(const ACharacter* HitCharacter, float Time, const FVector& TraceStart,
+	const FVector& HitLocation, FHitResult& OutHitResult) const
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_LagCompensationRewind, Weapons);
+	if (NumFrames == 0) return false;
+
+	const float Now{GetWorld()->GetTimeSeconds()};
+	const FVector Center{GetRewoundLocation(Slots[HitCharacter], FMath::Clamp(Time, Now - MaxRewindTime, Now))};
+
+	// The reported hit has to be on the capsule where the client saw it
+	const UCapsuleComponent* Capsule = HitCharacter->GetCapsuleComponent();
+	const float Radius{Capsule->GetScaledCapsuleRadius() + HitTolerance};
+	const FVector AxisOffset{0.f, 0.f, Capsule->GetScaledCapsuleHalfHeight_WithoutHemisphere()};
+	if (FMath::PointDistToSegment(HitLocation, Center - AxisOffset, Center + AxisOffset) > Radius) return false;
+
+	// Level geometry doesn't move, so it can block the shot as it is now
+	const FVector Direction{(HitLocation - TraceStart).GetSafeNormal()};
+	const FVector TraceEnd{HitLocation - Direction * Radius};
+	if (FVector::DotProduct(TraceEnd - TraceStart, Direction) > 0.f &&
+		GetWorld()->LineTraceTestByObjectType(TraceStart, TraceEnd, FCollisionObjectQueryParams(ECC_WorldStatic)))
+	{
+		return false;
+	}
+
+	OutHitResult = FHitResult(const_cast<ACharacter*>(HitCharacter), HitCharacter->GetMesh(), HitLocation, -Direction);
+	OutHitResult.TraceStart = TraceStart;
+	OutHitResult.TraceEnd = HitLocation;
+	OutHitResult.BoneName = FindRewoundBone(HitCharacter, Center, TraceStart, HitLocation);
+	return true;
+}
+
+FName ULagCompensationSubsystem::FindRewoundBone(const ACharacter* HitCharacter, const FVector& RewoundCenter,
+	const FVector& TraceStart, const FVector& HitLocation) const
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_LagCompensationBone, Weapons);
+
+	// Only capsules are recorded, so move the shot by as far as the character has moved since and
+	// trace the mesh bodies as they are now
+	USkeletalMeshComponent* Mesh = HitCharacter->GetMesh();
+	if (!Mesh) return NAME_None;
+
+	const FVector Offset{HitCharacter->GetActorLocation() - RewoundCenter};
+	const FVector Direction{(HitLocation - TraceStart).GetSafeNormal()};
+	const float Reach{HitCharacter->GetCapsuleComponent()->GetScaledCapsuleRadius() * 2.f + HitTolerance};
+	FHitResult MeshHitResult;
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(LagCompensationBone), true);
+
+	// A shot that clips the capsule but misses every body counts as a body shot
+	if (!Mesh->LineTraceComponent(MeshHitResult, TraceStart + Offset, HitLocation + Offset + Direction * Reach, QueryParams))
+	{
+		return NAME_None;
+	}
+	return MeshHitResult.BoneName;
+}
+
+bool ULagCompensationSubsystem::ConfirmCurrentHit(const ACharacter* Shooter, const FShooterFireRequest& Request,
+	FHitResult& OutHitResult) const
+{
+	// A miss has nothing to confirm
+	if (!Request.HitActor) return false;
+
+	// Anything that isn't tracked hardly moves, so trace it as it is now
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(Shooter);
+	const FVector Direction{(Request.HitLocation - Request.TraceStart).GetSafeNormal()};
+	GetWorld()->LineTraceSingleByChannel(OutHitResult, Request.TraceStart,
+		Request.HitLocation + Direction * HitTolerance * 2.f, ECollisionChannel::ECC_Visibility, QueryParams);
+	return OutHitResult.GetActor() == Request.HitActor;
+}
@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Engine/NetSerialization.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LagCompensationSubsystem.generated.h"
+
+class ACharacter;
+
+// A hit as the client saw it, sent to the server to be confirmed
+USTRUCT()
+struct FShooterFireRequest
+{
+	GENERATED_BODY()
+
+	// Server world time the client had when it fired. Not sent, the server fills it in from the shots
+	UPROPERTY(NotReplicated)
+	float ClientTime{0.f};
+
+	// Muzzle location
+	UPROPERTY()
+	FVector_NetQuantize TraceStart;
+
+	// Where the beam ended on HitActor
+	UPROPERTY()
+	FVector_NetQuantize HitLocation;
+
+	UPROPERTY()
+	AActor* HitActor{nullptr};
+
+	// Shots the hit stands for. Not sent, the server fills it in with the ones it paid for
+	UPROPERTY(NotReplicated)
+	uint8 NumShots{1};
+
+	// Prediction sequence of the shots the hit is for
+	UPROPERTY()
+	uint16 Sequence{0};
+};
+
+/**
+ * Server side history of character hitboxes for confirming client shots at the time the client fired.
+ * Every tick the capsule center of each tracked character is written into a ring of frames preallocated
+ * in one contiguous array, so recording never allocates. Capsules stay upright, so their location is
+ * the whole hitbox transform. Only records on listen and dedicated servers.
+ */
+UCLASS(config = Game)
+class SHOOTER_API ULagCompensationSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	void RegisterCharacter(ACharacter* Character);
+	void UnregisterCharacter(ACharacter* Character);
+
+	FORCEINLINE bool IsTracked(const ACharacter* Character) const { return Slots.Contains(Character); }
+
+	// Checks a client shot fired by Shooter. Tracked characters are rewound to the client's time,
+	// anything else is traced as it is now. OutHitResult is the hit as the server found it, bone included
+	bool ConfirmShot(const ACharacter* Shooter, const FShooterFireRequest& Request, FHitResult& OutHitResult) const;
+
+private:
+	// Writes the newest frame
+	void RecordFrame();
+
+	// Capsule center of the character in the slot at Time, between the two recorded frames around it
+	FVector GetRewoundLocation(int32 Slot, float Time) const;
+
+	bool ConfirmRewoundHit(const ACharacter* HitCharacter, float Time, const FVector& TraceStart,
+		const FVector& HitLocation, FHitResult& OutHitResult) const;
+
+	bool ConfirmCurrentHit(const ACharacter* Shooter, const FShooterFireRequest& Request, FHitResult& OutHitResult) const;
+
+	// Bone the shot went through, tracing the mesh as it is now with the shot moved along with the character
+	FName FindRewoundBone(const ACharacter* HitCharacter, const FVector& RewoundCenter, const FVector& TraceStart,
+		const FVector& HitLocation) const;
+
+	FORCEINLINE int32 GetFrameOffset(int32 Frame) const { return Frame * MaxCharacters; }
+
+	// Character in each slot, null when free
+	UPROPERTY()
+	TArray<ACharacter*> Characters;
+
+	TMap<const ACharacter*, int32> Slots;
+
+	TArray<int32> FreeSlots;
+
+	// HistoryLength frames of MaxCharacters capsule centers each
+	TArray<FVector> Locations;
+
+	// World time of each frame
+	TArray<float> FrameTimes;
+
+	int32 NewestFrame{INDEX_NONE};
+
+	int32 NumFrames{0};
+
+	// Frames kept, at the server tick rate this has to cover MaxRewindTime
+	UPROPERTY(config)
+	int32 HistoryLength{64};
+
+	UPROPERTY(config)
+	int32 MaxCharacters{256};
+
+	// Shots from further back than this are confirmed against the oldest allowed frame
+	UPROPERTY(config)
+	float MaxRewindTime{0.4f};
+
+	// Slack on the capsules for quantization and interpolation
+	UPROPERTY(config)
+	float HitTolerance{15.f};
+
+	// How far the muzzle the client reports may be from where the server has the shooter
+	UPROPERTY(config)
+	float MaxMuzzleError{250.f};
+};
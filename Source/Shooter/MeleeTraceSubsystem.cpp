@@ -0,0 +1,127 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MeleeTraceSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterCharacter.h"
+#include "ShooterStats.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Melee Traces"), STAT_MeleeTraces, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Melee Sweeps"), STAT_MeleeSweeps, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Melee Swings"), STAT_ActiveMeleeSwings, STATGROUP_Shooter);
+
+void UMeleeTraceSubsystem::Deinitialize()
+{
+	DEC_DWORD_STAT_BY(STAT_ActiveMeleeSwings, Swings.Num());
+	Swings.Empty();
+
+	Super::Deinitialize();
+}
+
+void UMeleeTraceSubsystem::Tick(float DeltaTime)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_MeleeTraces, Enemies);
+
+	UWorld* World = GetWorld();
+	const FCollisionObjectQueryParams ObjectParams{ECC_Pawn};
+	TArray<FHitResult> Hits;
+
+	for (int32 i = Swings.Num() - 1; i >= 0; --i)
+	{
+		FMeleeSwing& Swing = Swings[i];
+		AEnemy* Attacker = Swing.Attacker.Get();
+		if (!Attacker)
+		{
+			Swings.RemoveAtSwap(i, 1, false);
+			DEC_DWORD_STAT(STAT_ActiveMeleeSwings);
+			continue;
+		}
+
+		const FVector Location{Attacker->GetMesh()->GetSocketLocation(Swing.SocketName)};
+		FCollisionQueryParams QueryParams{SCENE_QUERY_STAT(MeleeTrace), false, Attacker};
+
+		Hits.Reset();
+		World->SweepMultiByObjectType(Hits, Swing.LastLocation, Location, FQuat::Identity, ObjectParams,
+			FCollisionShape::MakeSphere(Swing.Radius), QueryParams);
+		INC_DWORD_STAT(STAT_MeleeSweeps);
+		Swing.LastLocation = Location;
+
+		// Record the hits before handing them out, the attacker may start or end swings in response
+		TArray<AShooterCharacter*, TInlineAllocator<2>> NewHits;
+		for (const FHitResult& Hit : Hits)
+		{
+			AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(Hit.GetActor());
+			if (!ShooterCharacter || Swing.HitActors.Contains(ShooterCharacter)) continue;
+
+			Swing.HitActors.Add(ShooterCharacter);
+			NewHits.Add(ShooterCharacter);
+		}
+
+		const FName SocketName{Swing.SocketName};
+		for (AShooterCharacter* ShooterCharacter : NewHits)
+		{
+			Attacker->MeleeHit(ShooterCharacter, SocketName);
+		}
+	}
+}
+
+bool UMeleeTraceSubsystem::IsTickable() const
+{
+	return Swings.Num() > 0 && !IsTemplate();
+}
+
+TStatId UMeleeTraceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMeleeTraceSubsystem, STATGROUP_Tickables);
+}
+
+void UMeleeTraceSubsystem::BeginSwing(AEnemy* Attacker, FName SocketName, float Radius)
+{
+	if (!Attacker) return;
+
+	int32 Index{FindSwing(Attacker, SocketName)};
+	if (Index == INDEX_NONE)
+	{
+		Index = Swings.AddDefaulted();
+		INC_DWORD_STAT(STAT_ActiveMeleeSwings);
+	}
+
+	FMeleeSwing& Swing = Swings[Index];
+	Swing.Attacker = Attacker;
+	Swing.SocketName = SocketName;
+	Swing.Radius = Radius;
+	Swing.LastLocation = Attacker->GetMesh()->GetSocketLocation(SocketName);
+	Swing.HitActors.Reset();
+}
+
+void UMeleeTraceSubsystem::EndSwing(AEnemy* Attacker, FName SocketName)
+{
+	const int32 Index{FindSwing(Attacker, SocketName)};
+	if (Index == INDEX_NONE) return;
+
+	Swings.RemoveAtSwap(Index, 1, false);
+	DEC_DWORD_STAT(STAT_ActiveMeleeSwings);
+}
+
+void UMeleeTraceSubsystem::EndAllSwings(AEnemy* Attacker)
+{
+	for (int32 i = Swings.Num() - 1; i >= 0; --i)
+	{
+		if (Swings[i].Attacker == Attacker)
+		{
+			Swings.RemoveAtSwap(i, 1, false);
+			DEC_DWORD_STAT(STAT_ActiveMeleeSwings);
+		}
+	}
+}
+
+int32 UMeleeTraceSubsystem::FindSwing(const AEnemy* Attacker, FName SocketName) const
+{
+	return Swings.IndexOfByPredicate([Attacker, SocketName](const FMeleeSwing& Swing)
+	{
+		return Swing.Attacker == Attacker && Swing.SocketName == SocketName;
+	});
+}
@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MeleeTraceSubsystem.generated.h"
+
+class AEnemy;
+
+// A weapon socket being swept while an attack is active
+USTRUCT()
+struct FMeleeSwing
+{
+	GENERATED_BODY()
+
+	TWeakObjectPtr<AEnemy> Attacker;
+
+	FName SocketName;
+
+	float Radius{0.f};
+
+	// Socket location at the end of the last sweep
+	FVector LastLocation{FVector::ZeroVector};
+
+	// Actors already hit this swing
+	TArray<TWeakObjectPtr<AActor>, TInlineAllocator<2>> HitActors;
+};
+
+/**
+ * Sweeps a sphere along the path of every active enemy weapon socket since the previous frame,
+ * in one pass for all attackers. Each actor is hit at most once per swing.
+ */
+UCLASS()
+class SHOOTER_API UMeleeTraceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	// Starts sweeping a socket on the attacker's mesh. Starting a socket that's already swinging restarts its swing
+	void BeginSwing(AEnemy* Attacker, FName SocketName, float Radius);
+
+	void EndSwing(AEnemy* Attacker, FName SocketName);
+
+	// Ends every swing of the attacker
+	void EndAllSwings(AEnemy* Attacker);
+
+private:
+	int32 FindSwing(const AEnemy* Attacker, FName SocketName) const;
+
+	UPROPERTY()
+	TArray<FMeleeSwing> Swings;
+};
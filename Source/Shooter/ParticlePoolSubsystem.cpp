@@ -0,0 +1,171 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ParticlePoolSubsystem.h"
+
+#include "Shooter.h"
+#include "ShooterStats.h"
+#include "Engine/World.h"
+#include "Kismet/GameplayStatics.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Particle Components Allocated"), STAT_ParticleComponentsAllocated, STATGROUP_Shooter);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Particle Components Active"), STAT_ParticleComponentsActive, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Particle Pool Reuses"), STAT_ParticlePoolReuses, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Particle Budget Steals"), STAT_ParticleBudgetSteals, STATGROUP_Shooter);
+
+void UParticlePoolSubsystem::Deinitialize()
+{
+	for (auto& PoolPair : Pools)
+	{
+		for (UParticleSystemComponent* Component : PoolPair.Value.Active)
+		{
+			if (Component)
+			{
+				DEC_DWORD_STAT(STAT_ParticleComponentsActive);
+				DEC_DWORD_STAT(STAT_ParticleComponentsAllocated);
+				Component->DestroyComponent();
+			}
+		}
+		for (UParticleSystemComponent* Component : PoolPair.Value.Free)
+		{
+			if (Component)
+			{
+				DEC_DWORD_STAT(STAT_ParticleComponentsAllocated);
+				Component->DestroyComponent();
+			}
+		}
+	}
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::SpawnEmitterAtLocation(UParticleSystem* Template,
+	const FTransform& Transform)
+{
+	if (!Template) return nullptr;
+
+	FParticlePool& Pool = FindOrAddPool(Template);
+	UParticleSystemComponent* Component{nullptr};
+	if (Pool.Free.Num() > 0)
+	{
+		Component = Pool.Free.Pop(false);
+		INC_DWORD_STAT(STAT_ParticlePoolReuses);
+	}
+	else if (Pool.Active.Num() >= Pool.Budget && Pool.Active.Num() > 0)
+	{
+		// Over budget, drop the oldest instance. Remove it first so the finished callback doesn't free it
+		Component = Pool.Active[0];
+		Pool.Active.RemoveAt(0, 1, false);
+		DEC_DWORD_STAT(STAT_ParticleComponentsActive);
+		Component->DeactivateImmediate();
+		INC_DWORD_STAT(STAT_ParticleBudgetSteals);
+	}
+	else
+	{
+		Component = CreateComponent(Template);
+	}
+	if (!Component) return nullptr;
+
+	Component->SetWorldTransform(Transform);
+	Component->ActivateSystem(true);
+	Pool.Active.Add(Component);
+	INC_DWORD_STAT(STAT_ParticleComponentsActive);
+	return Component;
+}
+
+void UParticlePoolSubsystem::PrewarmPool(UParticleSystem* Template, int32 Count)
+{
+	if (!Template) return;
+
+	FParticlePool& Pool = FindOrAddPool(Template);
+	const int32 NumToCreate{FMath::Min(Count, Pool.Budget) - Pool.Free.Num() - Pool.Active.Num()};
+	for (int32 i = 0; i < NumToCreate; i++)
+	{
+		UParticleSystemComponent* Component = CreateComponent(Template);
+		if (Component)
+		{
+			Pool.Free.Add(Component);
+		}
+	}
+}
+
+void UParticlePoolSubsystem::SetEffectBudget(UParticleSystem* Template, int32 Budget)
+{
+	if (!Template) return;
+	FindOrAddPool(Template).Budget = FMath::Max(Budget, 1);
+}
+
+int32 UParticlePoolSubsystem::GetNumFreeComponents(UParticleSystem* Template) const
+{
+	const FParticlePool* Pool = Pools.Find(Template);
+	return Pool ? Pool->Free.Num() : 0;
+}
+
+int32 UParticlePoolSubsystem::GetNumActiveComponents(UParticleSystem* Template) const
+{
+	const FParticlePool* Pool = Pools.Find(Template);
+	return Pool ? Pool->Active.Num() : 0;
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::SpawnEmitter(const UObject* WorldContextObject,
+	UParticleSystem* Template, const FTransform& Transform)
+{
+	if (!Template || !WorldContextObject) return nullptr;
+	if (!ShouldPlayCosmetics(WorldContextObject)) return nullptr;
+
+	UWorld* World = WorldContextObject->GetWorld();
+	UParticlePoolSubsystem* ParticlePool = World ? World->GetSubsystem<UParticlePoolSubsystem>() : nullptr;
+	if (ParticlePool)
+	{
+		return ParticlePool->SpawnEmitterAtLocation(Template, Transform);
+	}
+	return UGameplayStatics::SpawnEmitterAtLocation(World, Template, Transform);
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::SpawnEmitter(const UObject* WorldContextObject,
+	UParticleSystem* Template, const FVector& Location, const FRotator& Rotation)
+{
+	return SpawnEmitter(WorldContextObject, Template, FTransform(Rotation, Location));
+}
+
+FParticlePool& UParticlePoolSubsystem::FindOrAddPool(UParticleSystem* Template)
+{
+	FParticlePool* Pool = Pools.Find(Template);
+	if (!Pool)
+	{
+		Pool = &Pools.Add(Template);
+		Pool->Budget = FMath::Max(DefaultEffectBudget, 1);
+	}
+	return *Pool;
+}
+
+UParticleSystemComponent* UParticlePoolSubsystem::CreateComponent(UParticleSystem* Template)
+{
+	UWorld* World = GetWorld();
+	if (!World) return nullptr;
+
+	UParticleSystemComponent* Component = NewObject<UParticleSystemComponent>(World);
+	Component->bAutoDestroy = false;
+	Component->bAutoActivate = false;
+	Component->SetAbsolute(true, true, true);
+	Component->SetTemplate(Template);
+	Component->OnSystemFinished.AddDynamic(this, &UParticlePoolSubsystem::OnParticleSystemFinished);
+	Component->RegisterComponentWithWorld(World);
+	INC_DWORD_STAT(STAT_ParticleComponentsAllocated);
+	return Component;
+}
+
+void UParticlePoolSubsystem::OnParticleSystemFinished(UParticleSystemComponent* Component)
+{
+	if (!Component) return;
+
+	FParticlePool* Pool = Pools.Find(Component->Template);
+	if (Pool && Pool->Active.RemoveSingle(Component) > 0)
+	{
+		DEC_DWORD_STAT(STAT_ParticleComponentsActive);
+		Pool->Free.Add(Component);
+	}
+}
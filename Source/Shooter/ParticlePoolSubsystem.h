@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ParticlePoolSubsystem.generated.h"
+
+class UParticleSystem;
+class UParticleSystemComponent;
+
+// Components for a single particle system template
+USTRUCT()
+struct FParticlePool
+{
+	GENERATED_BODY()
+
+	// Components ready to be reused
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Free;
+
+	// Components currently playing, oldest first
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> Active;
+
+	// Max number of components playing at once for this effect
+	int32 Budget{0};
+};
+
+/**
+ * Keeps pre-warmed particle system components for each effect and recycles them when the effect finishes,
+ * instead of creating and destroying a component for every spawned emitter.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UParticlePoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Plays the effect with a pooled component. Steals the oldest component if the effect is over its budget
+	UParticleSystemComponent* SpawnEmitterAtLocation(UParticleSystem* Template, const FTransform& Transform);
+
+	// Makes sure Count components exist for this effect
+	void PrewarmPool(UParticleSystem* Template, int32 Count);
+	void PrewarmPool(UParticleSystem* Template) { PrewarmPool(Template, DefaultPrewarmCount); }
+
+	void SetEffectBudget(UParticleSystem* Template, int32 Budget);
+
+	int32 GetNumFreeComponents(UParticleSystem* Template) const;
+	int32 GetNumActiveComponents(UParticleSystem* Template) const;
+
+	// Spawns through the world's pool, or a regular emitter if there is no pool
+	static UParticleSystemComponent* SpawnEmitter(const UObject* WorldContextObject, UParticleSystem* Template,
+		const FTransform& Transform);
+	static UParticleSystemComponent* SpawnEmitter(const UObject* WorldContextObject, UParticleSystem* Template,
+		const FVector& Location, const FRotator& Rotation = FRotator::ZeroRotator);
+
+private:
+	FParticlePool& FindOrAddPool(UParticleSystem* Template);
+
+	UParticleSystemComponent* CreateComponent(UParticleSystem* Template);
+
+	// Returns finished components to their pool
+	UFUNCTION()
+	void OnParticleSystemFinished(UParticleSystemComponent* Component);
+
+	UPROPERTY()
+	TMap<UParticleSystem*, FParticlePool> Pools;
+
+	// Budget for effects that don't set their own
+	UPROPERTY(config)
+	int32 DefaultEffectBudget{32};
+
+	// Number of components created when an effect is pre-warmed
+	UPROPERTY(config)
+	int32 DefaultPrewarmCount{4};
+};
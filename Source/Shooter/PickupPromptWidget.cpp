@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupPromptWidget.h"
+
+#include "ShooterStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Pickup Prompt Refreshes"), STAT_PickupPromptRefreshes, STATGROUP_Shooter);
+
+void UPickupPromptWidget::SetItem(AItem* NewItem)
+{
+	if (!NewItem) return;
+
+	const bool bChanged{NewItem != Item || NewItem->GetItemCount() != ItemCount ||
+		NewItem->GetCharacterInventoryFull() != bCharacterInventoryFull};
+	if (!bChanged) return;
+
+	Item = NewItem;
+	ItemName = NewItem->GetItemName();
+	ItemCount = NewItem->GetItemCount();
+	ActiveStars = NewItem->GetActiveStars();
+	LightColor = NewItem->GetLightColor();
+	DarkColor = NewItem->GetDarkColor();
+	bCharacterInventoryFull = NewItem->GetCharacterInventoryFull();
+	INC_DWORD_STAT(STAT_PickupPromptRefreshes);
+	OnItemChanged();
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Item.h"
+#include "PickupPromptWidget.generated.h"
+
+/**
+ * Screen space pickup prompt shared by every item. The player controller feeds it the item
+ * under the crosshairs and keeps it over that item, the blueprint subclass lays out the prompt.
+ */
+UCLASS()
+class SHOOTER_API UPickupPromptWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	// Copies the item's prompt data. Refreshes the prompt only if something changed
+	void SetItem(AItem* NewItem);
+
+protected:
+	// Called after the prompt data changed so the blueprint can update its layout
+	UFUNCTION(BlueprintImplementableEvent, Category = Pickup)
+	void OnItemChanged();
+
+private:
+	// Item the prompt is showing
+	UPROPERTY(BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	AItem* Item;
+
+	UPROPERTY(BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	FString ItemName;
+
+	UPROPERTY(BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	int32 ItemCount;
+
+	// Same layout as AItem::ActiveStars, element 0 isn't used
+	UPROPERTY(BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	TArray<bool> ActiveStars;
+
+	UPROPERTY(BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	FLinearColor LightColor;
+
+	UPROPERTY(BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	FLinearColor DarkColor;
+
+	UPROPERTY(BlueprintReadOnly, Category = Pickup, meta = (AllowPrivateAccess = "true"))
+	bool bCharacterInventoryFull;
+};
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ServerLoadSubsystem.h"
+
+#include "Shooter.h"
+#include "ShooterStats.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Server Frame Time Per Player (ms)"), STAT_ServerFrameTimePerPlayer, STATGROUP_Shooter);
+
+void UServerLoadSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	float Interval{ReportInterval};
+	FParse::Value(FCommandLine::Get(), TEXT("ShooterServerLoad="), Interval);
+	SetReportInterval(Interval);
+}
+
+void UServerLoadSubsystem::Deinitialize()
+{
+	if (NumFrames > 0)
+	{
+		Report();
+	}
+	FWorldDelegates::OnWorldTickStart.Remove(TickStartHandle);
+	GetWorld()->OnPostTickFlush().Remove(PostTickFlushHandle);
+
+	Super::Deinitialize();
+}
+
+void UServerLoadSubsystem::Tick(float DeltaTime)
+{
+	if (FPlatformTime::Seconds() - ReportStartTime >= ReportInterval)
+	{
+		Report();
+	}
+}
+
+bool UServerLoadSubsystem::IsTickable() const
+{
+	return ReportInterval > 0.f && !IsTemplate();
+}
+
+TStatId UServerLoadSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UServerLoadSubsystem, STATGROUP_Tickables);
+}
+
+void UServerLoadSubsystem::SetReportInterval(float Interval)
+{
+	UWorld* World = GetWorld();
+	const ENetMode NetMode{World->GetNetMode()};
+	const bool bServer{World->IsGameWorld() && (NetMode == NM_DedicatedServer || NetMode == NM_ListenServer)};
+	ReportInterval = bServer ? FMath::Max(Interval, 0.f) : 0.f;
+	if (ReportInterval <= 0.f || TickStartHandle.IsValid()) return;
+
+	TickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UServerLoadSubsystem::OnWorldTickStart);
+	PostTickFlushHandle = World->OnPostTickFlush().AddUObject(this, &UServerLoadSubsystem::OnPostTickFlush);
+	ReportStartTime = FPlatformTime::Seconds();
+	UE_LOG(LogShooter, Log, TEXT("Server load report every %.1f s"), ReportInterval);
+}
+
+void UServerLoadSubsystem::OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaTime)
+{
+	if (World == GetWorld())
+	{
+		FrameStartTime = FPlatformTime::Seconds();
+	}
+}
+
+void UServerLoadSubsystem::OnPostTickFlush(float DeltaTime)
+{
+	if (FrameStartTime <= 0.0) return;
+
+	const double FrameTime{FPlatformTime::Seconds() - FrameStartTime};
+	const int32 NumPlayers{GetWorld()->GetNumPlayerControllers()};
+	++NumFrames;
+	TotalFrameTime += FrameTime;
+	MaxFrameTime = FMath::Max(MaxFrameTime, FrameTime);
+	TotalPlayers += NumPlayers;
+	SET_FLOAT_STAT(STAT_ServerFrameTimePerPlayer, NumPlayers > 0 ? FrameTime * 1000.0 / NumPlayers : 0.0);
+}
+
+void UServerLoadSubsystem::Report()
+{
+	if (NumFrames > 0)
+	{
+		LastReport.NumFrames = NumFrames;
+		LastReport.AverageFrameMs = TotalFrameTime * 1000.0 / NumFrames;
+		LastReport.MaxFrameMs = MaxFrameTime * 1000.0;
+		LastReport.AveragePlayers = static_cast<double>(TotalPlayers) / NumFrames;
+		UE_LOG(LogShooter, Log, TEXT("Server load: %d frames, %.2f ms average, %.2f ms max, %.1f players, %.3f ms per player"),
+			LastReport.NumFrames, LastReport.AverageFrameMs, LastReport.MaxFrameMs, LastReport.AveragePlayers,
+			LastReport.GetFrameMsPerPlayer());
+	}
+
+	ReportStartTime = FPlatformTime::Seconds();
+	NumFrames = 0;
+	TotalFrameTime = 0.0;
+	MaxFrameTime = 0.0;
+	TotalPlayers = 0;
+}
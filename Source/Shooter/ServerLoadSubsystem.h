@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ServerLoadSubsystem.generated.h"
+
+// Frames timed between two reports, averaged
+struct FServerLoadReport
+{
+	int32 NumFrames{0};
+
+	double AverageFrameMs{0.0};
+
+	double MaxFrameMs{0.0};
+
+	double AveragePlayers{0.0};
+
+	FORCEINLINE double GetFrameMsPerPlayer() const { return AveragePlayers > 0.0 ? AverageFrameMs / AveragePlayers : 0.0; }
+};
+
+/**
+ * Logs the server's frame time per connected player, for loopback load tests. Start a server with
+ * -ShooterServerLoad=<seconds> (or set ReportInterval) and connect clients started with -ShooterBot. Tests
+ * call SetReportInterval and SetBot instead.
+ * Frames are timed from the start of the world tick to the end of replication, so the idle time
+ * spent holding the net tick rate isn't counted. Only runs on listen and dedicated servers.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UServerLoadSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	// Starts timing frames with a report every Interval seconds, 0 stops it. Ignored on clients
+	void SetReportInterval(float Interval);
+
+	// Logs the frames since the last report and starts a new one
+	void Report();
+
+	FORCEINLINE const FServerLoadReport& GetLastReport() const { return LastReport; }
+
+private:
+	void OnWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaTime);
+	void OnPostTickFlush(float DeltaTime);
+
+	FDelegateHandle TickStartHandle;
+	FDelegateHandle PostTickFlushHandle;
+
+	double FrameStartTime{0.0};
+
+	double ReportStartTime{0.0};
+
+	// Frames timed since the last report
+	int32 NumFrames{0};
+
+	double TotalFrameTime{0.0};
+
+	double MaxFrameTime{0.0};
+
+	// Players connected on each timed frame, added up
+	int64 TotalPlayers{0};
+
+	FServerLoadReport LastReport;
+
+	// Seconds between reports, 0 turns the report off
+	UPROPERTY(config)
+	float ReportInterval{0.f};
+};
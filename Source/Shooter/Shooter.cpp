@@ -1,6 +1,19 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "Shooter.h"
+#include "Engine/World.h"
+#include "Misc/App.h"
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Shooter, "Shooter" );
+
+DEFINE_LOG_CATEGORY(LogShooter);
+
+bool ShouldPlayCosmetics(const UObject* WorldContextObject)
+{
+	if (!FApp::CanEverRender()) return false;
+
+	// A dedicated server world can still run in a process that renders, like PIE
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return !World || World->GetNetMode() != NM_DedicatedServer;
+}
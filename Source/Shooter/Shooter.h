@@ -4,6 +4,11 @@
 
 #include "CoreMinimal.h"
 
+DECLARE_LOG_CATEGORY_EXTERN(LogShooter, Log, All);
+
+// False on dedicated servers and -nullrhi runs, where nobody sees or hears effects
+SHOOTER_API bool ShouldPlayCosmetics(const UObject* WorldContextObject);
+
 #define EPS_Metal EPhysicalSurface::SurfaceType1
 #define EPS_Stone EPhysicalSurface::SurfaceType2
 #define EPS_Tile  EPhysicalSurface::SurfaceType3
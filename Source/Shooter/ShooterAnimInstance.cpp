@@ -2,125 +2,133 @@
 
 
 #include "ShooterAnimInstance.h"
+
 #include "ShooterCharacter.h"
+#include "ShooterStats.h"
 #include "Weapon.h"
 #include "GameFramework/CharacterMovementComponent.h"
 #include "Kismet/KismetMathLibrary.h"
 
-UShooterAnimInstance::UShooterAnimInstance() :
-Speed(0.f),
-bIsInAir(false),
-bIsAccelerating(false),
-MovementOffsetYaw(0.f),
-LastMovementOffsetYaw(0.f),
-bAiming(false),
-TIPCharacterYaw(0.f),
-TIPCharacterYawLastFrame(0.f),
-RootYawOffset(0.f),
-Pitch(0.f),
-bReloading(false),
-OffsetState(EOffsetState::EOS_Hip),
-CharacterRotation(FRotator(0.f)),
-CharacterRotationLastFrame(FRotator(0.f)),
-YawDelta(0.f),
-bCrouching(false),
-RecoilWeight(1.f),
-bTurningInPlace(false),
-EquippedWeaponType(EWeaponType::EWT_MAX),
-bShouldUseFABRIK(false)
+DECLARE_CYCLE_STAT(TEXT("Shooter Anim PreUpdate"), STAT_ShooterAnimPreUpdate, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Shooter Anim Update"), STAT_ShooterAnimUpdate, STATGROUP_Shooter);
+
+// Curves driven by the turn in place animations, looked up every update
+static const FName TurningCurveName(TEXT("Turning"));
+static const FName RotationCurveName(TEXT("Rotation"));
+
+void FShooterAnimInstanceProxy::Initialize(UAnimInstance* InAnimInstance)
 {
-	
+	FAnimInstanceProxy::Initialize(InAnimInstance);
+	ShooterAnimInstance = Cast<UShooterAnimInstance>(InAnimInstance);
 }
 
-void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime)
+void FShooterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
 {
-	if (!ShooterCharacter)
-	{
-		ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
-	}
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterAnimPreUpdate, Animation);
+	FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
 
-	if (ShooterCharacter)
+	// Game thread, copy what Update needs and nothing else
+	AShooterCharacter* ShooterCharacter = ShooterAnimInstance ? ShooterAnimInstance->ShooterCharacter : nullptr;
+	if (!ShooterCharacter && ShooterAnimInstance)
 	{
-		bCrouching = ShooterCharacter->GetCrouching();
-		bReloading = ShooterCharacter->GetCombatState() == ECombatState::ECS_Reloading;
-		bEquipping = ShooterCharacter->GetCombatState() == ECombatState::ECS_Equipping;
-		bShouldUseFABRIK = ShooterCharacter->GetCombatState() == ECombatState::ECS_Unoccupied ||
-			ShooterCharacter->GetCombatState() == ECombatState::ECS_FireTimerInProgress;
-		
-		// Get lateral speed of the character from velocity
-		FVector Velocity{ShooterCharacter->GetVelocity()};
-		Velocity.Z = 0;
-		Speed = Velocity.Size();
-
-		// Is the character in air?
-		bIsInAir = ShooterCharacter->GetCharacterMovement()->IsFalling();
-
-		// Is the character moving?
-		if (ShooterCharacter->GetCharacterMovement()->GetCurrentAcceleration().Size() > 0.f)
-		{
-			bIsAccelerating = true;
-		}
-		else
-		{
-			bIsAccelerating = false;
-		}
-		
-		FRotator AimRotation = ShooterCharacter->GetBaseAimRotation();
-		FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(ShooterCharacter->GetVelocity());
+		ShooterCharacter = Cast<AShooterCharacter>(ShooterAnimInstance->TryGetPawnOwner());
+		ShooterAnimInstance->ShooterCharacter = ShooterCharacter;
+	}
 
-		MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
+	bHasCharacter = ShooterCharacter != nullptr;
+	if (!bHasCharacter) return;
 
-		if (ShooterCharacter->GetVelocity().Size() > 0.f)
-		{
-			LastMovementOffsetYaw = MovementOffsetYaw;
-		}
+	const ECombatState CombatState{ShooterCharacter->GetCombatState()};
+	bCrouching = ShooterCharacter->GetCrouching();
+	bReloading = CombatState == ECombatState::ECS_Reloading;
+	bEquipping = CombatState == ECombatState::ECS_Equipping;
+	bShouldUseFABRIK = CombatState == ECombatState::ECS_Unoccupied ||
+		CombatState == ECombatState::ECS_FireTimerInProgress;
 
-		bAiming = ShooterCharacter->GetAiming();
+	const UCharacterMovementComponent* CharacterMovement = ShooterCharacter->GetCharacterMovement();
+	Velocity = ShooterCharacter->GetVelocity();
+	bFalling = CharacterMovement->IsFalling();
+	bAccelerating = CharacterMovement->GetCurrentAcceleration().Size() > 0.f;
+	AimRotation = ShooterCharacter->GetBaseAimRotation();
+	ActorRotation = ShooterCharacter->GetActorRotation();
+	bAiming = ShooterCharacter->GetAiming();
 
-		if (bReloading)
-		{
-			OffsetState = EOffsetState::EOS_Reloading;
-		}
-		else if (bIsInAir)
-		{
-			OffsetState = EOffsetState::EOS_InAir;
-		}
-		else if (ShooterCharacter->GetAiming())
-		{
-			OffsetState = EOffsetState::EOS_Aiming;
-		}
-		else
-		{
-			OffsetState = EOffsetState::EOS_Hip;
-		}
-		// Check if ShooterCharacter has valid EquippedWeapon
-		if (ShooterCharacter->GetEquippedWeapon())
-		{
-			EquippedWeaponType = ShooterCharacter->GetEquippedWeapon()->GetWeaponType();
-		}
+	const AWeapon* EquippedWeapon = ShooterCharacter->GetEquippedWeapon();
+	bHasEquippedWeapon = EquippedWeapon != nullptr;
+	if (EquippedWeapon)
+	{
+		EquippedWeaponType = EquippedWeapon->GetWeaponType();
 	}
-	
-	TurnInPlace();
-	Lean(DeltaTime);
 }
 
-void UShooterAnimInstance::NativeInitializeAnimation()
+void FShooterAnimInstanceProxy::Update(float DeltaSeconds)
 {
-	Super::NativeInitializeAnimation();
-	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ShooterAnimUpdate, Animation);
+	FAnimInstanceProxy::Update(DeltaSeconds);
+
+	// Worker thread. The instance's properties are only read by the anim graph while this runs
+	if (!ShooterAnimInstance || !bHasCharacter) return;
+	UShooterAnimInstance& Anim = *ShooterAnimInstance;
+
+	Anim.bCrouching = bCrouching;
+	Anim.bReloading = bReloading;
+	Anim.bEquipping = bEquipping;
+	Anim.bShouldUseFABRIK = bShouldUseFABRIK;
+
+	// Get lateral speed of the character from velocity
+	FVector LateralVelocity{Velocity};
+	LateralVelocity.Z = 0;
+	Anim.Speed = LateralVelocity.Size();
+
+	Anim.bIsInAir = bFalling;
+	Anim.bIsAccelerating = bAccelerating;
+
+	const FRotator MovementRotation = UKismetMathLibrary::MakeRotFromX(Velocity);
+	Anim.MovementOffsetYaw = UKismetMathLibrary::NormalizedDeltaRotator(MovementRotation, AimRotation).Yaw;
+
+	if (Velocity.Size() > 0.f)
+	{
+		Anim.LastMovementOffsetYaw = Anim.MovementOffsetYaw;
+	}
+
+	Anim.bAiming = bAiming;
+
+	if (bReloading)
+	{
+		Anim.OffsetState = EOffsetState::EOS_Reloading;
+	}
+	else if (bFalling)
+	{
+		Anim.OffsetState = EOffsetState::EOS_InAir;
+	}
+	else if (bAiming)
+	{
+		Anim.OffsetState = EOffsetState::EOS_Aiming;
+	}
+	else
+	{
+		Anim.OffsetState = EOffsetState::EOS_Hip;
+	}
+	if (bHasEquippedWeapon)
+	{
+		Anim.EquippedWeaponType = EquippedWeaponType;
+	}
+
+	TurnInPlace();
+	Lean(DeltaSeconds);
 }
 
-void UShooterAnimInstance::TurnInPlace()
+void FShooterAnimInstanceProxy::TurnInPlace()
 {
-	if (!ShooterCharacter) return;
+	UShooterAnimInstance& Anim = *ShooterAnimInstance;
 
-	Pitch = ShooterCharacter->GetBaseAimRotation().Pitch;
+	Anim.Pitch = AimRotation.Pitch;
 	
-	if (Speed > 0.f || bIsInAir)
+	if (Anim.Speed > 0.f || Anim.bIsInAir)
 	{
 		// Don't want to turn in place when the character's moving
-		RootYawOffset = 0.f;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		Anim.RootYawOffset = 0.f;
+		TIPCharacterYaw = ActorRotation.Yaw;
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
 		RotationCurveLastFrame = 0.f;
 		RotationCurve = 0.f;
@@ -128,78 +136,122 @@ void UShooterAnimInstance::TurnInPlace()
 	else
 	{
 		TIPCharacterYawLastFrame = TIPCharacterYaw;
-		TIPCharacterYaw = ShooterCharacter->GetActorRotation().Yaw;
+		TIPCharacterYaw = ActorRotation.Yaw;
 		const float TIPYawDelta{TIPCharacterYaw - TIPCharacterYawLastFrame};
 
 		// RootYawOffset clamped to [-180, 180]
-		RootYawOffset = UKismetMathLibrary::NormalizeAxis(RootYawOffset - TIPYawDelta);
+		Anim.RootYawOffset = UKismetMathLibrary::NormalizeAxis(Anim.RootYawOffset - TIPYawDelta);
 
-		const float Turning = {GetCurveValue(TEXT("Turning"))};
+		const float Turning = {GetCurveValueAnyThread(TurningCurveName)};
 		if (Turning > 0) // 1.0 if turning, 0.0 if not
 		{
-			bTurningInPlace = true;
+			Anim.bTurningInPlace = true;
 			RotationCurveLastFrame = RotationCurve;
-			RotationCurve = GetCurveValue(TEXT("Rotation"));
+			RotationCurve = GetCurveValueAnyThread(RotationCurveName);
 			const float DeltaRotation{RotationCurve - RotationCurveLastFrame};
 
 			// RootYawOffset > 0 -> turning left, RootYawOffset < 0 -> turning right
-			RootYawOffset > 0 ? RootYawOffset -= DeltaRotation : RootYawOffset += DeltaRotation;
+			Anim.RootYawOffset > 0 ? Anim.RootYawOffset -= DeltaRotation : Anim.RootYawOffset += DeltaRotation;
 
-			const float ABSRootYawOffset{FMath::Abs(RootYawOffset)};
+			const float ABSRootYawOffset{FMath::Abs(Anim.RootYawOffset)};
 			if (ABSRootYawOffset > 90.f)
 			{
 				const float YawExcess{ABSRootYawOffset - 90.f};
-				RootYawOffset > 0 ? RootYawOffset -= YawExcess : RootYawOffset += YawExcess;
+				Anim.RootYawOffset > 0 ? Anim.RootYawOffset -= YawExcess : Anim.RootYawOffset += YawExcess;
 			}
 		}
 		else
 		{
-			bTurningInPlace = false;
+			Anim.bTurningInPlace = false;
 		}
 	}
 
 	// Set the recoil weight
-	if (bTurningInPlace)
+	if (Anim.bTurningInPlace)
 	{
 		if (bReloading || bEquipping)
 		{
-			RecoilWeight = 1.f;
+			Anim.RecoilWeight = 1.f;
 		}
 		else
 		{
-			RecoilWeight = 0.f;
+			Anim.RecoilWeight = 0.f;
 		}
 	}
 	else if (bCrouching)
 	{
 		if (bReloading || bEquipping)
 		{
-			RecoilWeight = 1.f;
+			Anim.RecoilWeight = 1.f;
 		}
 		else
 		{
-			RecoilWeight = 0.1f;
+			Anim.RecoilWeight = 0.1f;
 		}
 	}
 	else if (bAiming)
 	{
-		RecoilWeight = 1.f;
+		Anim.RecoilWeight = 1.f;
 	}
 	else
 	{
-		RecoilWeight = 0.8f;
+		Anim.RecoilWeight = 0.8f;
 	}
 }
 
-void UShooterAnimInstance::Lean(float DeltaTime)
+void FShooterAnimInstanceProxy::Lean(float DeltaSeconds)
 {
-	if (!ShooterCharacter) return;
+	UShooterAnimInstance& Anim = *ShooterAnimInstance;
+
 	CharacterRotationLastFrame = CharacterRotation;
-	CharacterRotation = ShooterCharacter->GetActorRotation();
+	CharacterRotation = ActorRotation;
 
 	const FRotator Delta{UKismetMathLibrary::NormalizedDeltaRotator(CharacterRotation, CharacterRotationLastFrame)};
 
-	const float Target{Delta.Yaw / DeltaTime};
-	const float Interp{FMath::FInterpTo(YawDelta, Target, DeltaTime, 6.f)};
-	YawDelta = FMath::Clamp(Interp, -90.f, 90.f);
+	const float Target{Delta.Yaw / DeltaSeconds};
+	const float Interp{FMath::FInterpTo(Anim.YawDelta, Target, DeltaSeconds, 6.f)};
+	Anim.YawDelta = FMath::Clamp(Interp, -90.f, 90.f);
+}
+
+float FShooterAnimInstanceProxy::GetCurveValueAnyThread(FName CurveName) const
+{
+	// Curves from the last evaluation, same values UAnimInstance::GetCurveValue returns
+	const float* Value = GetAnimationCurves(EAnimCurveType::AttributeCurve).Find(CurveName);
+	return Value ? *Value : 0.f;
+}
+
+UShooterAnimInstance::UShooterAnimInstance() :
+Speed(0.f),
+bIsInAir(false),
+bIsAccelerating(false),
+MovementOffsetYaw(0.f),
+LastMovementOffsetYaw(0.f),
+bAiming(false),
+RootYawOffset(0.f),
+Pitch(0.f),
+bReloading(false),
+OffsetState(EOffsetState::EOS_Hip),
+YawDelta(0.f),
+bCrouching(false),
+RecoilWeight(1.f),
+bTurningInPlace(false),
+EquippedWeaponType(EWeaponType::EWT_MAX),
+bShouldUseFABRIK(false)
+{
+	
+}
+
+void UShooterAnimInstance::UpdateAnimationProperties(float DeltaTime)
+{
+}
+
+void UShooterAnimInstance::NativeInitializeAnimation()
+{
+	Super::NativeInitializeAnimation();
+	ShooterCharacter = Cast<AShooterCharacter>(TryGetPawnOwner());
+}
+
+FAnimInstanceProxy* UShooterAnimInstance::CreateAnimInstanceProxy()
+{
+	return new FShooterAnimInstanceProxy(this);
 }
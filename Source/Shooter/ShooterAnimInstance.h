@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "WeaponType.h"
 #include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
 #include "ShooterAnimInstance.generated.h"
 
 UENUM(BlueprintType)
@@ -17,6 +18,70 @@ enum class EOffsetState : uint8
 	
 	EOS_MAX			UMETA(DisplayName = "DefaultMAX")
 };
+
+/**
+ * Snapshots the character on the game thread in PreUpdate, then works out locomotion, offset state,
+ * turn in place and lean on an anim worker thread.
+ */
+USTRUCT()
+struct FShooterAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FShooterAnimInstanceProxy() {}
+	FShooterAnimInstanceProxy(UAnimInstance* InAnimInstance) : FAnimInstanceProxy(InAnimInstance) {}
+
+protected:
+	virtual void Initialize(UAnimInstance* InAnimInstance) override;
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+	virtual void Update(float DeltaSeconds) override;
+
+private:
+	// Handle turning in place variables
+	void TurnInPlace();
+
+	// Handle calculations for leaning while running
+	void Lean(float DeltaSeconds);
+
+	float GetCurveValueAnyThread(FName CurveName) const;
+
+	// Written to during Update, the anim graph reads it after
+	class UShooterAnimInstance* ShooterAnimInstance{nullptr};
+
+	// Character state copied in PreUpdate
+	bool bHasCharacter{false};
+	FVector Velocity{FVector::ZeroVector};
+	FRotator AimRotation{FRotator::ZeroRotator};
+	FRotator ActorRotation{FRotator::ZeroRotator};
+	bool bFalling{false};
+	bool bAccelerating{false};
+	bool bAiming{false};
+	bool bCrouching{false};
+	bool bReloading{false};
+	bool bEquipping{false};
+	bool bShouldUseFABRIK{false};
+	bool bHasEquippedWeapon{false};
+	EWeaponType EquippedWeaponType{EWeaponType::EWT_MAX};
+
+	// Yaw of the character this frame, only updated when standing still & not in air(TIP: TurnInPlace)
+	float TIPCharacterYaw{0.f};
+
+	// Yaw of the character the previous frame, only updated when standing still & not in air(TIP: TurnInPlace)
+	float TIPCharacterYawLastFrame{0.f};
+
+	// RotationCurve value this frame
+	float RotationCurve{0.f};
+
+	// RotationCurve value last frame
+	float RotationCurveLastFrame{0.f};
+
+	// Rotation of the character this frame
+	FRotator CharacterRotation{FRotator::ZeroRotator};
+
+	// Rotation of the character the previous frame
+	FRotator CharacterRotationLastFrame{FRotator::ZeroRotator};
+};
+
 /**
  * 
  */
@@ -28,19 +93,19 @@ class SHOOTER_API UShooterAnimInstance : public UAnimInstance
 public:
 	UShooterAnimInstance();
 	
-	UFUNCTION(BlueprintCallable)
-	void UpdateAnimationProperties(float DeltaTime); // This is like tick function in actor classes.
+	// Properties are updated by FShooterAnimInstanceProxy on a worker thread, this does nothing now
+	UFUNCTION(BlueprintCallable, meta = (DeprecatedFunction, DeprecationMessage = "Properties are updated natively, remove this call"))
+	void UpdateAnimationProperties(float DeltaTime);
 	
 	virtual void NativeInitializeAnimation() override; // This is like BeginPlay() in actor classes.
 
 protected:
-	// Handle turning in place variables
-	void TurnInPlace();
-
-	// Handle calculations for leaning while running
-	void Lean(float DeltaTime);
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
 	
 private:
+	friend struct FShooterAnimInstanceProxy;
+
+
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	class AShooterCharacter* ShooterCharacter;
 
@@ -67,21 +132,9 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Movement, meta = (AllowPrivateAccess = "true"))
 	bool bAiming;
 
-	// Yaw of the character this frame, only updated when standing still & not in air(TIP: TurnInPlace)
-	float TIPCharacterYaw;
-
-	// Yaw of the character the previous frame, only updated when standing still & not in air(TIP: TurnInPlace)
-	float TIPCharacterYawLastFrame;
-
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = TurnInPlace, meta = (AllowPrivateAccess = "true"))
 	float RootYawOffset;
 
-	// RotationCurve value this frame
-	float RotationCurve;
-
-	// RotationCurve value last frame
-	float RotationCurveLastFrame;
-
 	// The pitch for aim rotation used for AimOffset
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = TurnInPlace, meta = (AllowPrivateAccess = "true"))
 	float Pitch;
@@ -94,12 +147,6 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = TurnInPlace, meta = (AllowPrivateAccess = "true"))
 	EOffsetState OffsetState;
 
-	// Rotation of the character this frame
-	FRotator CharacterRotation;
-	
-	// Rotation of the character the previous frame
-	FRotator CharacterRotationLastFrame;
-
 	// YawDelta used for leaning in the RunningBlendspace
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = Lean, meta = (AllowPrivateAccess = "true"))
 	float YawDelta;
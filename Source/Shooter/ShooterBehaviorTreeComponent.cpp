@@ -0,0 +1,29 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterBehaviorTreeComponent.h"
+
+#include "ShooterStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Behavior Tree Ticks Skipped"), STAT_BehaviorTreeTicksSkipped, STATGROUP_Shooter);
+
+void UShooterBehaviorTreeComponent::TickComponent(float DeltaTime, ELevelTick TickType,
+	FActorComponentTickFunction* ThisTickFunction)
+{
+	SkippedDeltaTime += DeltaTime;
+	if (SkippedDeltaTime < ThrottleInterval)
+	{
+		INC_DWORD_STAT(STAT_BehaviorTreeTicksSkipped);
+		return;
+	}
+
+	// Latent tasks and services see the time that really passed
+	const float TreeDeltaTime{SkippedDeltaTime};
+	SkippedDeltaTime = 0.f;
+	Super::TickComponent(TreeDeltaTime, TickType, ThisTickFunction);
+}
+
+void UShooterBehaviorTreeComponent::SetThrottleInterval(float Interval)
+{
+	ThrottleInterval = FMath::Max(Interval, 0.f);
+}
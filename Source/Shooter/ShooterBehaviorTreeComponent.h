@@ -0,0 +1,32 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "ShooterBehaviorTreeComponent.generated.h"
+
+/**
+ * Behavior tree component that can be throttled. The tree schedules its own tick interval every time it
+ * ticks, so SetComponentTickInterval is overwritten straight away. Instead, a throttled tree skips ticks
+ * until ThrottleInterval has passed and then ticks once with all the time it skipped.
+ */
+UCLASS()
+class SHOOTER_API UShooterBehaviorTreeComponent : public UBehaviorTreeComponent
+{
+	GENERATED_BODY()
+
+public:
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Least time between two ticks of the tree, 0 ticks whenever the tree asks to
+	void SetThrottleInterval(float Interval);
+
+	FORCEINLINE float GetThrottleInterval() const { return ThrottleInterval; }
+
+private:
+	float ThrottleInterval{0.f};
+
+	// Time skipped since the tree last ticked
+	float SkippedDeltaTime{0.f};
+};
@@ -0,0 +1,902 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterBenchmarkSubsystem.h"
+
+#include "Ammo.h"
+#include "BulletHitInterface.h"
+#include "Enemy.h"
+#include "EnemyProximitySubsystem.h"
+#include "EnemySignificanceSubsystem.h"
+#include "Explosive.h"
+#include "HitNumberLayer.h"
+#include "Shooter.h"
+#include "ShooterCharacter.h"
+#include "ShooterEventLogSubsystem.h"
+#include "ShooterPlayerController.h"
+#include "ShooterRandomSubsystem.h"
+#include "Weapon.h"
+#include "BehaviorTree/BehaviorTree.h"
+#include "Blueprint/UserWidget.h"
+#include "CoreGlobals.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace ShooterBenchmark
+{
+	static const TCHAR* ScenarioNames[] =
+	{
+		TEXT("Weapons"),
+		TEXT("Enemies"),
+		TEXT("Items"),
+		TEXT("ItemsTicking"),
+		TEXT("PickupWidgets"),
+		TEXT("PickupPrompt"),
+		TEXT("HitNumbers"),
+		TEXT("Explosives"),
+		TEXT("ProximitySpheres"),
+		TEXT("ProximitySubsystem"),
+		TEXT("BehaviorTreeBlueprint"),
+		TEXT("BehaviorTreeNative"),
+		TEXT("Significance200"),
+		TEXT("Significance500"),
+		TEXT("Significance1000")
+	};
+	static_assert(UE_ARRAY_COUNT(ScenarioNames) == static_cast<int32>(EShooterBenchmark::MAX), "Missing scenario name");
+
+	static void Run(const TArray<FString>& Args, UWorld* World)
+	{
+		UShooterBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UShooterBenchmarkSubsystem>() : nullptr;
+		if (Benchmark)
+		{
+			Benchmark->QueueBenchmarks(Args.Num() > 0 ? Args : TArray<FString>{TEXT("All")});
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs RunCommand(
+		TEXT("Shooter.Benchmark"),
+		TEXT("Runs benchmark scenarios around the player and writes their frame timings to CSV. Shooter.Benchmark <Weapons|Enemies|Items|ItemsTicking|PickupWidgets|PickupPrompt|HitNumbers|Explosives|ProximitySpheres|ProximitySubsystem|BehaviorTreeBlueprint|BehaviorTreeNative|Significance200|Significance500|Significance1000|All>"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&Run));
+}
+
+void FShooterBenchmarkPhysicsTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType,
+	ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (!Subsystem) return;
+
+	if (bPhysicsStart)
+	{
+		Subsystem->PhysicsStartCycles = FPlatformTime::Cycles64();
+	}
+	else if (Subsystem->PhysicsStartCycles != 0)
+	{
+		Subsystem->PhysicsCycles += FPlatformTime::Cycles64() - Subsystem->PhysicsStartCycles;
+		Subsystem->PhysicsStartCycles = 0;
+	}
+}
+
+FString FShooterBenchmarkPhysicsTickFunction::DiagnosticMessage()
+{
+	return bPhysicsStart ? TEXT("ShooterBenchmark[PhysicsStart]") : TEXT("ShooterBenchmark[PhysicsEnd]");
+}
+
+void UShooterBenchmarkSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	FParse::Value(FCommandLine::Get(), TEXT("ShooterBenchmarkSeed="), Seed);
+
+	// Headless runs, e.g. -nullrhi -unattended -ShooterBenchmark=Enemies,Items
+	FString ScenarioList;
+	if (GetWorld()->IsGameWorld() && FParse::Value(FCommandLine::Get(), TEXT("ShooterBenchmark="), ScenarioList, false))
+	{
+		TArray<FString> ScenarioNames;
+		ScenarioList.ParseIntoArray(ScenarioNames, TEXT(","));
+		bExitWhenDone = true;
+		if (!QueueBenchmarks(ScenarioNames))
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+}
+
+void UShooterBenchmarkSubsystem::Deinitialize()
+{
+	if (bStarted)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("Benchmark world went away with %d scenarios left"), Scenarios.Num());
+		FinishBenchmarks();
+	}
+
+	Super::Deinitialize();
+}
+
+void UShooterBenchmarkSubsystem::Tick(float DeltaTime)
+{
+	if (!bStarted)
+	{
+		// Wait for the player to spawn
+		const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+		AShooterCharacter* PlayerCharacter = PlayerController ? Cast<AShooterCharacter>(PlayerController->GetPawn()) : nullptr;
+		if (PlayerCharacter)
+		{
+			StartBenchmarks(PlayerCharacter);
+		}
+		return;
+	}
+
+	TickScenario(DeltaTime);
+}
+
+bool UShooterBenchmarkSubsystem::IsTickable() const
+{
+	return Scenarios.Num() > 0 && !IsTemplate();
+}
+
+TStatId UShooterBenchmarkSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UShooterBenchmarkSubsystem, STATGROUP_Tickables);
+}
+
+void UShooterBenchmarkSubsystem::GetScenarioNames(TArray<FString>& OutNames)
+{
+	for (const TCHAR* Name : ShooterBenchmark::ScenarioNames)
+	{
+		OutNames.Add(Name);
+	}
+}
+
+bool UShooterBenchmarkSubsystem::QueueBenchmarks(const TArray<FString>& ScenarioNames)
+{
+	TArray<EShooterBenchmark> NewScenarios;
+	for (const FString& Name : ScenarioNames)
+	{
+		if (Name == TEXT("All"))
+		{
+			for (int32 i = 0; i < static_cast<int32>(EShooterBenchmark::MAX); ++i)
+			{
+				NewScenarios.Add(static_cast<EShooterBenchmark>(i));
+			}
+			continue;
+		}
+
+		int32 Scenario{INDEX_NONE};
+		for (int32 i = 0; i < static_cast<int32>(EShooterBenchmark::MAX); ++i)
+		{
+			if (Name == ShooterBenchmark::ScenarioNames[i])
+			{
+				Scenario = i;
+				break;
+			}
+		}
+		if (Scenario == INDEX_NONE)
+		{
+			UE_LOG(LogShooter, Error, TEXT("Unknown benchmark scenario %s"), *Name);
+			return false;
+		}
+		NewScenarios.Add(static_cast<EShooterBenchmark>(Scenario));
+	}
+
+	Scenarios.Append(NewScenarios);
+	return true;
+}
+
+void UShooterBenchmarkSubsystem::StartBenchmarks(AShooterCharacter* InCharacter)
+{
+	UWorld* World = GetWorld();
+	bStarted = true;
+	Character = InCharacter;
+	StartTransform = Character->GetActorTransform();
+
+	// The player has to survive the crowds
+	Character->SetCanBeDamaged(false);
+
+	bSavedUseFixedTimeStep = FApp::UseFixedTimeStep();
+	SavedFixedDeltaTime = FApp::GetFixedDeltaTime();
+	FApp::SetUseFixedTimeStep(true);
+	FApp::SetFixedDeltaTime(1.0 / FMath::Max(FixedFrameRate, 1.f));
+
+	// Bracket the engine's own physics tick functions
+	PhysicsStartTick.Subsystem = this;
+	PhysicsStartTick.bPhysicsStart = true;
+	PhysicsStartTick.bCanEverTick = true;
+	PhysicsStartTick.TickGroup = TG_StartPhysics;
+	PhysicsStartTick.RegisterTickFunction(World->PersistentLevel);
+	World->StartPhysicsTickFunction.AddPrerequisite(this, PhysicsStartTick);
+
+	PhysicsEndTick.Subsystem = this;
+	PhysicsEndTick.bPhysicsStart = false;
+	PhysicsEndTick.bCanEverTick = true;
+	PhysicsEndTick.TickGroup = TG_EndPhysics;
+	PhysicsEndTick.RegisterTickFunction(World->PersistentLevel);
+	PhysicsEndTick.AddPrerequisite(World, World->EndPhysicsTickFunction);
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(
+		this, &UShooterBenchmarkSubsystem::OnPreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(
+		this, &UShooterBenchmarkSubsystem::OnPostGarbageCollect);
+
+	StartScenario();
+}
+
+void UShooterBenchmarkSubsystem::StartScenario()
+{
+	UE_LOG(LogShooter, Log, TEXT("Benchmark %s started with seed %d"),
+		ShooterBenchmark::ScenarioNames[static_cast<int32>(Scenarios[0])], Seed);
+
+	// Same numbers on every run
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+	RandomStream.Initialize(Seed);
+	UShooterRandomSubsystem* Random = GetWorld()->GetSubsystem<UShooterRandomSubsystem>();
+	if (Random)
+	{
+		Random->SetSeed(Seed);
+	}
+	UShooterEventLogSubsystem* EventLog = GetWorld()->GetSubsystem<UShooterEventLogSubsystem>();
+	if (EventLog)
+	{
+		EventLog->ResetEvents();
+	}
+
+	Character->SetActorTransform(StartTransform, false, nullptr, ETeleportType::TeleportPhysics);
+	if (AController* PlayerController = Character->GetController())
+	{
+		PlayerController->SetControlRotation(StartTransform.Rotator());
+	}
+
+	Samples.Reset();
+	ScenarioTime = 0.f;
+	CurrentWeaponType = INDEX_NONE;
+	NextExplosive = 0;
+	NextShotTime = 0.f;
+	NextHitEnemy = 0;
+	PhysicsCycles = 0;
+	GCCycles = 0;
+	LastSampleSeconds = FPlatformTime::Seconds();
+	StartUsedMemory = FPlatformMemory::GetStats().UsedPhysical;
+
+	switch (Scenarios[0])
+	{
+	case EShooterBenchmark::Enemies:
+		SpawnEnemies(NumEnemies, StartTransform.GetLocation(), EnemySpawnRadius);
+		break;
+	case EShooterBenchmark::Items:
+		SpawnItems(NumItems);
+		break;
+	case EShooterBenchmark::ItemsTicking:
+		// Items pick the mode up when they spawn
+		OverrideConsoleVariable(TEXT("Shooter.Items.GlowSubsystem"), 0);
+		SpawnItems(NumItems);
+		break;
+	case EShooterBenchmark::PickupWidgets:
+	case EShooterBenchmark::PickupPrompt:
+		SpawnPickupWidgetItems(Scenarios[0] == EShooterBenchmark::PickupWidgets);
+		break;
+	case EShooterBenchmark::HitNumbers:
+		StartHitNumbers();
+		break;
+	case EShooterBenchmark::Explosives:
+		SpawnExplosives();
+		break;
+	case EShooterBenchmark::ProximitySpheres:
+	case EShooterBenchmark::ProximitySubsystem:
+		SpawnProximityCrowd(Scenarios[0] == EShooterBenchmark::ProximitySpheres);
+		break;
+	case EShooterBenchmark::BehaviorTreeBlueprint:
+		SpawnBehaviorTreeCrowd(BlueprintBehaviorTree);
+		break;
+	case EShooterBenchmark::BehaviorTreeNative:
+		if (NativeBehaviorTree.IsNull())
+		{
+			UE_LOG(LogShooter, Warning, TEXT("No benchmark NativeBehaviorTree in DefaultGame.ini, running the Blueprint tree"));
+		}
+		SpawnBehaviorTreeCrowd(NativeBehaviorTree);
+		break;
+	case EShooterBenchmark::Significance200:
+		SpawnEnemies(200, StartTransform.GetLocation(), EnemySpawnRadius);
+		break;
+	case EShooterBenchmark::Significance500:
+		SpawnEnemies(500, StartTransform.GetLocation(), EnemySpawnRadius);
+		break;
+	case EShooterBenchmark::Significance1000:
+		SpawnEnemies(1000, StartTransform.GetLocation(), EnemySpawnRadius);
+		break;
+	default:
+		break;
+	}
+}
+
+void UShooterBenchmarkSubsystem::TickScenario(float DeltaTime)
+{
+	if (!IsValid(Character))
+	{
+		UE_LOG(LogShooter, Error, TEXT("Benchmark player was destroyed, stopping"));
+		FinishBenchmarks();
+		return;
+	}
+
+	RecordSample();
+	ScenarioTime += DeltaTime;
+
+	switch (Scenarios[0])
+	{
+	case EShooterBenchmark::Weapons:
+		TickWeapons();
+		break;
+	case EShooterBenchmark::Enemies:
+	case EShooterBenchmark::Items:
+	case EShooterBenchmark::ItemsTicking:
+	case EShooterBenchmark::PickupWidgets:
+	case EShooterBenchmark::PickupPrompt:
+	case EShooterBenchmark::ProximitySpheres:
+	case EShooterBenchmark::ProximitySubsystem:
+	case EShooterBenchmark::BehaviorTreeBlueprint:
+	case EShooterBenchmark::BehaviorTreeNative:
+	case EShooterBenchmark::Significance200:
+	case EShooterBenchmark::Significance500:
+	case EShooterBenchmark::Significance1000:
+		// Walk straight through the crowd or the pickups
+		Character->AddMovementInput(StartTransform.GetRotation().GetForwardVector(), 1.f);
+		break;
+	case EShooterBenchmark::Explosives:
+		TickExplosives();
+		break;
+	case EShooterBenchmark::HitNumbers:
+		TickHitNumbers(DeltaTime);
+		break;
+	default:
+		break;
+	}
+
+	const float Duration{Scenarios[0] == EShooterBenchmark::Weapons ?
+		WeaponDuration * static_cast<int32>(EWeaponType::EWT_MAX) : ScenarioDuration};
+	if (ScenarioTime >= Duration)
+	{
+		FinishScenario();
+	}
+}
+
+void UShooterBenchmarkSubsystem::FinishScenario()
+{
+	Results.Add(SummarizeSamples());
+	WriteSamples();
+
+	Character->FireButtonReleased();
+	if (IsValid(OriginalWeapon) && Character->GetEquippedWeapon() != OriginalWeapon)
+	{
+		Character->SwapWeapon(OriginalWeapon);
+	}
+	OriginalWeapon = nullptr;
+
+	for (AActor* Actor : SpawnedActors)
+	{
+		if (!IsValid(Actor)) continue;
+
+		// Enemies take their controllers with them
+		const APawn* Pawn = Cast<APawn>(Actor);
+		if (Pawn && Pawn->GetController())
+		{
+			Pawn->GetController()->Destroy();
+		}
+		Actor->Destroy();
+	}
+	SpawnedActors.Reset();
+	Explosives.Reset();
+	RestoreConsoleVariables();
+
+	Scenarios.RemoveAt(0);
+	if (Scenarios.Num() > 0)
+	{
+		StartScenario();
+	}
+	else
+	{
+		FinishBenchmarks();
+	}
+}
+
+void UShooterBenchmarkSubsystem::FinishBenchmarks()
+{
+	UWorld* World = GetWorld();
+	if (PhysicsStartTick.IsTickFunctionRegistered())
+	{
+		World->StartPhysicsTickFunction.RemovePrerequisite(this, PhysicsStartTick);
+		PhysicsStartTick.UnRegisterTickFunction();
+	}
+	if (PhysicsEndTick.IsTickFunctionRegistered())
+	{
+		PhysicsEndTick.UnRegisterTickFunction();
+	}
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	FApp::SetUseFixedTimeStep(bSavedUseFixedTimeStep);
+	FApp::SetFixedDeltaTime(SavedFixedDeltaTime);
+	RestoreConsoleVariables();
+
+	if (IsValid(Character))
+	{
+		Character->SetCanBeDamaged(true);
+	}
+	Character = nullptr;
+	Scenarios.Empty();
+	bStarted = false;
+
+	if (bExitWhenDone)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Benchmarks finished, exiting"));
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void UShooterBenchmarkSubsystem::TickWeapons()
+{
+	// Each weapon type gets an equal slice of the scenario
+	const int32 WeaponType{FMath::Min(FMath::FloorToInt(ScenarioTime / WeaponDuration),
+		static_cast<int32>(EWeaponType::EWT_MAX) - 1)};
+	if (WeaponType != CurrentWeaponType)
+	{
+		CurrentWeaponType = WeaponType;
+		EquipWeaponType(WeaponType);
+		return;
+	}
+
+	AWeapon* Weapon = Character->GetEquippedWeapon();
+	if (!Weapon) return;
+
+	// Keep the magazine full so the scenario measures firing, not reloading
+	const int32 MissingAmmo{Weapon->GetMagazineCapacity() - Weapon->GetAmmo()};
+	if (MissingAmmo > 0)
+	{
+		Weapon->ReloadAmmo(MissingAmmo);
+	}
+
+	// Automatic weapons keep firing while held, the others need the button pressed again
+	if (Character->GetCombatState() == ECombatState::ECS_Unoccupied)
+	{
+		Character->FireButtonReleased();
+		Character->FireButtonPressed();
+	}
+}
+
+void UShooterBenchmarkSubsystem::TickExplosives()
+{
+	// Set them off one after another, as if each one's blast reached the next
+	while (NextExplosive < Explosives.Num() && ScenarioTime >= NextExplosive * ExplosiveChainInterval)
+	{
+		AExplosive* Explosive = Explosives[NextExplosive++];
+		if (!IsValid(Explosive)) continue;
+
+		FHitResult HitResult;
+		HitResult.Location = Explosive->GetActorLocation();
+		HitResult.ImpactPoint = HitResult.Location;
+		IBulletHitInterface::Execute_BulletHit(Explosive, HitResult, Character, Character->GetController());
+	}
+}
+
+void UShooterBenchmarkSubsystem::TickHitNumbers(float DeltaTime)
+{
+	AWeapon* Weapon = Character->GetEquippedWeapon();
+	if (!Weapon || SpawnedActors.Num() == 0) return;
+
+	// Every shot of the automatic weapon hits the next enemy in turn, the path a confirmed hit takes
+	const float FireInterval{FMath::Max(Weapon->GetAutoFireRate(), 0.01f)};
+	NextShotTime -= DeltaTime;
+	while (NextShotTime <= 0.f)
+	{
+		NextShotTime += FireInterval;
+
+		AEnemy* Enemy = Cast<AEnemy>(SpawnedActors[NextHitEnemy++ % SpawnedActors.Num()]);
+		if (!IsValid(Enemy)) continue;
+
+		FHitResult HitResult;
+		HitResult.Actor = Enemy;
+		HitResult.Component = Enemy->GetMesh();
+		HitResult.Location = Enemy->GetActorLocation();
+		HitResult.ImpactPoint = HitResult.Location;
+		Character->ApplyBulletHit(HitResult, 1);
+	}
+}
+
+void UShooterBenchmarkSubsystem::StartHitNumbers()
+{
+	EquipWeaponType(static_cast<int32>(EWeaponType::EWT_SubmachineGun));
+
+	// Ahead of the player so the numbers are on screen
+	const FVector CrowdCenter{StartTransform.GetLocation() +
+		StartTransform.GetRotation().GetForwardVector() * (CrowdRadius + 500.f)};
+	SpawnEnemies(NumHitNumberEnemies, CrowdCenter, CrowdRadius);
+	for (AActor* Actor : SpawnedActors)
+	{
+		AEnemy* Enemy = Cast<AEnemy>(Actor);
+		if (Enemy)
+		{
+			// Enough that no enemy dies before the scenario ends
+			Enemy->SetMaxHealth(BIG_NUMBER);
+		}
+	}
+
+	AShooterPlayerController* PlayerController = Cast<AShooterPlayerController>(Character->GetController());
+	const UHitNumberLayer* HitNumberLayer = PlayerController ? PlayerController->GetHitNumberLayer() : nullptr;
+	StartHitNumberWidgets = HitNumberLayer ? HitNumberLayer->GetNumWidgetsCreated() : 0;
+	StartHitNumberCycles = HitNumberLayer ? HitNumberLayer->GetUpdateCycles() : 0;
+}
+
+void UShooterBenchmarkSubsystem::EquipWeaponType(int32 WeaponType)
+{
+	Character->FireButtonReleased();
+
+	UClass* WeaponClass = Character->DefaultWeaponClass ? Character->DefaultWeaponClass.Get() : AWeapon::StaticClass();
+	const FTransform SpawnTransform{Character->GetActorTransform()};
+	AWeapon* Weapon = GetWorld()->SpawnActorDeferred<AWeapon>(WeaponClass, SpawnTransform);
+	if (!Weapon) return;
+
+	// The weapon data table row is picked in OnConstruction
+	Weapon->SetWeaponType(static_cast<EWeaponType>(WeaponType));
+	Weapon->FinishSpawning(SpawnTransform);
+	SpawnedActors.Add(Weapon);
+
+	if (!Character->GetEquippedWeapon())
+	{
+		Character->EquipWeapon(Weapon);
+		return;
+	}
+	if (!OriginalWeapon)
+	{
+		OriginalWeapon = Character->GetEquippedWeapon();
+	}
+	Character->SwapWeapon(Weapon);
+}
+
+void UShooterBenchmarkSubsystem::SpawnEnemies(int32 Count, const FVector& Center, float Radius, UBehaviorTree* BehaviorTree)
+{
+	if (EnemyClass.IsNull())
+	{
+		UE_LOG(LogShooter, Warning, TEXT("No benchmark EnemyClass in DefaultGame.ini, spawning AEnemy without a behavior tree"));
+	}
+	UClass* Class = EnemyClass.IsNull() ? AEnemy::StaticClass() : EnemyClass.LoadSynchronous();
+	if (!Class) return;
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const FVector Location{GetRandomPointInDisk(Center, Radius)};
+		const FRotator Rotation{0.f, RandomStream.FRandRange(-180.f, 180.f), 0.f};
+		const FTransform SpawnTransform{Rotation, Location};
+		AEnemy* Enemy = GetWorld()->SpawnActorDeferred<AEnemy>(Class, SpawnTransform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!Enemy) continue;
+
+		// The controller and BeginPlay pick the tree up once spawning finishes
+		if (BehaviorTree)
+		{
+			Enemy->SetBehaviorTree(BehaviorTree);
+		}
+		Enemy->FinishSpawning(SpawnTransform);
+
+		if (!Enemy->GetController())
+		{
+			Enemy->SpawnDefaultController();
+		}
+		SpawnedActors.Add(Enemy);
+	}
+}
+
+FVector UShooterBenchmarkSubsystem::GetRandomPointInDisk(const FVector& Center, float Radius)
+{
+	// Square root keeps the points evenly spread instead of bunched in the middle
+	const float Distance{Radius * FMath::Sqrt(RandomStream.FRand())};
+	const float Angle{RandomStream.FRandRange(0.f, 2.f * PI)};
+	return Center + FVector(FMath::Cos(Angle) * Distance, FMath::Sin(Angle) * Distance, 0.f);
+}
+
+void UShooterBenchmarkSubsystem::OverrideConsoleVariable(const TCHAR* Name, int32 Value)
+{
+	IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(Name);
+	if (!Variable) return;
+
+	if (!SavedConsoleVariables.Contains(Name))
+	{
+		SavedConsoleVariables.Add(Name, Variable->GetString());
+	}
+	Variable->Set(Value, ECVF_SetByCode);
+}
+
+void UShooterBenchmarkSubsystem::RestoreConsoleVariables()
+{
+	for (const TPair<FString, FString>& Saved : SavedConsoleVariables)
+	{
+		IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(*Saved.Key);
+		if (Variable)
+		{
+			Variable->Set(*Saved.Value, ECVF_SetByCode);
+		}
+	}
+	SavedConsoleVariables.Empty();
+}
+
+void UShooterBenchmarkSubsystem::SpawnItems(int32 Count, bool bOverridePickupWidget, TSubclassOf<UUserWidget> WidgetClass)
+{
+	UClass* Class = ItemClass.IsNull() ? AAmmo::StaticClass() : ItemClass.LoadSynchronous();
+	if (!Class) return;
+
+	// Rows across the player's path, starting just ahead of them
+	const FVector Forward{StartTransform.GetRotation().GetForwardVector()};
+	const FVector Right{StartTransform.GetRotation().GetRightVector()};
+	const int32 Columns{FMath::Max(ItemsPerRow, 1)};
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		const float Row{static_cast<float>(i / Columns + 1)};
+		const float Column{static_cast<float>(i % Columns) - (Columns - 1) * 0.5f};
+		const FVector Jitter{RandomStream.FRandRange(-0.25f, 0.25f) * ItemSpacing * Forward +
+			RandomStream.FRandRange(-0.25f, 0.25f) * ItemSpacing * Right};
+		const FVector Location{StartTransform.GetLocation() + Row * ItemSpacing * Forward +
+			Column * ItemSpacing * Right + Jitter};
+
+		// Deferred so the widget class is in place when the item begins play
+		const FTransform Transform{Location};
+		AItem* Item = GetWorld()->SpawnActorDeferred<AItem>(Class, Transform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!Item) continue;
+
+		if (bOverridePickupWidget)
+		{
+			Item->SetPickupWidgetClass(WidgetClass);
+		}
+		Item->FinishSpawning(Transform);
+		SpawnedActors.Add(Item);
+	}
+}
+
+void UShooterBenchmarkSubsystem::SpawnPickupWidgetItems(bool bOwnWidgets)
+{
+	TSubclassOf<UUserWidget> WidgetClass{nullptr};
+	if (bOwnWidgets)
+	{
+		WidgetClass = PickupWidgetClass.LoadSynchronous();
+		if (!WidgetClass)
+		{
+			UE_LOG(LogShooter, Warning, TEXT("No benchmark PickupWidgetClass in DefaultGame.ini, the pickups get no widgets"));
+		}
+	}
+	SpawnItems(NumPickupWidgetItems, true, WidgetClass);
+}
+
+void UShooterBenchmarkSubsystem::SpawnExplosives()
+{
+	// The crowd stands just ahead of the player so the player watches it go up
+	const FVector Center{StartTransform.GetLocation() +
+		StartTransform.GetRotation().GetForwardVector() * (CrowdRadius + 500.f)};
+	SpawnEnemies(NumCrowdEnemies, Center, CrowdRadius);
+
+	UClass* Class = ExplosiveClass.IsNull() ? AExplosive::StaticClass() : ExplosiveClass.LoadSynchronous();
+	if (!Class) return;
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	for (int32 i = 0; i < NumExplosives; ++i)
+	{
+		AExplosive* Explosive = GetWorld()->SpawnActor<AExplosive>(Class, GetRandomPointInDisk(Center, CrowdRadius),
+			FRotator::ZeroRotator, SpawnParams);
+		if (!Explosive) continue;
+
+		SpawnedActors.Add(Explosive);
+		Explosives.Add(Explosive);
+	}
+}
+
+void UShooterBenchmarkSubsystem::SpawnBehaviorTreeCrowd(const TSoftObjectPtr<UBehaviorTree>& BehaviorTree)
+{
+	// Loaded before spawning so the first frames don't time the load
+	SpawnEnemies(NumBehaviorTreeEnemies, StartTransform.GetLocation(), EnemySpawnRadius,
+		BehaviorTree.IsNull() ? nullptr : BehaviorTree.LoadSynchronous());
+}
+
+void UShooterBenchmarkSubsystem::SpawnProximityCrowd(bool bOverlapSpheres)
+{
+	const int32 FirstEnemy{SpawnedActors.Num()};
+	SpawnEnemies(NumProximityEnemies, StartTransform.GetLocation(), EnemySpawnRadius);
+	if (!bOverlapSpheres) return;
+
+	// Take the enemies out of the proximity subsystem and give them back the spheres they had before it
+	UEnemyProximitySubsystem* Proximity = GetWorld()->GetSubsystem<UEnemyProximitySubsystem>();
+	for (int32 i = FirstEnemy; i < SpawnedActors.Num(); ++i)
+	{
+		AEnemy* Enemy = Cast<AEnemy>(SpawnedActors[i]);
+		if (!Enemy) continue;
+
+		if (Proximity)
+		{
+			Proximity->UnregisterEnemy(Enemy);
+		}
+
+		USphereComponent* AgroSphere = AddOverlapSphere(Enemy, Enemy->GetAgroRadius());
+		AgroSphere->OnComponentBeginOverlap.AddDynamic(this, &UShooterBenchmarkSubsystem::OnAgroSphereOverlap);
+		AgroSphere->OnComponentEndOverlap.AddDynamic(this, &UShooterBenchmarkSubsystem::OnAgroSphereEndOverlap);
+
+		USphereComponent* CombatRangeSphere = AddOverlapSphere(Enemy, Enemy->GetCombatRangeRadius());
+		CombatRangeSphere->OnComponentBeginOverlap.AddDynamic(this, &UShooterBenchmarkSubsystem::OnCombatRangeSphereOverlap);
+		CombatRangeSphere->OnComponentEndOverlap.AddDynamic(this, &UShooterBenchmarkSubsystem::OnCombatRangeSphereEndOverlap);
+	}
+}
+
+USphereComponent* UShooterBenchmarkSubsystem::AddOverlapSphere(AEnemy* Enemy, float Radius)
+{
+	// Default sphere collision, as the enemy's own spheres had
+	USphereComponent* Sphere = NewObject<USphereComponent>(Enemy);
+	Sphere->SetupAttachment(Enemy->GetRootComponent());
+	Sphere->SetSphereRadius(Radius);
+	Sphere->RegisterComponent();
+	return Sphere;
+}
+
+void UShooterBenchmarkSubsystem::OnAgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	AEnemy* Enemy = Cast<AEnemy>(OverlappedComponent->GetOwner());
+	AShooterCharacter* Target = Cast<AShooterCharacter>(OtherActor);
+	if (Enemy && Target)
+	{
+		Enemy->AgroTargetEntered(Target);
+	}
+}
+
+void UShooterBenchmarkSubsystem::OnAgroSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	// Enemies kept their target, but the overlap was still reported
+}
+
+void UShooterBenchmarkSubsystem::OnCombatRangeSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	AEnemy* Enemy = Cast<AEnemy>(OverlappedComponent->GetOwner());
+	if (Enemy && Cast<AShooterCharacter>(OtherActor))
+	{
+		Enemy->SetInCombatRange(true);
+	}
+}
+
+void UShooterBenchmarkSubsystem::OnCombatRangeSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+	UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
+{
+	AEnemy* Enemy = Cast<AEnemy>(OverlappedComponent->GetOwner());
+	if (Enemy && Cast<AShooterCharacter>(OtherActor))
+	{
+		Enemy->SetInCombatRange(false);
+	}
+}
+
+void UShooterBenchmarkSubsystem::RecordSample()
+{
+	// The game thread and GC times are from the last full frame
+	const double Now{FPlatformTime::Seconds()};
+	Samples.Add({
+		ScenarioTime,
+		static_cast<float>((Now - LastSampleSeconds) * 1000.0),
+		static_cast<float>(FPlatformTime::ToMilliseconds(GGameThreadTime)),
+		static_cast<float>(FPlatformTime::ToMilliseconds64(PhysicsCycles)),
+		static_cast<float>(FPlatformTime::ToMilliseconds64(GCCycles))});
+
+	LastSampleSeconds = Now;
+	PhysicsCycles = 0;
+	GCCycles = 0;
+}
+
+FShooterBenchmarkResult UShooterBenchmarkSubsystem::SummarizeSamples() const
+{
+	FShooterBenchmarkResult Result;
+	Result.Scenario = ShooterBenchmark::ScenarioNames[static_cast<int32>(Scenarios[0])];
+	Result.NumFrames = Samples.Num();
+
+	double TotalGameThreadMs{0.0};
+	double TotalPhysicsMs{0.0};
+	double TotalGCMs{0.0};
+	for (const FSample& Sample : Samples)
+	{
+		TotalGameThreadMs += Sample.GameThreadMs;
+		TotalPhysicsMs += Sample.PhysicsMs;
+		TotalGCMs += Sample.GCMs;
+	}
+
+	const int32 NumSamples{FMath::Max(Samples.Num(), 1)};
+	Result.GameThreadMs = static_cast<float>(TotalGameThreadMs / NumSamples);
+	Result.PhysicsMs = static_cast<float>(TotalPhysicsMs / NumSamples);
+	Result.GCMs = static_cast<float>(TotalGCMs / NumSamples);
+
+	const uint64 UsedMemory{FPlatformMemory::GetStats().UsedPhysical};
+	Result.MemoryMB = static_cast<float>((static_cast<double>(UsedMemory) - static_cast<double>(StartUsedMemory)) /
+		(1024.0 * 1024.0));
+
+	if (Scenarios[0] == EShooterBenchmark::HitNumbers)
+	{
+		AShooterPlayerController* PlayerController = Cast<AShooterPlayerController>(Character->GetController());
+		const UHitNumberLayer* HitNumberLayer = PlayerController ? PlayerController->GetHitNumberLayer() : nullptr;
+		if (HitNumberLayer)
+		{
+			const double UpdateMs{FPlatformTime::ToMilliseconds64(HitNumberLayer->GetUpdateCycles() - StartHitNumberCycles)};
+			Result.Details = FString::Printf(TEXT("%d hit number widgets created, hit number update %.4f ms per frame"),
+				HitNumberLayer->GetNumWidgetsCreated() - StartHitNumberWidgets, UpdateMs / NumSamples);
+		}
+	}
+	else if (Scenarios[0] >= EShooterBenchmark::Significance200 && Scenarios[0] <= EShooterBenchmark::Significance1000)
+	{
+		const UEnemySignificanceSubsystem* Significance = GetWorld()->GetSubsystem<UEnemySignificanceSubsystem>();
+		if (Significance)
+		{
+			Result.Details = FString::Printf(TEXT("%d of %d enemies throttled at the end"),
+				Significance->GetNumThrottledEnemies(), Significance->GetNumEnemies());
+		}
+	}
+	return Result;
+}
+
+void UShooterBenchmarkSubsystem::WriteSamples() const
+{
+	const TCHAR* ScenarioName{ShooterBenchmark::ScenarioNames[static_cast<int32>(Scenarios[0])]};
+
+	FString Csv{TEXT("Time,FrameMs,GameThreadMs,PhysicsMs,GCMs\n")};
+	for (const FSample& Sample : Samples)
+	{
+		Csv += FString::Printf(TEXT("%.4f,%.3f,%.3f,%.3f,%.3f\n"),
+			Sample.Time, Sample.FrameMs, Sample.GameThreadMs, Sample.PhysicsMs, Sample.GCMs);
+	}
+
+	const FString Path{FPaths::ProfilingDir() / TEXT("ShooterBenchmark") /
+		FString::Printf(TEXT("%s_%s.csv"), ScenarioName, *FDateTime::Now().ToString())};
+	if (!FFileHelper::SaveStringToFile(Csv, *Path))
+	{
+		UE_LOG(LogShooter, Error, TEXT("Couldn't write benchmark results to %s"), *Path);
+		return;
+	}
+
+	const FShooterBenchmarkResult& Result = Results.Last();
+	UE_LOG(LogShooter, Log, TEXT("Benchmark %s: %d frames, average game thread %.3f ms, physics %.3f ms, GC %.3f ms, memory %+.1f MB, written to %s"),
+		ScenarioName, Result.NumFrames, Result.GameThreadMs, Result.PhysicsMs, Result.GCMs, Result.MemoryMB, *Path);
+	if (!Result.Details.IsEmpty())
+	{
+		UE_LOG(LogShooter, Log, TEXT("Benchmark %s: %s"), ScenarioName, *Result.Details);
+	}
+
+	// Matches between runs that played out the same
+	const UShooterRandomSubsystem* Random = GetWorld()->GetSubsystem<UShooterRandomSubsystem>();
+	if (Random)
+	{
+		UE_LOG(LogShooter, Log, TEXT("Benchmark %s random state: %s"), ScenarioName, *Random->GetStateString());
+	}
+
+	// Diff against another run's log to find where they split
+	const UShooterEventLogSubsystem* EventLog = GetWorld()->GetSubsystem<UShooterEventLogSubsystem>();
+	if (EventLog && EventLog->IsRecording())
+	{
+		const FString EventPath{FPaths::ChangeExtension(Path, TEXT("events.txt"))};
+		if (EventLog->SaveEvents(EventPath))
+		{
+			UE_LOG(LogShooter, Log, TEXT("Benchmark %s: %d gameplay events written to %s"), ScenarioName,
+				EventLog->GetEvents().Num(), *EventPath);
+		}
+	}
+}
+
+void UShooterBenchmarkSubsystem::OnPreGarbageCollect()
+{
+	GCStartCycles = FPlatformTime::Cycles64();
+}
+
+void UShooterBenchmarkSubsystem::OnPostGarbageCollect()
+{
+	if (GCStartCycles == 0) return;
+
+	GCCycles += FPlatformTime::Cycles64() - GCStartCycles;
+	GCStartCycles = 0;
+}
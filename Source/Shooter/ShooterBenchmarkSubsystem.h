@@ -0,0 +1,356 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Engine/EngineTypes.h"
+#include "Math/RandomStream.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterBenchmarkSubsystem.generated.h"
+
+class AEnemy;
+class AExplosive;
+class AItem;
+class AShooterCharacter;
+class UBehaviorTree;
+class UPrimitiveComponent;
+class UUserWidget;
+
+enum class EShooterBenchmark : uint8
+{
+	// The player fires each weapon type continuously
+	Weapons,
+	// A crowd of enemies patrols and chases the player walking through it
+	Enemies,
+	// The player walks through a field of pickups
+	Items,
+	// The same field with every pickup ticking and pulsing itself, as before the glow subsystem
+	ItemsTicking,
+	// The player walks through pickups that each have their own pickup widget component
+	PickupWidgets,
+	// The same pickups without widgets, found by the player controller's shared prompt
+	PickupPrompt,
+	// The player fires an automatic weapon at a crowd of enemies that can't die, showing a hit number per shot
+	HitNumbers,
+	// Explosives go off one after another in a crowd of enemies
+	Explosives,
+	// The player walks through enemies that find it with agro and combat range overlap spheres, as before
+	// the proximity subsystem
+	ProximitySpheres,
+	// The same crowd found by the proximity subsystem
+	ProximitySubsystem,
+	// A crowd of enemies running the Blueprint behavior tree chases the player
+	BehaviorTreeBlueprint,
+	// The same crowd running the tree made of native nodes
+	BehaviorTreeNative,
+	// The player walks through crowds of 200, 500 and 1000 enemies that the significance subsystem throttles
+	Significance200,
+	Significance500,
+	Significance1000,
+
+	MAX
+};
+
+// Averages over the frames of one finished scenario, in milliseconds
+struct FShooterBenchmarkResult
+{
+	FString Scenario;
+	int32 NumFrames{0};
+	float GameThreadMs{0.f};
+	float PhysicsMs{0.f};
+	float GCMs{0.f};
+	// Growth in used physical memory from the start of the scenario to its end
+	float MemoryMB{0.f};
+	// Measurements only this scenario takes, empty for most
+	FString Details;
+};
+
+// Marks the start or end of the physics tick groups for the benchmark timings
+struct FShooterBenchmarkPhysicsTickFunction : public FTickFunction
+{
+	class UShooterBenchmarkSubsystem* Subsystem{nullptr};
+
+	bool bPhysicsStart{false};
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread,
+		const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+/**
+ * Runs repeatable combat scenarios around the local player with a fixed timestep and a fixed seed, and
+ * writes the game thread, physics and garbage collection time of every frame to a CSV in the profiling
+ * directory. Start it with "Shooter.Benchmark <Scenario|All>", or headless with
+ * "-nullrhi -unattended -ShooterBenchmark=All", which quits once the last scenario is written. With
+ * -ShooterEventLog each scenario's gameplay events are written next to its CSV. The
+ * Shooter.Benchmark automation tests run each scenario in AutomationMap. Meant for an open, flat map.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UShooterBenchmarkSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override { return ETickableTickType::Conditional; }
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+
+	// Queues scenarios by name, "All" queues every scenario. Returns false if a name isn't known
+	bool QueueBenchmarks(const TArray<FString>& ScenarioNames);
+
+	FORCEINLINE bool IsRunning() const { return Scenarios.Num() > 0; }
+
+	// Every scenario name QueueBenchmarks knows, besides "All"
+	static void GetScenarioNames(TArray<FString>& OutNames);
+
+	// Scenarios finished in this world, oldest first
+	FORCEINLINE const TArray<FShooterBenchmarkResult>& GetResults() const { return Results; }
+
+	FORCEINLINE const FString& GetAutomationMap() const { return AutomationMap; }
+	FORCEINLINE const TSoftClassPtr<AEnemy>& GetEnemyClass() const { return EnemyClass; }
+
+private:
+	friend struct FShooterBenchmarkPhysicsTickFunction;
+
+	// Timings of one frame, all in milliseconds
+	struct FSample
+	{
+		float Time;
+		float FrameMs;
+		float GameThreadMs;
+		float PhysicsMs;
+		float GCMs;
+	};
+
+	// Takes over the player, the timestep and the timings until the queue is empty
+	void StartBenchmarks(AShooterCharacter* InCharacter);
+
+	void StartScenario();
+	void TickScenario(float DeltaTime);
+	void FinishScenario();
+
+	// Restores the timestep and stops timing once the queue is empty
+	void FinishBenchmarks();
+
+	void TickWeapons();
+	void TickExplosives();
+	void TickHitNumbers(float DeltaTime);
+
+	// Spawns the hit number crowd ahead of the player and arms it with an automatic weapon
+	void StartHitNumbers();
+
+	// Gives the player a weapon of the type, spawned from its default weapon class
+	void EquipWeaponType(int32 WeaponType);
+
+	// Spawns enemies with controllers at random points in a disk, running BehaviorTree instead of their own if set
+	void SpawnEnemies(int32 Count, const FVector& Center, float Radius, UBehaviorTree* BehaviorTree = nullptr);
+
+	FVector GetRandomPointInDisk(const FVector& Center, float Radius);
+
+	// Sets a console variable for the running scenario, FinishScenario puts it back
+	void OverrideConsoleVariable(const TCHAR* Name, int32 Value);
+	void RestoreConsoleVariables();
+
+	// Lays out pickups ahead of the player. With bOverridePickupWidget they get WidgetClass, or no widget
+	// if it's null, instead of their class' own
+	void SpawnItems(int32 Count, bool bOverridePickupWidget = false, TSubclassOf<UUserWidget> WidgetClass = nullptr);
+
+	// Spawns the pickup widget comparison's items, with or without their own widgets
+	void SpawnPickupWidgetItems(bool bOwnWidgets);
+	void SpawnExplosives();
+
+	// Spawns the behavior tree crowd with the tree from the config
+	void SpawnBehaviorTreeCrowd(const TSoftObjectPtr<UBehaviorTree>& BehaviorTree);
+
+	// Spawns the proximity crowd, with the old overlap spheres instead of the proximity subsystem if asked
+	void SpawnProximityCrowd(bool bOverlapSpheres);
+
+	class USphereComponent* AddOverlapSphere(AEnemy* Enemy, float Radius);
+
+	// What the enemies did on the old sphere overlaps
+	UFUNCTION()
+	void OnAgroSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnAgroSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	UFUNCTION()
+	void OnCombatRangeSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	UFUNCTION()
+	void OnCombatRangeSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor,
+		UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
+
+	void RecordSample();
+	FShooterBenchmarkResult SummarizeSamples() const;
+	void WriteSamples() const;
+
+	void OnPreGarbageCollect();
+	void OnPostGarbageCollect();
+
+	// Scenarios left to run, the first one is running once Character is set
+	TArray<EShooterBenchmark> Scenarios;
+
+	UPROPERTY()
+	AShooterCharacter* Character;
+
+	// Everything spawned for the running scenario, destroyed when it ends
+	UPROPERTY()
+	TArray<AActor*> SpawnedActors;
+
+	UPROPERTY()
+	TArray<AExplosive*> Explosives;
+
+	// Weapon the player had before the weapon scenario, handed back afterwards
+	UPROPERTY()
+	class AWeapon* OriginalWeapon;
+
+	// Where the player was when the benchmarks started, every scenario starts from here
+	FTransform StartTransform;
+
+	FRandomStream RandomStream;
+
+	TArray<FSample> Samples;
+
+	TArray<FShooterBenchmarkResult> Results;
+
+	// Values of the console variables the running scenario overrides, from before it started
+	TMap<FString, FString> SavedConsoleVariables;
+
+	float ScenarioTime{0.f};
+
+	int32 CurrentWeaponType{INDEX_NONE};
+
+	int32 NextExplosive{0};
+
+	// Time until the next shot of the hit number scenario, and the enemy it hits
+	float NextShotTime{0.f};
+	int32 NextHitEnemy{0};
+
+	// Hit number layer totals from the start of the scenario
+	int32 StartHitNumberWidgets{0};
+	uint64 StartHitNumberCycles{0};
+
+	// Quit when the queue is empty, set when started from the command line
+	bool bExitWhenDone{false};
+
+	// Set once the player has been found and the timestep changed
+	bool bStarted{false};
+
+	// Timestep settings to restore afterwards
+	bool bSavedUseFixedTimeStep{false};
+	double SavedFixedDeltaTime{0.0};
+
+	FShooterBenchmarkPhysicsTickFunction PhysicsStartTick;
+	FShooterBenchmarkPhysicsTickFunction PhysicsEndTick;
+
+	uint64 PhysicsStartCycles{0};
+	uint64 PhysicsCycles{0};
+	uint64 GCStartCycles{0};
+	uint64 GCCycles{0};
+	double LastSampleSeconds{0.0};
+	uint64 StartUsedMemory{0};
+
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+
+	// Map the automation tests run the scenarios in
+	UPROPERTY(config)
+	FString AutomationMap{TEXT("/Game/_Game/Maps/ShooterTemple")};
+
+	// Frames per simulated second, the timestep is fixed while a scenario runs
+	UPROPERTY(config)
+	float FixedFrameRate{60.f};
+
+	// Seeds the gameplay random streams, FMath's random numbers and the placement of everything spawned.
+	// -ShooterBenchmarkSeed= overrides it
+	UPROPERTY(config)
+	int32 Seed{1234};
+
+	// Time spent firing each weapon type
+	UPROPERTY(config)
+	float WeaponDuration{60.f};
+
+	// Length of the enemy, item and explosive scenarios
+	UPROPERTY(config)
+	float ScenarioDuration{60.f};
+
+	// Enemy spawned for the enemy and explosive scenarios
+	UPROPERTY(config)
+	TSoftClassPtr<AEnemy> EnemyClass;
+
+	UPROPERTY(config)
+	int32 NumEnemies{500};
+
+	UPROPERTY(config)
+	float EnemySpawnRadius{5000.f};
+
+	// Pickup spawned for the item scenario
+	UPROPERTY(config)
+	TSoftClassPtr<AItem> ItemClass;
+
+	UPROPERTY(config)
+	int32 NumItems{5000};
+
+	// Items are laid out in rows of this many ahead of the player
+	UPROPERTY(config)
+	int32 ItemsPerRow{10};
+
+	UPROPERTY(config)
+	float ItemSpacing{200.f};
+
+	// Pickups in each pickup widget scenario
+	UPROPERTY(config)
+	int32 NumPickupWidgetItems{500};
+
+	// Widget every pickup gets in the PickupWidgets scenario
+	UPROPERTY(config)
+	TSoftClassPtr<UUserWidget> PickupWidgetClass;
+
+	UPROPERTY(config)
+	TSoftClassPtr<AExplosive> ExplosiveClass;
+
+	UPROPERTY(config)
+	int32 NumExplosives{20};
+
+	// Enemies crowded around the explosives
+	UPROPERTY(config)
+	int32 NumCrowdEnemies{100};
+
+	UPROPERTY(config)
+	float CrowdRadius{1500.f};
+
+	// Enemies in each proximity scenario, spread over EnemySpawnRadius
+	UPROPERTY(config)
+	int32 NumProximityEnemies{500};
+
+	// Enemies in each behavior tree scenario, spread over EnemySpawnRadius
+	UPROPERTY(config)
+	int32 NumBehaviorTreeEnemies{300};
+
+	// Tree made of Blueprint nodes, EnemyClass' own tree if not set
+	UPROPERTY(config)
+	TSoftObjectPtr<UBehaviorTree> BlueprintBehaviorTree;
+
+	// The same tree with its nodes swapped for the native ones
+	UPROPERTY(config)
+	TSoftObjectPtr<UBehaviorTree> NativeBehaviorTree;
+
+	// Enemies the player shoots in the hit number scenario
+	UPROPERTY(config)
+	int32 NumHitNumberEnemies{50};
+
+	// Time between one explosive going off and the next
+	UPROPERTY(config)
+	float ExplosiveChainInterval{0.25f};
+};
@@ -8,15 +8,24 @@
 #include "DrawDebugHelpers.h"
 #include "Enemy.h"
 #include "EnemyController.h"
+#include "HitscanSubsystem.h"
+#include "ItemPoolSubsystem.h"
+#include "ItemSpatialSubsystem.h"
+#include "LagCompensationSubsystem.h"
+#include "ParticlePoolSubsystem.h"
+#include "ShooterEventLogSubsystem.h"
+#include "ShooterPlayerController.h"
 #include "Camera/CameraComponent.h"
+#include "Camera/PlayerCameraManager.h"
 #include "Engine/SkeletalMeshSocket.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/GameStateBase.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Sound/SoundCue.h"
 #include "Item.h"
-//#include "Shooter.h"
+#include "Shooter.h"
 #include "Weapon.h"
 #include "BehaviorTree/BlackboardComponent.h"
 //#include "Components/BoxComponent.h"
@@ -24,6 +33,20 @@
 //#include "Components/SphereComponent.h"
 #include "Components/WidgetComponent.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
+#include "ShooterStats.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Traces Saved"), STAT_CrosshairTracesSaved, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Crosshair Traces"), STAT_CrosshairTraces, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Character Tick"), STAT_CharacterTick, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Fire Shots"), STAT_FireShots, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Send Bullet"), STAT_SendBullet, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Resolve Bullet"), STAT_ResolveBullet, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Trace For Items"), STAT_TraceForItems, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Character Take Damage"), STAT_CharacterTakeDamage, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Reconcile Actions"), STAT_ReconcileActions, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Predicted Actions"), STAT_PredictedActions, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Prediction Rollbacks"), STAT_PredictionRollbacks, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Server Shots Dropped"), STAT_ServerShotsDropped, STATGROUP_Shooter);
 
 // Sets default values
 AShooterCharacter::AShooterCharacter() :
@@ -59,8 +82,15 @@ bFiringBullet(false),
 // Automatic fire variables
 bFireButtonPressed(false),
 bShouldFire(true),
+FireCooldownRemaining(0.f),
+MaxShotsPerTick(8),
+LastServerShotTime(-BIG_NUMBER),
+ServerFireTolerance(0.1f),
 // Item trace variables
 bShouldTraceForItems(false),
+ItemQueryRange(700.f),
+ItemQueryAngle(8.f),
+bItemQueryCandidateVisible(false),
 OverlappedItemCount(0),
 // Camera interp location variables
 CameraInterpDistance(150.f),
@@ -165,6 +195,36 @@ void AShooterCharacter::BeginPlay()
 
 	// Create FInterpLocation structs for each interp location, add to array
 	InitializeInterpLocations();
+
+	// Pre-warm pooled components for the effects spawned on every shot
+	UParticlePoolSubsystem* ParticlePool = GetWorld()->GetSubsystem<UParticlePoolSubsystem>();
+	if (ParticlePool)
+	{
+		ParticlePool->PrewarmPool(ImpactParticles);
+		ParticlePool->PrewarmPool(BeamParticles);
+		if (EquippedWeapon)
+		{
+			ParticlePool->PrewarmPool(EquippedWeapon->GetMuzzleFlash());
+		}
+	}
+
+	// Servers keep our hitbox history for confirming other players' shots
+	ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+	if (LagCompensation)
+	{
+		LagCompensation->RegisterCharacter(this);
+	}
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+	if (LagCompensation)
+	{
+		LagCompensation->UnregisterCharacter(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AShooterCharacter::MoveForward(float Value)
@@ -237,56 +297,42 @@ void AShooterCharacter::LookUp(float Value)
 
 void AShooterCharacter::FireWeapon()
 {
-	if (CombatState != ECombatState::ECS_Unoccupied) return;
+	if (CombatState != ECombatState::ECS_Unoccupied || !HasPredictionRoom()) return;
 	if (WeaponHasAmmo())
 	{
-		PlayFireSound();
-		SendBullet();
-		PlayGunfireMontage();
-		EquippedWeapon->DecrementAmmo();
-		
+		FireShots(1, 0.f);
 		StartFireTimer();
-		// Start bullet fire timer for crosshairs
-		StartCrosshairBulletFire();
-
-		if (EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol)
-		{
-			// Start moving slide timer
-			EquippedWeapon->StartSlideTimer();
-		}
 	}	
 }
 
-bool AShooterCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation, FHitResult& OutHitResult)
+void AShooterCharacter::FireShots(int32 NumShots, float ShotAge)
 {
-	FVector OutBeamLocation;
-	// Check for crosshair trace hit
-	FHitResult CrosshairHitResult;
-	bool bCrosshairHit = TraceUnderCrosshairs(CrosshairHitResult, OutBeamLocation);
-
-	if (bCrosshairHit)
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_FireShots, Weapons);
+	PlayFireSound();
+	for (int32 i = 0; i < NumShots; ++i)
 	{
-		// Tentative beam location - Still need to trace from gun barrel
-		OutBeamLocation = CrosshairHitResult.Location;
+		EquippedWeapon->DecrementAmmo();
 	}
-	else // No crosshair trace hit
+
+	// Owning clients don't wait for the server, it acks the shots with its own ammo count
+	const uint16 Sequence{PredictAction(EShooterActionType::Fire, NumShots)};
+	if (Sequence != 0)
 	{
-		// OutBeamLocation is the end location for the line trace
+		// Sent now rather than once an async trace comes back, so the server gets the shots in order with
+		// reloads and swaps, and rewinds to what was on screen now
+		ServerFire(Sequence, static_cast<uint8>(FMath::Clamp(NumShots, 1, 255)), GetServerWorldTimeSeconds());
 	}
+	SendBullet(NumShots, Sequence);
+	PlayGunfireMontage();
 
-	// Perform a second trace, this time from the gun barrel
-	const FVector WeaponTraceStart{MuzzleSocketLocation};
-	const FVector StartToEnd{OutBeamLocation - MuzzleSocketLocation};
-	const FVector WeaponTraceEnd{OutBeamLocation + StartToEnd * 1.25f};
+	// Start bullet fire timer for crosshairs
+	StartCrosshairBulletFire(ShotAge);
 
-	GetWorld()->LineTraceSingleByChannel(OutHitResult, WeaponTraceStart, WeaponTraceEnd,
-										 ECollisionChannel::ECC_Visibility);
-	if (!OutHitResult.bBlockingHit) // if there is not an object between the barrel and beam end point
+	if (EquippedWeapon->GetWeaponType() == EWeaponType::EWT_Pistol)
 	{
-		OutHitResult.Location = OutBeamLocation;
-		return false;
+		// Start moving slide timer
+		EquippedWeapon->StartSlideTimer();
 	}
-	return true;
 }
 
 void AShooterCharacter::AimingButtonPressed()
@@ -387,10 +433,17 @@ void AShooterCharacter::CalculateCrosshairSpread(float DeltaTime)
 	CrosshairSpreadMultiplier = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor - CrosshairAimFactor + CrosshairShootingFactor;
 }
 
-void AShooterCharacter::StartCrosshairBulletFire()
+void AShooterCharacter::StartCrosshairBulletFire(float ShotAge)
 {
+	const float Duration{ShootTimeDuration - ShotAge};
+	if (Duration <= 0.f)
+	{
+		// Shot was due long enough ago that its spread has already run out
+		FinishCrosshairBulletFire();
+		return;
+	}
 	bFiringBullet = true;
-	GetWorldTimerManager().SetTimer(CrosshairShootTimer, this, &AShooterCharacter::FinishCrosshairBulletFire, ShootTimeDuration);
+	GetWorldTimerManager().SetTimer(CrosshairShootTimer, this, &AShooterCharacter::FinishCrosshairBulletFire, Duration);
 }
 
 void AShooterCharacter::FinishCrosshairBulletFire()
@@ -412,30 +465,78 @@ void AShooterCharacter::FireButtonReleased()
 void AShooterCharacter::StartFireTimer()
 {
 	CombatState = ECombatState::ECS_FireTimerInProgress;
-	
-	GetWorldTimerManager().SetTimer(AutoFireTimer, this, &AShooterCharacter::AutoFireReset, EquippedWeapon->GetAutoFireRate());
+
+	// Counted down in UpdateFireScheduler
+	FireCooldownRemaining = EquippedWeapon->GetAutoFireRate();
 }
 
-void AShooterCharacter::AutoFireReset()
+void AShooterCharacter::UpdateFireScheduler(float DeltaTime)
 {
-	if (CombatState == ECombatState::ECS_Stunned) return;
-	CombatState = ECombatState::ECS_Unoccupied;
+	// Stunned, reloading, etc. cancel the fire timer
+	if (CombatState != ECombatState::ECS_FireTimerInProgress || !EquippedWeapon) return;
 
-	if (WeaponHasAmmo())
+	const float FireInterval{FMath::Max(EquippedWeapon->GetAutoFireRate(), KINDA_SMALL_NUMBER)};
+	const bool bKeepFiring{bFireButtonPressed && EquippedWeapon->GetAutomatic() && WeaponHasAmmo()};
+	if (bKeepFiring && !HasPredictionRoom())
 	{
-		if (bFireButtonPressed && EquippedWeapon->GetAutomatic())
-		{
-			FireWeapon();
-		}
+		// Waiting on the server to ack our shots. Hold the next shot ready without building up debt
+		FireCooldownRemaining = FMath::Max(FireCooldownRemaining - DeltaTime, 0.f);
+		return;
 	}
-	else
+
+	const int32 MaxShots{bKeepFiring ? FMath::Min(MaxShotsPerTick, EquippedWeapon->GetAmmo()) : 0};
+	float ShotAge{0.f};
+	const int32 NumShots{AdvanceFireCooldown(FireCooldownRemaining, DeltaTime, FireInterval, MaxShots, ShotAge)};
+	if (NumShots > 0)
+	{
+		FireShots(NumShots, ShotAge);
+		return;
+	}
+	// Still cooling down from the last shot
+	if (FireCooldownRemaining > 0.f) return;
+
+	CombatState = ECombatState::ECS_Unoccupied;
+	if (!WeaponHasAmmo())
 	{
 		ReloadWeapon();
 	}
 }
 
-bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
+int32 AShooterCharacter::AdvanceFireCooldown(float& CooldownRemaining, float DeltaTime, float FireInterval, int32 MaxShots,
+	float& OutShotAge)
 {
+	CooldownRemaining -= DeltaTime;
+
+	// Count every shot that came due this frame. The leftover time carries into the
+	// next cooldown so the fire rate doesn't depend on the frame rate
+	int32 NumShots{0};
+	while (CooldownRemaining <= 0.f && NumShots < MaxShots)
+	{
+		// How long ago this shot was due
+		OutShotAge = -CooldownRemaining;
+		CooldownRemaining += FireInterval;
+		++NumShots;
+	}
+
+	// Capped by MaxShots after a hitch. Forgive the rest instead of firing it as a burst over the next frames
+	if (NumShots > 0 && NumShots == MaxShots)
+	{
+		CooldownRemaining = FMath::Max(CooldownRemaining, 0.f);
+	}
+	return NumShots;
+}
+
+bool AShooterCharacter::GetCrosshairRay(FVector& OutStart, FVector& OutEnd)
+{
+	// Reuse the ray if we already deprojected from this camera this frame
+	const FTransform CameraTransform{GetCrosshairCameraTransform()};
+	if (CrosshairCache.IsValidFor(GFrameCounter, CameraTransform))
+	{
+		OutStart = CrosshairCache.RayStart;
+		OutEnd = CrosshairCache.RayEnd;
+		return true;
+	}
+	
 	// Get current Viewport's size
 	FVector2D ViewportSize;
 	if (GEngine && GEngine->GameViewport)
@@ -453,15 +554,45 @@ bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector&
 	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0),
 																   CrosshairLocation, CrosshairWorldPosition,
 																   CrosshairWorldDirection);
-
 	if (bScreenToWorld)
 	{
-		// Trace from crosshair's world location outward
-		const FVector Start{CrosshairWorldPosition};
-		const FVector End{Start + CrosshairWorldDirection * 50000};
-		OutHitLocation = End;
-		GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECollisionChannel::ECC_Visibility);
+		// Ray from crosshair's world location outward
+		OutStart = CrosshairWorldPosition;
+		OutEnd = OutStart + CrosshairWorldDirection * 50000;
 
+		// New ray, any cached trace is stale
+		CrosshairCache.FrameNumber = GFrameCounter;
+		CrosshairCache.CameraTransform = CameraTransform;
+		CrosshairCache.bHasRay = true;
+		CrosshairCache.RayStart = OutStart;
+		CrosshairCache.RayEnd = OutEnd;
+		CrosshairCache.bHasTrace = false;
+	}
+	return bScreenToWorld;
+}
+
+bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation)
+{
+	FVector Start;
+	FVector End;
+	if (GetCrosshairRay(Start, End))
+	{
+		if (CrosshairCache.bHasTrace)
+		{
+			// Already traced this ray this frame
+			INC_DWORD_STAT(STAT_CrosshairTracesSaved);
+			OutHitResult = CrosshairCache.HitResult;
+		}
+		else
+		{
+			// Trace from crosshair's world location outward
+			INC_DWORD_STAT(STAT_CrosshairTraces);
+			GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECollisionChannel::ECC_Visibility);
+			CrosshairCache.bHasTrace = true;
+			CrosshairCache.HitResult = OutHitResult;
+		}
+		
+		OutHitLocation = End;
 		if (OutHitResult.bBlockingHit)
 		{
 			OutHitLocation = OutHitResult.Location;
@@ -471,16 +602,43 @@ bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector&
 	return false;
 }
 
+void AShooterCharacter::CacheCrosshairTrace(const FHitResult& HitResult, FTransform CameraTransform, FVector RayStart,
+	FVector RayEnd)
+{
+	// Async traces come back at the start of the next frame. Same camera means same ray, so the result
+	// serves this frame's queries as long as nothing traced it already
+	const FTransform CurrentCamera{GetCrosshairCameraTransform()};
+	if (!CameraTransform.Equals(CurrentCamera)) return;
+	if (CrosshairCache.IsValidFor(GFrameCounter, CurrentCamera) && CrosshairCache.bHasTrace) return;
+
+	CrosshairCache.FrameNumber = GFrameCounter;
+	CrosshairCache.CameraTransform = CurrentCamera;
+	CrosshairCache.bHasRay = true;
+	CrosshairCache.RayStart = RayStart;
+	CrosshairCache.RayEnd = RayEnd;
+	CrosshairCache.bHasTrace = true;
+	CrosshairCache.HitResult = HitResult;
+}
+
+FTransform AShooterCharacter::GetCrosshairCameraTransform() const
+{
+	const APlayerCameraManager* CameraManager = UGameplayStatics::GetPlayerCameraManager(this, 0);
+	if (CameraManager)
+	{
+		return FTransform(CameraManager->GetCameraRotation(), CameraManager->GetCameraLocation());
+	}
+	return FTransform::Identity;
+}
+
 void AShooterCharacter::TraceForItems()
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_TraceForItems, Items);
 	if (bShouldTraceForItems)
 	{
-		FHitResult ItemTraceResult;
-		FVector HitLocation;
-		TraceUnderCrosshairs(ItemTraceResult, HitLocation);
-		if (ItemTraceResult.bBlockingHit)
+		AItem* HitItem{nullptr};
+		if (FindItemUnderCrosshairs(HitItem))
 		{
-			TraceHitItem = Cast<AItem>(ItemTraceResult.Actor);
+			TraceHitItem = HitItem;
 			const auto TraceHitWeapon = Cast<AWeapon>(TraceHitItem);
 
 			if (TraceHitWeapon)
@@ -505,12 +663,8 @@ void AShooterCharacter::TraceForItems()
 				TraceHitItem = nullptr;
 			}
 			
-			if (TraceHitItem && TraceHitItem->GetPickupWidget())
+			if (TraceHitItem)
 			{
-				// Show item's pick up widget
-				TraceHitItem->GetPickupWidget()->SetVisibility(true);
-				TraceHitItem->EnableCustomDepth();
-
 				if (Inventory.Num() >= INVENTORY_CAPACITY)
 				{
 					// Inventory is full
@@ -521,6 +675,10 @@ void AShooterCharacter::TraceForItems()
 					// Inventory has room
 					TraceHitItem->SetCharacterInventoryFull(false);		
 				}
+
+				// Show item's pick up widget
+				SetPickupPromptVisible(TraceHitItem, true);
+				TraceHitItem->EnableCustomDepth();
 			}
 			
 			// We hit an AItem last frame
@@ -530,7 +688,7 @@ void AShooterCharacter::TraceForItems()
 				{
 					// We are hitting a different AItem this frame from last frame
 					// Or AItem is null
-					TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
+					SetPickupPromptVisible(TraceHitItemLastFrame, false);
 					TraceHitItemLastFrame->DisableCustomDepth();
 				}
 			}
@@ -542,17 +700,75 @@ void AShooterCharacter::TraceForItems()
 	{
 		// No longer overlapping any items
 		// Item last frame should not show widget
-		TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
+		SetPickupPromptVisible(TraceHitItemLastFrame, false);
 		TraceHitItemLastFrame->DisableCustomDepth();
 	}
 }
 
+void AShooterCharacter::SetPickupPromptVisible(AItem* Item, bool bVisible)
+{
+	if (!Item) return;
+
+	// Items with their own widget show it, the rest use the controller's shared prompt
+	if (Item->GetPickupWidget())
+	{
+		Item->GetPickupWidget()->SetVisibility(bVisible);
+		return;
+	}
+
+	AShooterPlayerController* ShooterController = Cast<AShooterPlayerController>(GetController());
+	if (!ShooterController) return;
+
+	if (bVisible)
+	{
+		ShooterController->ShowPickupPrompt(Item);
+	}
+	else
+	{
+		ShooterController->HidePickupPrompt(Item);
+	}
+}
+
+bool AShooterCharacter::FindItemUnderCrosshairs(AItem*& OutItem)
+{
+	UItemSpatialSubsystem* ItemSpatial = GetWorld()->GetSubsystem<UItemSpatialSubsystem>();
+	if (ItemSpatial && UItemSpatialSubsystem::IsQueryEnabled())
+	{
+		// View cone query against the item grid
+		FVector Start;
+		FVector End;
+		if (!GetCrosshairRay(Start, End)) return false;
+		AItem* Candidate = ItemSpatial->FindBestItemInView(Start, End - Start, ItemQueryRange, ItemQueryAngle);
+
+		// The grid doesn't know about walls, one trace checks each new candidate
+		if (Candidate != ItemQueryCandidate.Get())
+		{
+			ItemQueryCandidate = Candidate;
+			bItemQueryCandidateVisible = Candidate && ItemSpatial->HasLineOfSight(Start, Candidate, this);
+		}
+		OutItem = bItemQueryCandidateVisible ? Candidate : nullptr;
+		return true;
+	}
+
+	FHitResult ItemTraceResult;
+	FVector HitLocation;
+	TraceUnderCrosshairs(ItemTraceResult, HitLocation);
+	if (!ItemTraceResult.bBlockingHit) return false;
+	OutItem = Cast<AItem>(ItemTraceResult.Actor);
+	return true;
+}
+
 AWeapon* AShooterCharacter::SpawnDefaultWeapon()
 {
 	// Check the TSubclassOf variable
 	if	(DefaultWeaponClass)
 	{
-		// Spawn the default weapon set in blueprints
+		// Take the default weapon set in blueprints from the pool, or spawn it
+		UItemPoolSubsystem* ItemPool = GetWorld()->GetSubsystem<UItemPoolSubsystem>();
+		if (ItemPool)
+		{
+			return ItemPool->AcquireItem<AWeapon>(DefaultWeaponClass, GetActorTransform());
+		}
 		return GetWorld()->SpawnActor<AWeapon>(DefaultWeaponClass);
 	}
 	return nullptr;
@@ -640,14 +856,16 @@ bool AShooterCharacter::WeaponHasAmmo()
 void AShooterCharacter::PlayFireSound()
 {
 	// Play fire sound
-	if (EquippedWeapon->GetFireSound())
+	if (EquippedWeapon->GetFireSound() && ShouldPlayCosmetics(this))
 	{
 		UGameplayStatics::PlaySound2D(this, EquippedWeapon->GetFireSound());
 	}
 }
 
-void AShooterCharacter::SendBullet()
+void AShooterCharacter::SendBullet(int32 NumShots, uint16 Sequence)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_SendBullet, Weapons);
+
 	// Send bullet
 	const USkeletalMeshSocket* BarrelSocket = EquippedWeapon->GetItemMesh()->GetSocketByName("BarrelSocket");
 	if (BarrelSocket)
@@ -656,65 +874,451 @@ void AShooterCharacter::SendBullet()
 
 		if (EquippedWeapon->GetMuzzleFlash())
 		{
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), EquippedWeapon->GetMuzzleFlash(), SocketTransform);
+			UParticlePoolSubsystem::SpawnEmitter(this, EquippedWeapon->GetMuzzleFlash(), SocketTransform);
 		}
 
-		FHitResult BeamHitResult;
-		bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamHitResult);
-
-		if (bBeamEnd)
+		UHitscanSubsystem* Hitscan = GetWorld()->GetSubsystem<UHitscanSubsystem>();
+		FVector CrosshairStart;
+		FVector CrosshairEnd;
+		if (Hitscan && GetCrosshairRay(CrosshairStart, CrosshairEnd))
 		{
-			// Does hit ACtor implement BulletHitInterface?
-			if (BeamHitResult.Actor.IsValid())
+			// Shots fired in the same tick share the muzzle and crosshair ray, so one trace resolves them all
+			const FOnShotResolved OnResolved{
+				FOnShotResolved::CreateUObject(this, &AShooterCharacter::ResolveBullet, SocketTransform, NumShots, Sequence)};
+
+			// Synchronous mode traces the crosshairs here so the rest of the frame can reuse it
+			const bool bCrosshairTraced{CrosshairCache.bHasTrace};
+			if (!bCrosshairTraced && UHitscanSubsystem::GetMode() == EHitscanMode::EHM_Synchronous)
 			{
-				IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(BeamHitResult.Actor.Get());
-				if (BulletHitInterface)
-				{
-					BulletHitInterface->BulletHit_Implementation(BeamHitResult, this, GetController());
-				}
-				AEnemy* HitEnemy = Cast<AEnemy>(BeamHitResult.Actor.Get());
-				if (HitEnemy)
+				FHitResult CrosshairHitResult;
+				FVector HitLocation;
+				TraceUnderCrosshairs(CrosshairHitResult, HitLocation);
+			}
+
+			if (CrosshairCache.bHasTrace)
+			{
+				// Crosshairs already traced this frame, only the barrel trace is left
+				if (bCrosshairTraced)
 				{
-					int32 Damage{};
-					if (BeamHitResult.BoneName.ToString() == HitEnemy->GetHeadBone())
-					{
-						// Head shot
-						Damage = EquippedWeapon->GetHeadShotDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.Actor.Get(), Damage,
-						GetController(), this, UDamageType::StaticClass());
-						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, true);
-					}
-					else
-					{
-						// Body shot
-						Damage = EquippedWeapon->GetDamage();
-						UGameplayStatics::ApplyDamage(BeamHitResult.Actor.Get(), Damage,
-						GetController(), this, UDamageType::StaticClass());
-						HitEnemy->ShowHitNumber(Damage, BeamHitResult.Location, false);
-					}
+					INC_DWORD_STAT(STAT_CrosshairTracesSaved);
 				}
+				const FVector BeamTarget{CrosshairCache.HitResult.bBlockingHit ? CrosshairCache.HitResult.Location : CrosshairEnd};
+				Hitscan->QueueBarrelShot(SocketTransform.GetLocation(), BeamTarget, OnResolved);
 			}
 			else
 			{
-				if (ImpactParticles)
-				{
-					UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, BeamHitResult.Location);
-				}
+				// Traces are done by the hitscan subsystem, possibly on a later frame. Its crosshair trace
+				// comes back to the cache so the item query doesn't trace the same ray again
+				const FOnCrosshairTraced OnCrosshairTraced{FOnCrosshairTraced::CreateUObject(this,
+					&AShooterCharacter::CacheCrosshairTrace, CrosshairCache.CameraTransform, CrosshairStart, CrosshairEnd)};
+				Hitscan->QueueShot(SocketTransform.GetLocation(), CrosshairStart, CrosshairEnd, OnResolved,
+					OnCrosshairTraced);
+			}
+		}
+	}
+}
 
-				if (BeamParticles)
-				{
-					UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(
-						GetWorld(), BeamParticles, SocketTransform);
-					if (Beam)
-					{
-						Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
-					}
-				}	
+void AShooterCharacter::ResolveBullet(const FHitResult& BeamHitResult, bool bBeamEnd, FTransform SocketTransform, int32 NumShots,
+	uint16 Sequence)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ResolveBullet, Weapons);
+
+	// Clients only see their shots, the server decides what they hit. It already has the shots, misses
+	// need nothing more
+	const bool bHitActor{bBeamEnd && BeamHitResult.Actor.IsValid()};
+	if (!HasAuthority() && bHitActor && Sequence != 0)
+	{
+		FShooterFireRequest Request;
+		Request.TraceStart = SocketTransform.GetLocation();
+		Request.HitLocation = BeamHitResult.Location;
+		Request.HitActor = BeamHitResult.Actor.Get();
+		Request.Sequence = Sequence;
+		ServerFireHit(Request);
+	}
+
+	if (!bBeamEnd) return;
+	
+	// Hit actors are damaged on the server, the shooter sees the impact right away
+	if (bHitActor)
+	{
+		if (HasAuthority())
+		{
+			ApplyBulletHit(BeamHitResult, NumShots);
+		}
+		else
+		{
+			PlayPredictedImpact(BeamHitResult);
+		}
+	}
+	else
+	{
+		if (ImpactParticles)
+		{
+			UParticlePoolSubsystem::SpawnEmitter(this, ImpactParticles, BeamHitResult.Location);
+		}
+
+		if (BeamParticles)
+		{
+			UParticleSystemComponent* Beam = UParticlePoolSubsystem::SpawnEmitter(this, BeamParticles, SocketTransform);
+			if (Beam)
+			{
+				Beam->SetVectorParameter(FName("Target"), BeamHitResult.Location);
 			}
+		}	
+	}
+}
+
+void AShooterCharacter::ApplyBulletHit(const FHitResult& HitResult, int32 NumShots)
+{
+	IBulletHitInterface* BulletHitInterface = Cast<IBulletHitInterface>(HitResult.Actor.Get());
+	if (BulletHitInterface)
+	{
+		BulletHitInterface->BulletHit_Implementation(HitResult, this, GetController());
+	}
+	AEnemy* HitEnemy = Cast<AEnemy>(HitResult.Actor.Get());
+	if (HitEnemy && EquippedWeapon)
+	{
+		// Scale the weapon damage by the zone we hit
+		const EHitZone HitZone{HitEnemy->GetHitZone(HitResult.BoneName)};
+		const int32 Damage = EquippedWeapon->GetDamage() * HitEnemy->GetHitZoneDamageMultiplier(HitZone);
+		for (int32 i = 0; i < NumShots; ++i)
+		{
+			UGameplayStatics::ApplyDamage(HitResult.Actor.Get(), Damage,
+			GetController(), this, UDamageType::StaticClass());
+		}
+		// Remote shooters only learn the damage from us
+		const bool bHeadShot{HitZone == EHitZone::EHZ_Head};
+		if (IsLocallyControlled())
+		{
+			HitEnemy->ShowHitNumber(Damage * NumShots, HitResult.Location, bHeadShot);
+		}
+		else
+		{
+			ClientShowHitNumber(HitEnemy, Damage * NumShots, HitResult.Location, bHeadShot);
 		}
 	}
 }
 
+void AShooterCharacter::PlayPredictedImpact(const FHitResult& HitResult)
+{
+	// Cosmetic only, the hit itself waits for the server
+	AEnemy* HitEnemy = Cast<AEnemy>(HitResult.Actor.Get());
+	if (HitEnemy)
+	{
+		HitEnemy->PlayBulletImpact(HitResult.Location);
+	}
+	else if (ImpactParticles)
+	{
+		UParticlePoolSubsystem::SpawnEmitter(this, ImpactParticles, HitResult.Location);
+	}
+}
+
+void AShooterCharacter::ClientShowHitNumber_Implementation(AEnemy* HitEnemy, int32 Damage, FVector_NetQuantize HitLocation,
+	bool bHeadShot)
+{
+	if (HitEnemy)
+	{
+		HitEnemy->ShowHitNumber(Damage, HitLocation, bHeadShot);
+	}
+}
+
+bool AShooterCharacter::ServerFire_Validate(uint16 Sequence, uint8 NumShots, float ClientTime)
+{
+	// Only requests no honest client could send kick the player, out of tolerance shots are just ignored
+	return NumShots > 0 && NumShots <= MaxShotsPerTick && FMath::IsFinite(ClientTime);
+}
+
+void AShooterCharacter::ServerFire_Implementation(uint16 Sequence, uint8 NumShots, float ClientTime)
+{
+	// Our copy of the weapon pays for the shots, only as many as it still has can hit. Shots while the
+	// server has us reloading, swapping or stunned, or faster than the weapon fires, are dropped
+	const bool bCanFire{CombatState != ECombatState::ECS_Reloading && CombatState != ECombatState::ECS_Equipping &&
+		CombatState != ECombatState::ECS_Stunned};
+	int32 AllowedShots{0};
+	if (EquippedWeapon && bCanFire)
+	{
+		AllowedShots = LimitServerFireRate(FMath::Min<int32>(NumShots, EquippedWeapon->GetAmmo()));
+		for (int32 i = 0; i < AllowedShots; ++i)
+		{
+			EquippedWeapon->DecrementAmmo();
+		}
+	}
+	AckAction(Sequence);
+
+	if (AllowedShots > 0)
+	{
+		ServerShots.Add(Sequence, AllowedShots, ClientTime);
+	}
+}
+
+bool AShooterCharacter::ServerFireHit_Validate(const FShooterFireRequest& Request)
+{
+	return !Request.TraceStart.ContainsNaN() && !Request.HitLocation.ContainsNaN();
+}
+
+void AShooterCharacter::ServerFireHit_Implementation(const FShooterFireRequest& Request)
+{
+	// A hit only counts for shots we paid for, once. ServerFire for them is reliable and sent first, so a
+	// missing shot was dropped or already hit
+	FShooterServerShot Shot;
+	if (!Request.HitActor || !ServerShots.Take(Request.Sequence, Shot)) return;
+
+	// Rewound to when the client fired, not to when its hit arrived
+	FShooterFireRequest ShotRequest{Request};
+	ShotRequest.ClientTime = Shot.ClientTime;
+	ShotRequest.NumShots = static_cast<uint8>(Shot.NumShots);
+
+	// The bone, and with it the hit zone, is whatever the server finds along the shot
+	ULagCompensationSubsystem* LagCompensation = GetWorld()->GetSubsystem<ULagCompensationSubsystem>();
+	FHitResult HitResult;
+	const bool bConfirmed{LagCompensation && LagCompensation->ConfirmShot(this, ShotRequest, HitResult)};
+	if (UShooterEventLogSubsystem* EventLog = UShooterEventLogSubsystem::GetIfRecording(this))
+	{
+		EventLog->RecordEvent(this, bConfirmed ? TEXT("HitConfirmed") : TEXT("HitRejected"),
+			FString::Printf(TEXT("%d shots, %.0f ms old"), Shot.NumShots,
+				(GetWorld()->GetTimeSeconds() - Shot.ClientTime) * 1000.f));
+	}
+	if (!bConfirmed) return;
+
+	ApplyBulletHit(HitResult, Shot.NumShots);
+}
+
+int32 AShooterCharacter::LimitServerFireRate(int32 NumShots)
+{
+	// Idle time only banks ServerFireTolerance worth of extra shots
+	const float Now{GetWorld()->GetTimeSeconds()};
+	const float FireInterval{FMath::Max(EquippedWeapon->GetAutoFireRate(), KINDA_SMALL_NUMBER)};
+	LastServerShotTime = FMath::Max(LastServerShotTime, Now - FireInterval - ServerFireTolerance);
+
+	int32 AllowedShots{0};
+	while (AllowedShots < NumShots && LastServerShotTime + FireInterval <= Now)
+	{
+		LastServerShotTime += FireInterval;
+		++AllowedShots;
+	}
+	INC_DWORD_STAT_BY(STAT_ServerShotsDropped, NumShots - AllowedShots);
+	return AllowedShots;
+}
+
+void AShooterCharacter::ServerReload_Implementation(uint16 Sequence)
+{
+	// The client already played the montage, only the ammo moves here
+	TransferCarriedAmmo();
+	AckAction(Sequence);
+}
+
+bool AShooterCharacter::ServerEquip_Validate(uint16 Sequence, int32 SlotIndex)
+{
+	return SlotIndex >= 0 && SlotIndex < INVENTORY_CAPACITY;
+}
+
+void AShooterCharacter::ServerEquip_Implementation(uint16 Sequence, int32 SlotIndex)
+{
+	// Our inventory decides, an empty or missing slot is rolled back on the client
+	if (EquippedWeapon && Inventory.IsValidIndex(SlotIndex) && Cast<AWeapon>(Inventory[SlotIndex]))
+	{
+		ExchangeInventoryItems(EquippedWeapon->GetSlotIndex(), SlotIndex);
+	}
+	AckAction(Sequence);
+}
+
+void AShooterCharacter::ServerPickupItem_Implementation(uint16 Sequence, FName PickupId)
+{
+	// The client finds items from its camera, which can be the boom length behind us. Items we don't
+	// have, or that are already taken, are rolled back on the client by the ack
+	UItemSpatialSubsystem* ItemSpatial = GetWorld()->GetSubsystem<UItemSpatialSubsystem>();
+	AItem* Item = ItemSpatial ? ItemSpatial->FindItemByPickupId(PickupId) : nullptr;
+	const float Reach{ItemQueryRange + (CameraBoom ? CameraBoom->TargetArmLength : 0.f)};
+	if (Item && Item->GetItemState() == EItemState::EIS_Pickup &&
+		FVector::DistSquared(Item->GetActorLocation(), GetActorLocation()) <= FMath::Square(Reach))
+	{
+		Item->SetCharacter(this);
+		GetPickupItem(Item);
+	}
+	AckAction(Sequence);
+}
+
+void AShooterCharacter::AckAction(uint16 Sequence)
+{
+	if (Sequence == 0) return;
+
+	FShooterActionAck Ack;
+	Ack.Sequence = Sequence;
+	Ack.State = CapturePredictedState();
+	ClientAckAction(Ack);
+}
+
+void AShooterCharacter::ClientAckAction_Implementation(const FShooterActionAck& Ack)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_ReconcileActions, Weapons);
+
+	TOptional<FShooterPredictedState> PredictedState;
+	if (!PredictedActions.Acknowledge(Ack.Sequence, PredictedState)) return;
+	if (PredictedState.IsSet() && PredictedState.GetValue() == Ack.State) return;
+
+	// Mispredicted, take the server's state and redo the actions it hasn't seen yet on top of it
+	INC_DWORD_STAT(STAT_PredictionRollbacks);
+	UE_LOG(LogShooter, Verbose, TEXT("%s rolled back to action %d, replaying %d"), *GetName(), Ack.Sequence,
+		PredictedActions.Num());
+	ApplyPredictedState(Ack.State);
+	for (int32 i = 0; i < PredictedActions.Num(); ++i)
+	{
+		FShooterPredictedAction& Action = PredictedActions[i];
+		ReplayPredictedAction(Action);
+		Action.State = CapturePredictedState();
+	}
+}
+
+bool AShooterCharacter::IsPredictingActions() const
+{
+	return GetLocalRole() == ROLE_AutonomousProxy;
+}
+
+bool AShooterCharacter::HasPredictionRoom() const
+{
+	return !IsPredictingActions() || !PredictedActions.IsFull();
+}
+
+uint16 AShooterCharacter::PredictAction(EShooterActionType Type, int32 Param, FName PickupId, EAmmoType AmmoType)
+{
+	if (!IsPredictingActions()) return 0;
+
+	INC_DWORD_STAT(STAT_PredictedActions);
+	FShooterPredictedAction Action;
+	Action.Type = Type;
+	Action.Param = Param;
+	Action.PickupId = PickupId;
+	Action.AmmoType = AmmoType;
+	Action.State = CapturePredictedState();
+	return PredictedActions.Add(Action);
+}
+
+FShooterPredictedState AShooterCharacter::CapturePredictedState() const
+{
+	FShooterPredictedState State;
+	if (EquippedWeapon)
+	{
+		State.SlotIndex = EquippedWeapon->GetSlotIndex();
+		State.Ammo = EquippedWeapon->GetAmmo();
+	}
+	for (int32 i = 0; i < SHOOTER_NUM_AMMO_TYPES; ++i)
+	{
+		State.CarriedAmmo[i] = AmmoMap.FindRef(static_cast<EAmmoType>(i));
+	}
+
+	State.NumInventoryItems = FMath::Min(Inventory.Num(), SHOOTER_INVENTORY_CAPACITY);
+	for (int32 i = 0; i < State.NumInventoryItems; ++i)
+	{
+		State.InventoryIds[i] = Inventory[i] ? Inventory[i]->GetPickupId() : NAME_None;
+	}
+	return State;
+}
+
+void AShooterCharacter::ApplyPredictedState(const FShooterPredictedState& State)
+{
+	ApplyPredictedInventory(State);
+	EquipInventorySlot(State.SlotIndex);
+	for (int32 i = 0; i < SHOOTER_NUM_AMMO_TYPES; ++i)
+	{
+		AmmoMap.Add(static_cast<EAmmoType>(i), State.CarriedAmmo[i]);
+	}
+	if (EquippedWeapon)
+	{
+		EquippedWeapon->SetAmmo(State.Ammo);
+	}
+}
+
+void AShooterCharacter::ApplyPredictedInventory(const FShooterPredictedState& State)
+{
+	// Items stay in their slot while the server agrees, others are found among ours or the pickups. Items
+	// we can't find are left out, the next ack tries again
+	UItemSpatialSubsystem* ItemSpatial = GetWorld()->GetSubsystem<UItemSpatialSubsystem>();
+	TArray<AItem*, TInlineAllocator<SHOOTER_INVENTORY_CAPACITY>> ServerInventory;
+	for (int32 i = 0; i < State.NumInventoryItems; ++i)
+	{
+		const FName PickupId{State.InventoryIds[i]};
+		AItem* Item = Inventory.IsValidIndex(i) && Inventory[i] && Inventory[i]->GetPickupId() == PickupId ?
+			Inventory[i] : nullptr;
+		if (!Item && !PickupId.IsNone())
+		{
+			AItem* const* OwnItem = Inventory.FindByPredicate([PickupId](const AItem* Candidate)
+			{
+				return Candidate && Candidate->GetPickupId() == PickupId;
+			});
+			Item = OwnItem ? *OwnItem : (ItemSpatial ? ItemSpatial->FindItemByPickupId(PickupId) : nullptr);
+		}
+		if (!Item) break;
+
+		ServerInventory.Add(Item);
+	}
+
+	for (AItem* Item : Inventory)
+	{
+		if (!Item || ServerInventory.Contains(Item)) continue;
+
+		if (Item == EquippedWeapon)
+		{
+			EquippedWeapon = nullptr;
+		}
+		Item->GetItemMesh()->DetachFromComponent(FDetachmentTransformRules{EDetachmentRule::KeepWorld, true});
+		Item->SetActorTransform(Item->GetPickupTransform(), false, nullptr, ETeleportType::ResetPhysics);
+		Item->SetItemState(EItemState::EIS_Pickup);
+	}
+
+	Inventory.Reset();
+	for (AItem* Item : ServerInventory)
+	{
+		Item->SetSlotIndex(Inventory.Num());
+		if (Item->GetItemState() == EItemState::EIS_Pickup)
+		{
+			Item->SetItemState(EItemState::EIS_PickedUp);
+		}
+		Inventory.Add(Item);
+	}
+}
+
+void AShooterCharacter::ReplayPredictedAction(const FShooterPredictedAction& Action)
+{
+	switch (Action.Type)
+	{
+	case EShooterActionType::Fire:
+		if (EquippedWeapon)
+		{
+			for (int32 i = 0; i < Action.Param; ++i)
+			{
+				EquippedWeapon->DecrementAmmo();
+			}
+		}
+		break;
+	case EShooterActionType::Reload:
+		TransferCarriedAmmo();
+		break;
+	case EShooterActionType::Equip:
+		EquipInventorySlot(Action.Param);
+		break;
+	case EShooterActionType::Pickup:
+		// A weapon is taken again if the rollback put it back in the world
+		if (UItemSpatialSubsystem* ItemSpatial = GetWorld()->GetSubsystem<UItemSpatialSubsystem>())
+		{
+			if (AWeapon* Weapon = Cast<AWeapon>(ItemSpatial->FindItemByPickupId(Action.PickupId)))
+			{
+				AddWeaponToInventory(Weapon);
+			}
+		}
+		if (Action.AmmoType != EAmmoType::EAT_MAX)
+		{
+			AmmoMap.FindOrAdd(Action.AmmoType) += Action.Param;
+		}
+		break;
+	}
+}
+
+float AShooterCharacter::GetServerWorldTimeSeconds() const
+{
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+}
+
 void AShooterCharacter::PlayGunfireMontage()
 {
 	// Play HipFireMontage
@@ -733,7 +1337,7 @@ void AShooterCharacter::ReloadButtonPressed()
 
 void AShooterCharacter::ReloadWeapon()
 {
-	if (CombatState != ECombatState::ECS_Unoccupied) return;
+	if (CombatState != ECombatState::ECS_Unoccupied || !HasPredictionRoom()) return;
 	
 	// Do we have ammo of the correct type? & is the clip full?
 	if (CarryingAmmo() && !EquippedWeapon->ClipIsFull()) 
@@ -767,6 +1371,20 @@ void AShooterCharacter::FinishReloading()
 
 	if (!EquippedWeapon) return;
 
+	TransferCarriedAmmo();
+
+	// Owning clients tell the server once the reload has finished here
+	const uint16 Sequence{PredictAction(EShooterActionType::Reload, 0)};
+	if (Sequence != 0)
+	{
+		ServerReload(Sequence);
+	}
+}
+
+void AShooterCharacter::TransferCarriedAmmo()
+{
+	if (!EquippedWeapon) return;
+
 	const auto AmmoType = EquippedWeapon->GetAmmoType();
 	// Update AmmoMap
 	if (AmmoMap.Contains(AmmoType))
@@ -918,7 +1536,8 @@ void AShooterCharacter::PickupAmmo(AAmmo* Ammo)
 		AmmoMap[Ammo->GetAmmoType()] = AmmoCount;
 	}
 
-	if (EquippedWeapon->GetAmmoType() == Ammo->GetAmmoType())
+	// The player's machine starts the reload, the server hears about it like any other
+	if (EquippedWeapon->GetAmmoType() == Ammo->GetAmmoType() && IsLocallyControlled())
 	{
 		// Check to see if the gun is empty
 		if (EquippedWeapon->GetAmmo() == 0)
@@ -926,8 +1545,6 @@ void AShooterCharacter::PickupAmmo(AAmmo* Ammo)
 			ReloadWeapon();
 		}
 	}
-
-	Ammo->Destroy();
 }
 
 void AShooterCharacter::InitializeInterpLocations()
@@ -1013,7 +1630,7 @@ void AShooterCharacter::FiveKeyPressed()
 void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex)
 {
 	const bool bCanExchangeItems = (CurrentItemIndex != NewItemIndex) && (NewItemIndex < Inventory.Num()) &&
-		(CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Equipping);
+		(CombatState == ECombatState::ECS_Unoccupied || CombatState == ECombatState::ECS_Equipping) && HasPredictionRoom();
 	
 	if (bCanExchangeItems)
 	{
@@ -1037,6 +1654,25 @@ void AShooterCharacter::ExchangeInventoryItems(int32 CurrentItemIndex, int32 New
 			AnimInstance->Montage_JumpToSection(FName("Equip"));
 		}
 		NewWeapon->PlayEquipSound(true);
+
+		const uint16 Sequence{PredictAction(EShooterActionType::Equip, NewItemIndex)};
+		if (Sequence != 0)
+		{
+			ServerEquip(Sequence, NewItemIndex);
+		}
+	}
+}
+
+void AShooterCharacter::EquipInventorySlot(int32 SlotIndex)
+{
+	AWeapon* SlotWeapon = Inventory.IsValidIndex(SlotIndex) ? Cast<AWeapon>(Inventory[SlotIndex]) : nullptr;
+	if (!SlotWeapon || SlotWeapon == EquippedWeapon) return;
+
+	AWeapon* OldEquippedWeapon = EquippedWeapon;
+	EquipWeapon(SlotWeapon);
+	if (OldEquippedWeapon)
+	{
+		OldEquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
 	}
 }
 
@@ -1127,17 +1763,25 @@ void AShooterCharacter::Stun()
 // Called every frame
 void AShooterCharacter::Tick(float DeltaTime)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_CharacterTick, Character);
 	Super::Tick(DeltaTime);
 
-	// Handle interpolation for zoom when aiming 
-	CameraInterpZoom(DeltaTime);
+	// Fire any automatic shots owed since the last frame
+	UpdateFireScheduler(DeltaTime);
+
+	// The camera and crosshairs only matter to the player looking through them
+	if (IsLocallyControlled() && ShouldPlayCosmetics(this))
+	{
+		// Handle interpolation for zoom when aiming 
+		CameraInterpZoom(DeltaTime);
+
+		// Calculate crosshair spread multiplier
+		CalculateCrosshairSpread(DeltaTime);
+	}
 
 	// Change sensitivity based on aiming
 	SetLookRates();
 
-	// Calculate crosshair spread multiplier
-	CalculateCrosshairSpread(DeltaTime);
-
 	// Check OverlappedItemCount, trace for items
 	TraceForItems();
 
@@ -1184,6 +1828,7 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 float AShooterCharacter::TakeDamage(float DamageAmount, FDamageEvent const& DamageEvent, AController* EventInstigator,
 	AActor* DamageCauser)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_CharacterTakeDamage, Character);
 	if (Health - DamageAmount <= 0.f)
 	{
 		Health = 0.f;
@@ -1192,7 +1837,7 @@ float AShooterCharacter::TakeDamage(float DamageAmount, FDamageEvent const& Dama
 		auto EnemyController = Cast<AEnemyController>(EventInstigator);
 		if (EnemyController)
 		{
-			EnemyController->GetBlackboardComponent()->SetValueAsBool(FName("bCharacterDead"), true);
+			EnemyController->SetCharacterDead(true);
 		}
 	}
 	else
@@ -1292,22 +1937,46 @@ void AShooterCharacter::GetPickupItem(AItem* Item)
 	auto Weapon = Cast<AWeapon>(Item);
 	if (Weapon)
 	{
-		if (Inventory.Num() < INVENTORY_CAPACITY)
-		{
-			Weapon->SetSlotIndex(Inventory.Num());
-			Inventory.Add(Weapon);
-			Weapon->SetItemState(EItemState::EIS_PickedUp);
-		}
-		else // Inventory is full, swap with equipped weapon
-		{
-			SwapWeapon(Weapon);
-		}
+		AddWeaponToInventory(Weapon);
 	}
 
 	auto Ammo = Cast<AAmmo>(Item);
+	int32 AddedAmmo{0};
+	EAmmoType AmmoType{EAmmoType::EAT_MAX};
 	if (Ammo)
 	{
+		AmmoType = Ammo->GetAmmoType();
+		const int32 CarriedAmmo{AmmoMap.FindRef(AmmoType)};
 		PickupAmmo(Ammo);
+		AddedAmmo = AmmoMap.FindRef(AmmoType) - CarriedAmmo;
+	}
+
+	// Owning clients don't wait for the server, it acks the pickup with its own inventory and ammo
+	const FName PickupId{Item->GetPickupId()};
+	const uint16 Sequence{PredictAction(EShooterActionType::Pickup, AddedAmmo, PickupId, AmmoType)};
+	if (Sequence != 0)
+	{
+		ServerPickupItem(Sequence, PickupId);
+	}
+
+	if (Ammo)
+	{
+		// Back to the pool for the next ammo pickup
+		UItemPoolSubsystem::ReleaseOrDestroy(Ammo);
+	}
+}
+
+void AShooterCharacter::AddWeaponToInventory(AWeapon* Weapon)
+{
+	if (Inventory.Num() < INVENTORY_CAPACITY)
+	{
+		Weapon->SetSlotIndex(Inventory.Num());
+		Inventory.Add(Weapon);
+		Weapon->SetItemState(EItemState::EIS_PickedUp);
+	}
+	else // Inventory is full, swap with equipped weapon
+	{
+		SwapWeapon(Weapon);
 	}
 }
 
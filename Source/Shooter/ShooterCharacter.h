@@ -4,9 +4,13 @@
 
 #include "CoreMinimal.h"
 #include "AmmoType.h"
+#include "LagCompensationSubsystem.h"
+#include "ShooterPrediction.h"
 #include "GameFramework/Character.h"
 #include "ShooterCharacter.generated.h"
 
+class AEnemy;
+
 UENUM(BlueprintType)
 enum class ECombatState : uint8
 {
@@ -34,6 +38,30 @@ struct FInterpLocation
 	
 };
 
+// Crosshair ray and trace result for a single frame, shared by everything that traces under the crosshairs.
+// An async shot's crosshair trace fills it on the frame it comes back, if the camera hasn't moved
+struct FCrosshairQueryCache
+{
+	// Frame the cached ray was deprojected on
+	uint64 FrameNumber{0};
+
+	// Camera transform the ray was deprojected from
+	FTransform CameraTransform;
+
+	bool bHasRay{false};
+	FVector RayStart{0.f};
+	FVector RayEnd{0.f};
+
+	// True once the crosshair trace was done for the cached ray
+	bool bHasTrace{false};
+	FHitResult HitResult;
+
+	FORCEINLINE bool IsValidFor(uint64 Frame, const FTransform& Camera) const
+	{
+		return bHasRay && FrameNumber == Frame && CameraTransform.Equals(Camera);
+	}
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FEquipItemDelegate, int32, CurrentSlotIndex, int32, NewSlotIndex);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FHighlightIconDelegate, int32, SlotIndex, bool, bStartAnimation);
 
@@ -50,6 +78,8 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Called for Forwards/Backwards input
 	void MoveForward(float Value);
 
@@ -69,7 +99,8 @@ protected:
 	// Called when the fire button is pressed
 	void FireWeapon();
 
-	bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FHitResult& OutHitResult);
+	// Deproject the crosshairs into a world space ray for traces
+	bool GetCrosshairRay(FVector& OutStart, FVector& OutEnd);
 
 	// Set bAiming to true or false with button input
 	void AimingButtonPressed();
@@ -82,7 +113,8 @@ protected:
 
 	void CalculateCrosshairSpread(float DeltaTime);
 	
-	void StartCrosshairBulletFire();
+	// @param ShotAge how long ago the shot was due, shortens the crosshair spread timer to match
+	void StartCrosshairBulletFire(float ShotAge = 0.f);
 	
 	UFUNCTION()
 	void FinishCrosshairBulletFire();
@@ -91,13 +123,28 @@ protected:
 	void FireButtonReleased();
 
 	void StartFireTimer();
-	
-	UFUNCTION()
-	void AutoFireReset();
 
-	// Line trace for items under the crosshairs
+	// Fire every automatic shot that came due since the last tick
+	void UpdateFireScheduler(float DeltaTime);
+
+	// Fire NumShots at once: one sound, muzzle flash, montage and trace for the batch, ammo for every shot
+	void FireShots(int32 NumShots, float ShotAge);
+
+	// Shows or hides the item's pickup widget, or the shared pickup prompt
+	void SetPickupPromptVisible(class AItem* Item, bool bVisible);
+
+	// Finds the item the crosshairs are on. Returns false if we couldn't look this frame
+	bool FindItemUnderCrosshairs(class AItem*& OutItem);
+
+	// Line trace for items under the crosshairs. Reuses this frame's trace if there is one
 	bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
 
+	// Keeps a crosshair trace done by the hitscan subsystem, for as long as the camera stays where it was
+	void CacheCrosshairTrace(const FHitResult& HitResult, FTransform CameraTransform, FVector RayStart, FVector RayEnd);
+
+	// Transform of the camera the crosshairs are deprojected from
+	FTransform GetCrosshairCameraTransform() const;
+
 	// Trace for Items if OverlappedItemCount > 0
 	void TraceForItems();
 
@@ -125,9 +172,91 @@ protected:
 	
 	// FireWeapon functions
 	void PlayFireSound();
-	void SendBullet();
+	void SendBullet(int32 NumShots, uint16 Sequence);
 	void PlayGunfireMontage();
 
+	// Applies damage and impact effects once the hitscan subsystem has traced the shot
+	void ResolveBullet(const FHitResult& BeamHitResult, bool bBeamEnd, FTransform SocketTransform, int32 NumShots,
+		uint16 Sequence);
+
+	// World time on the server, as far as this machine knows it
+	float GetServerWorldTimeSeconds() const;
+
+	// Damage and hit reactions for a hit the server accepted
+	void ApplyBulletHit(const FHitResult& HitResult, int32 NumShots);
+
+	// Impact effects a client plays for its own hit while the server confirms it
+	void PlayPredictedImpact(const FHitResult& HitResult);
+
+	// Clients send every shot here as they fire it, in order with their reloads and swaps. The server pays
+	// for the shots with its own ammo and acks them
+	// @param ClientTime server world time the client had when it fired
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerFire(uint16 Sequence, uint8 NumShots, float ClientTime);
+	void ServerFire_Implementation(uint16 Sequence, uint8 NumShots, float ClientTime);
+	bool ServerFire_Validate(uint16 Sequence, uint8 NumShots, float ClientTime);
+
+	// Hits follow their shots once the client's trace comes back, they only count once the lag
+	// compensation history confirms them
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerFireHit(const FShooterFireRequest& Request);
+	void ServerFireHit_Implementation(const FShooterFireRequest& Request);
+	bool ServerFireHit_Validate(const FShooterFireRequest& Request);
+
+	// Hit numbers for hits the server confirmed, shown on the shooting client
+	UFUNCTION(Client, Unreliable)
+	void ClientShowHitNumber(AEnemy* HitEnemy, int32 Damage, FVector_NetQuantize HitLocation, bool bHeadShot);
+	void ClientShowHitNumber_Implementation(AEnemy* HitEnemy, int32 Damage, FVector_NetQuantize HitLocation, bool bHeadShot);
+
+	// How many of the client's shots the server lets through, at most one per AutoFireRate
+	int32 LimitServerFireRate(int32 NumShots);
+
+	// Clients send reloads here once the montage finishes, the server moves its own carried ammo
+	UFUNCTION(Server, Reliable)
+	void ServerReload(uint16 Sequence);
+	void ServerReload_Implementation(uint16 Sequence);
+
+	UFUNCTION(Server, Reliable, WithValidation)
+	void ServerEquip(uint16 Sequence, int32 SlotIndex);
+	void ServerEquip_Implementation(uint16 Sequence, int32 SlotIndex);
+	bool ServerEquip_Validate(uint16 Sequence, int32 SlotIndex);
+
+	// Clients pick items up right away and send their pickup ID here, the server picks up its own copy of
+	// the item
+	UFUNCTION(Server, Reliable)
+	void ServerPickupItem(uint16 Sequence, FName PickupId);
+	void ServerPickupItem_Implementation(uint16 Sequence, FName PickupId);
+
+	// The server's weapon state after each client action, to check the client's prediction against.
+	// Reliable, a lost ack for the last action would leave it unchecked until the next one
+	UFUNCTION(Client, Reliable)
+	void ClientAckAction(const FShooterActionAck& Ack);
+	void ClientAckAction_Implementation(const FShooterActionAck& Ack);
+
+	// Acks a client action with the state it left on the server
+	void AckAction(uint16 Sequence);
+
+	// True on the owning client, which predicts its own fire, reload and weapon swaps
+	bool IsPredictingActions() const;
+
+	// False while the prediction buffer is full, new actions wait for the server to catch up
+	bool HasPredictionRoom() const;
+
+	// Records an action that was just applied locally. Returns its sequence, 0 if it wasn't predicted
+	uint16 PredictAction(EShooterActionType Type, int32 Param, FName PickupId = NAME_None,
+		EAmmoType AmmoType = EAmmoType::EAT_MAX);
+
+	FShooterPredictedState CapturePredictedState() const;
+
+	// Rolls back to the server's state
+	void ApplyPredictedState(const FShooterPredictedState& State);
+
+	// Rolls the inventory back to the server's. Weapons it doesn't have go back where they were picked up
+	void ApplyPredictedInventory(const FShooterPredictedState& State);
+
+	// Redoes an unacknowledged action on top of a rollback
+	void ReplayPredictedAction(const FShooterPredictedAction& Action);
+
 	// Bound to the R key and gamepad face button top
 	void ReloadButtonPressed();
 
@@ -137,6 +266,9 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void FinishReloading();
 
+	// Moves carried ammo into the equipped weapon's magazine
+	void TransferCarriedAmmo();
+
 	UFUNCTION(BlueprintCallable)
 	void FinishEquipping();
 
@@ -178,6 +310,9 @@ protected:
 
 	void ExchangeInventoryItems(int32 CurrentItemIndex, int32 NewItemIndex);
 
+	// Equips the weapon in the slot without a montage, for replaying and rolling back swaps
+	void EquipInventorySlot(int32 SlotIndex);
+
 	int32 GetEmptyInventorySlot();
 
 	void HighlightInventorySlot();
@@ -210,6 +345,10 @@ public:
 	void RagdollEnd();
 
 private:
+	// Drive firing and weapon swaps without input
+	friend class UShooterBenchmarkSubsystem;
+	friend struct FShooterLoopbackDriver;
+
 	// Camera boom positioning the camera behind the character
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class USpringArmComponent* CameraBoom;
@@ -323,12 +462,44 @@ private:
 	// True when we can fire, false when waiting for the timer
 	bool bShouldFire;
 
-	// Sets a timer between gunshots
-	FTimerHandle AutoFireTimer;
+	// Time left until the next automatic shot is due. Goes negative when shots are owed
+	float FireCooldownRemaining;
+
+	// Most shots the fire scheduler will fire in a single tick
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxShotsPerTick;
+
+	// Server world time the last client shot was allowed at, the server's own fire rate clock
+	float LastServerShotTime;
+
+	// Seconds of shots that may reach the server early, for shots that bunch up in transit
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float ServerFireTolerance;
+
+	// Actions the owning client applied that the server hasn't acknowledged yet
+	FShooterPredictionBuffer PredictedActions;
+
+	// Shots the server counted for the owning client, until their hits come in
+	FShooterServerShotBuffer ServerShots;
 
 	// True if we should trace every frame for items
 	bool bShouldTraceForItems;
 
+	// How far from the camera items can be picked out by the view cone query
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
+	float ItemQueryRange;
+
+	// Half angle of the view cone for the item query, in degrees
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
+	float ItemQueryAngle;
+
+	// Item the view cone query picked last, and whether the line of sight trace to it was clear
+	TWeakObjectPtr<class AItem> ItemQueryCandidate;
+	bool bItemQueryCandidateVisible;
+
+	// Crosshair ray/trace for the current frame
+	FCrosshairQueryCache CrosshairCache;
+
 	// Number of overlapped Aitems
 	int8 OverlappedItemCount;
 
@@ -463,7 +634,7 @@ private:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
 	TArray<AItem*> Inventory;
 
-	const int32 INVENTORY_CAPACITY{6};
+	const int32 INVENTORY_CAPACITY{SHOOTER_INVENTORY_CAPACITY};
 
 	// Delegate for sending slot information to InventoryBar when equipping
 	UPROPERTY(BlueprintAssignable, Category = Delegates, meta = (AllowPrivateAccess = "true"))
@@ -530,6 +701,9 @@ public:
 
 	void GetPickupItem(AItem* Item);
 
+	// Puts the weapon in the next free slot, or swaps it for the equipped weapon if the inventory is full
+	void AddWeaponToInventory(AWeapon* Weapon);
+
 	FORCEINLINE ECombatState GetCombatState() const { return CombatState; }
 
 	FORCEINLINE bool GetCrouching() const { return bCrouching; }
@@ -560,4 +734,9 @@ public:
 	FORCEINLINE float GetStunChance() const { return StunChance; }
 
 	FORCEINLINE bool GetDead() const { return bDead; }
+
+	// Counts the fire cooldown down by DeltaTime and returns the shots that came due, at most MaxShots.
+	// Shots past MaxShots are dropped rather than owed. OutShotAge is how long ago the last of them was due
+	static int32 AdvanceFireCooldown(float& CooldownRemaining, float DeltaTime, float FireInterval, int32 MaxShots,
+		float& OutShotAge);
 };
@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterDataRegistry.h"
+
+#include "Item.h"
+#include "ShooterStats.h"
+#include "Weapon.h"
+#include "Engine/DataTable.h"
+#include "Engine/Engine.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Data Table Row Lookups"), STAT_DataTableRowLookups, STATGROUP_Shooter);
+
+// Row names for each EItemRarity value
+static const FName RarityRowNames[] =
+{
+	FName("Damaged"),
+	FName("Common"),
+	FName("Uncommon"),
+	FName("Rare"),
+	FName("Legendary")
+};
+static_assert(UE_ARRAY_COUNT(RarityRowNames) == static_cast<int32>(EItemRarity::EIR_MAX), "Missing rarity row name");
+
+// Row names for each EWeaponType value
+static const FName WeaponRowNames[] =
+{
+	FName("SubmachineGun"),
+	FName("AssaultRifle"),
+	FName("Pistol")
+};
+static_assert(UE_ARRAY_COUNT(WeaponRowNames) == static_cast<int32>(EWeaponType::EWT_MAX), "Missing weapon row name");
+
+void UShooterDataRegistry::Deinitialize()
+{
+#if WITH_EDITOR
+	if (ItemRarityDataTable)
+	{
+		ItemRarityDataTable->OnDataTableChanged().RemoveAll(this);
+	}
+	if (WeaponDataTable)
+	{
+		WeaponDataTable->OnDataTableChanged().RemoveAll(this);
+	}
+#endif
+	ItemRarityDataTable = nullptr;
+	WeaponDataTable = nullptr;
+	RarityRows.Empty();
+	WeaponRows.Empty();
+	bLoaded = false;
+
+	Super::Deinitialize();
+}
+
+const FItemRarityTable* UShooterDataRegistry::GetRarityRow(EItemRarity Rarity)
+{
+	EnsureLoaded();
+	INC_DWORD_STAT(STAT_DataTableRowLookups);
+
+	const int32 Index{static_cast<int32>(Rarity)};
+	return RarityRows.IsValidIndex(Index) ? RarityRows[Index] : nullptr;
+}
+
+const FWeaponDataTable* UShooterDataRegistry::GetWeaponRow(EWeaponType WeaponType)
+{
+	EnsureLoaded();
+	INC_DWORD_STAT(STAT_DataTableRowLookups);
+
+	const int32 Index{static_cast<int32>(WeaponType)};
+	return WeaponRows.IsValidIndex(Index) ? WeaponRows[Index] : nullptr;
+}
+
+UShooterDataRegistry* UShooterDataRegistry::Get()
+{
+	return GEngine ? GEngine->GetEngineSubsystem<UShooterDataRegistry>() : nullptr;
+}
+
+void UShooterDataRegistry::EnsureLoaded()
+{
+	if (bLoaded) return;
+	bLoaded = true;
+
+	ItemRarityDataTable = Cast<UDataTable>(ItemRarityDataTablePath.TryLoad());
+	WeaponDataTable = Cast<UDataTable>(WeaponDataTablePath.TryLoad());
+
+#if WITH_EDITOR
+	// Pick up edits and reimports of the tables
+	if (ItemRarityDataTable)
+	{
+		ItemRarityDataTable->OnDataTableChanged().AddUObject(this, &UShooterDataRegistry::RebuildRarityRows);
+	}
+	if (WeaponDataTable)
+	{
+		WeaponDataTable->OnDataTableChanged().AddUObject(this, &UShooterDataRegistry::RebuildWeaponRows);
+	}
+#endif
+
+	RebuildRarityRows();
+	RebuildWeaponRows();
+}
+
+void UShooterDataRegistry::RebuildRarityRows()
+{
+	RarityRows.Init(nullptr, UE_ARRAY_COUNT(RarityRowNames));
+	if (!ItemRarityDataTable) return;
+
+	for (int32 i = 0; i < RarityRows.Num(); ++i)
+	{
+		RarityRows[i] = ItemRarityDataTable->FindRow<FItemRarityTable>(RarityRowNames[i], TEXT("UShooterDataRegistry"), false);
+	}
+}
+
+void UShooterDataRegistry::RebuildWeaponRows()
+{
+	WeaponRows.Init(nullptr, UE_ARRAY_COUNT(WeaponRowNames));
+	if (!WeaponDataTable) return;
+
+	for (int32 i = 0; i < WeaponRows.Num(); ++i)
+	{
+		WeaponRows[i] = WeaponDataTable->FindRow<FWeaponDataTable>(WeaponRowNames[i], TEXT("UShooterDataRegistry"), false);
+	}
+}
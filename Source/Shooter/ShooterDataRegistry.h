@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/EngineSubsystem.h"
+#include "ShooterDataRegistry.generated.h"
+
+class UDataTable;
+struct FItemRarityTable;
+struct FWeaponDataTable;
+enum class EItemRarity : uint8;
+enum class EWeaponType : uint8;
+
+/**
+ * Loads the item rarity and weapon data tables once and keeps their rows in arrays indexed by enum,
+ * so item construction doesn't load the tables and search them by row name every time.
+ * An engine subsystem so it's also there for construction scripts in the editor.
+ */
+UCLASS(config = Game)
+class SHOOTER_API UShooterDataRegistry : public UEngineSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Row for the rarity, or null if the table doesn't have it
+	const FItemRarityTable* GetRarityRow(EItemRarity Rarity);
+
+	// Row for the weapon type, or null if the table doesn't have it
+	const FWeaponDataTable* GetWeaponRow(EWeaponType WeaponType);
+
+	// The engine's registry, null before the engine is up
+	static UShooterDataRegistry* Get();
+
+private:
+	// Loads the tables on first use
+	void EnsureLoaded();
+
+	void RebuildRarityRows();
+	void RebuildWeaponRows();
+
+	UPROPERTY(config)
+	FSoftObjectPath ItemRarityDataTablePath{TEXT("/Game/_Game/DataTables/ItemRarityDataTable.ItemRarityDataTable")};
+
+	UPROPERTY(config)
+	FSoftObjectPath WeaponDataTablePath{TEXT("/Game/_Game/DataTables/WeaponDataTable.WeaponDataTable")};
+
+	UPROPERTY()
+	UDataTable* ItemRarityDataTable{nullptr};
+
+	UPROPERTY()
+	UDataTable* WeaponDataTable{nullptr};
+
+	// Rows indexed by EItemRarity / EWeaponType. They point into the tables and are rebuilt when a table changes
+	TArray<const FItemRarityTable*> RarityRows;
+	TArray<const FWeaponDataTable*> WeaponRows;
+
+	bool bLoaded{false};
+};
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterEventLogSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+
+void UShooterEventLogSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	bRecording = FParse::Param(FCommandLine::Get(), TEXT("ShooterEventLog"));
+}
+
+UShooterEventLogSubsystem* UShooterEventLogSubsystem::GetIfRecording(const UObject* WorldContextObject)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	UShooterEventLogSubsystem* EventLog = World ? World->GetSubsystem<UShooterEventLogSubsystem>() : nullptr;
+	return EventLog && EventLog->bRecording ? EventLog : nullptr;
+}
+
+void UShooterEventLogSubsystem::SetRecording(bool bInRecording)
+{
+	bRecording = bInRecording;
+}
+
+void UShooterEventLogSubsystem::RecordEvent(const UObject* Subject, const TCHAR* Event, const FString& Details)
+{
+	if (!bRecording || !Subject) return;
+
+	const int32* ExistingId = SubjectIds.Find(Subject);
+	const int32 SubjectId{ExistingId ? *ExistingId : SubjectIds.Add(Subject, SubjectIds.Num())};
+	Events.Add(FString::Printf(TEXT("%.4f %s#%d %s %s"), GetWorld()->GetTimeSeconds(),
+		*Subject->GetClass()->GetName(), SubjectId, Event, *Details));
+}
+
+void UShooterEventLogSubsystem::ResetEvents()
+{
+	Events.Reset();
+	SubjectIds.Reset();
+}
+
+bool UShooterEventLogSubsystem::SaveEvents(const FString& Path) const
+{
+	return FFileHelper::SaveStringArrayToFile(Events, *Path);
+}
+
+int32 UShooterEventLogSubsystem::FindFirstDifference(const TArray<FString>& EventsA, const TArray<FString>& EventsB)
+{
+	const int32 NumCommon{FMath::Min(EventsA.Num(), EventsB.Num())};
+	for (int32 i = 0; i < NumCommon; ++i)
+	{
+		if (!EventsA[i].Equals(EventsB[i], ESearchCase::CaseSensitive)) return i;
+	}
+	return EventsA.Num() == EventsB.Num() ? INDEX_NONE : NumCommon;
+}
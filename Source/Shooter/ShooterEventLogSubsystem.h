@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ShooterEventLogSubsystem.generated.h"
+
+/**
+ * Records gameplay events - spawns, damage, stuns, attack choices, deaths and drops - with the world time
+ * they happened at. Two runs with the same seed and a fixed timestep should record the same events, so
+ * comparing their logs finds where a run stopped being deterministic. Off unless started with
+ * -ShooterEventLog or turned on with SetRecording; benchmarks write it next to their CSV.
+ */
+UCLASS()
+class SHOOTER_API UShooterEventLogSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// The world's log if it's recording, so callers only format events someone will read
+	static UShooterEventLogSubsystem* GetIfRecording(const UObject* WorldContextObject);
+
+	void SetRecording(bool bInRecording);
+
+	FORCEINLINE bool IsRecording() const { return bRecording; }
+
+	// Adds an event for Subject at the current world time. Subjects are numbered in the order they first
+	// appear, names would differ between runs in the same process
+	void RecordEvent(const UObject* Subject, const TCHAR* Event, const FString& Details = FString());
+
+	FORCEINLINE const TArray<FString>& GetEvents() const { return Events; }
+
+	// Forgets the events and the subject numbers
+	void ResetEvents();
+
+	bool SaveEvents(const FString& Path) const;
+
+	// Index of the first event the logs disagree on, INDEX_NONE if they're the same
+	static int32 FindFirstDifference(const TArray<FString>& EventsA, const TArray<FString>& EventsB);
+
+private:
+	TArray<FString> Events;
+
+	TMap<FObjectKey, int32> SubjectIds;
+
+	bool bRecording{false};
+};
@@ -3,3 +3,155 @@
 
 #include "ShooterGameModeBase.h"
 
+#include "Enemy.h"
+#include "Item.h"
+#include "ItemPoolSubsystem.h"
+#include "Shooter.h"
+#include "ShooterRandomSubsystem.h"
+#include "ShooterStats.h"
+#include "Kismet/GameplayStatics.h"
+
+DECLARE_CYCLE_STAT(TEXT("Start Wave"), STAT_StartWave, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Enemies Spawned"), STAT_EnemiesSpawned, STATGROUP_Shooter);
+
+AShooterGameModeBase::AShooterGameModeBase() :
+EnemyPoolSize(0),
+TimeBetweenWaves(5.f),
+RandomSeed(0),
+SpawnPointTag(TEXT("EnemySpawn")),
+CurrentWave(INDEX_NONE),
+EnemiesAlive(0),
+WaveStartTime(0.f)
+{
+}
+
+void AShooterGameModeBase::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	// Before any actor begins play, so the first rolls already come from the seed
+	RandomSeed = UGameplayStatics::GetIntOption(Options, TEXT("RandomSeed"), RandomSeed);
+	UShooterRandomSubsystem* Random = GetWorld()->GetSubsystem<UShooterRandomSubsystem>();
+	if (Random && RandomSeed != 0)
+	{
+		Random->SetDefaultSeed(RandomSeed);
+	}
+}
+
+void AShooterGameModeBase::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Warm the item pools so pickups and drops don't spawn actors during play
+	UItemPoolSubsystem* ItemPool = GetWorld()->GetSubsystem<UItemPoolSubsystem>();
+	if (ItemPool)
+	{
+		for (const auto& PoolSize : ItemPoolSizes)
+		{
+			ItemPool->PrewarmPool(PoolSize.Key, PoolSize.Value);
+		}
+	}
+
+	if (!WaveEnemyClass || WaveSizes.Num() == 0) return;
+
+	UGameplayStatics::GetAllActorsWithTag(this, SpawnPointTag, SpawnPoints);
+	if (SpawnPoints.Num() == 0)
+	{
+		UE_LOG(LogShooter, Warning, TEXT("No actors tagged %s to spawn waves at"), *SpawnPointTag.ToString());
+		return;
+	}
+
+	// Pay for actor construction, possession and behavior tree setup while the map loads
+	PrewarmEnemyPool();
+	GetWorldTimerManager().SetTimer(WaveTimer, this, &AShooterGameModeBase::StartNextWave, TimeBetweenWaves);
+}
+
+void AShooterGameModeBase::EnemyKilled(AEnemy* Enemy)
+{
+	if (EnemiesAlive <= 0) return;
+	--EnemiesAlive;
+	if (EnemiesAlive > 0) return;
+
+	UE_LOG(LogShooter, Log, TEXT("Wave %d cleared in %.1f s"), CurrentWave + 1, GetWorld()->TimeSince(WaveStartTime));
+	if (WaveSizes.IsValidIndex(CurrentWave + 1))
+	{
+		GetWorldTimerManager().SetTimer(WaveTimer, this, &AShooterGameModeBase::StartNextWave, TimeBetweenWaves);
+	}
+}
+
+void AShooterGameModeBase::ReleaseEnemy(AEnemy* Enemy)
+{
+	if (!Enemy || DormantEnemies.Contains(Enemy)) return;
+
+	Enemy->ResetForPool();
+	DormantEnemies.Add(Enemy);
+}
+
+void AShooterGameModeBase::PrewarmEnemyPool()
+{
+	while (DormantEnemies.Num() < EnemyPoolSize)
+	{
+		AEnemy* Enemy = SpawnPooledEnemy();
+		if (!Enemy) break;
+
+		Enemy->ResetForPool();
+		DormantEnemies.Add(Enemy);
+	}
+}
+
+AEnemy* AShooterGameModeBase::SpawnPooledEnemy()
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	AEnemy* Enemy = GetWorld()->SpawnActor<AEnemy>(WaveEnemyClass, SpawnPoints[0]->GetActorTransform(), SpawnParams);
+	if (!Enemy) return nullptr;
+	INC_DWORD_STAT(STAT_EnemiesSpawned);
+
+	Enemy->SetPooled(true);
+	if (!Enemy->GetController())
+	{
+		Enemy->SpawnDefaultController();
+	}
+	return Enemy;
+}
+
+void AShooterGameModeBase::StartNextWave()
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_StartWave, Enemies);
+	++CurrentWave;
+	if (!WaveSizes.IsValidIndex(CurrentWave)) return;
+
+	const double StartSeconds{FPlatformTime::Seconds()};
+	int32 NumSpawned{0};
+
+	for (int32 i = 0; i < WaveSizes[CurrentWave]; ++i)
+	{
+		AEnemy* Enemy{nullptr};
+		while (DormantEnemies.Num() > 0 && !Enemy)
+		{
+			// Skip anything destroyed while it was dormant
+			Enemy = DormantEnemies.Pop(false);
+			if (!IsValid(Enemy))
+			{
+				Enemy = nullptr;
+			}
+		}
+		if (!Enemy)
+		{
+			Enemy = SpawnPooledEnemy();
+			if (!Enemy) continue;
+			++NumSpawned;
+		}
+
+		const AActor* SpawnPoint = SpawnPoints[i % SpawnPoints.Num()];
+		Enemy->ActivateFromPool(SpawnPoint->GetActorTransform());
+		++EnemiesAlive;
+	}
+
+	WaveStartTime = GetWorld()->GetTimeSeconds();
+
+	// Hitch report, a wave served entirely from the pool spawns nothing
+	const double ActivationMs{(FPlatformTime::Seconds() - StartSeconds) * 1000.0};
+	UE_LOG(LogShooter, Log, TEXT("Wave %d: activated %d enemies in %.2f ms, %d spawned outside the pool, %d left dormant"),
+		CurrentWave + 1, EnemiesAlive, ActivationMs, NumSpawned, DormantEnemies.Num());
+}
@@ -6,6 +6,9 @@
 #include "GameFramework/GameModeBase.h"
 #include "ShooterGameModeBase.generated.h"
 
+class AEnemy;
+class AItem;
+
 /**
  * 
  */
@@ -13,5 +16,70 @@ UCLASS()
 class SHOOTER_API AShooterGameModeBase : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	AShooterGameModeBase();
+
+	// Called by pooled enemies when they die
+	void EnemyKilled(AEnemy* Enemy);
+
+	// Takes a dead pooled enemy back, hidden until a later wave needs it
+	void ReleaseEnemy(AEnemy* Enemy);
+
+protected:
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+
+	virtual void BeginPlay() override;
+
+private:
+	// Spawns enemies and their controllers up to EnemyPoolSize, all dormant
+	void PrewarmEnemyPool();
+
+	AEnemy* SpawnPooledEnemy();
+
+	// Activates the enemies for the next entry in WaveSizes at the spawn points
+	void StartNextWave();
+
+	// Number of hidden items spawned into the item pool for each class when the map loads
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Pooling, meta = (AllowPrivateAccess = "true"))
+	TMap<TSubclassOf<AItem>, int32> ItemPoolSizes;
+
+	// Enemy spawned for waves, waves are off without one
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<AEnemy> WaveEnemyClass;
+
+	// Enemies spawned dormant when the map loads. Waves bigger than the pool spawn the rest during play
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	int32 EnemyPoolSize;
+
+	// Number of enemies in each wave
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	TArray<int32> WaveSizes;
+
+	// Time from the start of play, or from clearing a wave, to the next wave
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	float TimeBetweenWaves;
+
+	// Seed for the gameplay random streams, 0 leaves them seeded from the clock. ?RandomSeed= in the URL overrides it
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Random, meta = (AllowPrivateAccess = "true"))
+	int32 RandomSeed;
+
+	// Tag on the actors enemies are spawned at
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Waves, meta = (AllowPrivateAccess = "true"))
+	FName SpawnPointTag;
+
+	UPROPERTY()
+	TArray<AActor*> SpawnPoints;
+
+	UPROPERTY()
+	TArray<AEnemy*> DormantEnemies;
+
+	int32 CurrentWave;
+
+	int32 EnemiesAlive;
+
+	FTimerHandle WaveTimer;
+
+	// World time the current wave started
+	float WaveStartTime;
 };
@@ -3,9 +3,24 @@
 
 #include "ShooterPlayerController.h"
 
+#include "HitNumberLayer.h"
+#include "Item.h"
+#include "PickupPromptWidget.h"
+#include "Shooter.h"
+#include "ShooterStats.h"
 #include "Blueprint/UserWidget.h"
+#include "GameFramework/Pawn.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
 
-AShooterPlayerController::AShooterPlayerController()
+DECLARE_CYCLE_STAT(TEXT("Player Controller Tick"), STAT_PlayerControllerTick, STATGROUP_Shooter);
+
+AShooterPlayerController::AShooterPlayerController() :
+MaxHitNumbers(64),
+bBot(false),
+BotTurnRate(45.f),
+BotBurstTime(2.f),
+BotBurstElapsed(0.f)
 {
 	
 }
@@ -14,6 +29,12 @@ void AShooterPlayerController::BeginPlay()
 {
 	Super::BeginPlay();
 
+	if (IsLocalController() && FParse::Param(FCommandLine::Get(), TEXT("ShooterBot")))
+	{
+		bBot = true;
+		UE_LOG(LogShooter, Log, TEXT("%s is playing as a bot"), *GetName());
+	}
+
 	// Check out HUDOverlayClass' TSubclassOf variable
 	if (HUDOverlayClass)
 	{
@@ -24,4 +45,107 @@ void AShooterPlayerController::BeginPlay()
 			HUDOverlay->SetVisibility(ESlateVisibility::Visible);
 		}
 	}
+
+	// One pickup prompt for every item, hidden until the player looks at one
+	if (PickupPromptClass)
+	{
+		PickupPrompt = CreateWidget<UPickupPromptWidget>(this, PickupPromptClass);
+		if (PickupPrompt)
+		{
+			PickupPrompt->AddToViewport();
+			PickupPrompt->SetAlignmentInViewport(FVector2D(0.5f, 1.f));
+			PickupPrompt->SetVisibility(ESlateVisibility::Collapsed);
+		}
+	}
+
+	HitNumberLayer = NewObject<UHitNumberLayer>(this);
+	HitNumberLayer->Initialize(this, HitNumberWidgetClass, MaxHitNumbers);
+}
+
+void AShooterPlayerController::PlayerTick(float DeltaTime)
+{
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_PlayerControllerTick, UI);
+	Super::PlayerTick(DeltaTime);
+
+	if (bBot)
+	{
+		UpdateBot(DeltaTime);
+	}
+
+	UpdatePickupPromptPosition();
+
+	if (HitNumberLayer)
+	{
+		HitNumberLayer->Update();
+	}
+}
+
+bool AShooterPlayerController::ShowPickupPrompt(AItem* Item)
+{
+	if (!PickupPrompt || !Item) return false;
+
+	PickupPrompt->SetItem(Item);
+	if (PickupPromptItem != Item)
+	{
+		PickupPromptItem = Item;
+		UpdatePickupPromptPosition();
+	}
+	return true;
+}
+
+void AShooterPlayerController::HidePickupPrompt(AItem* Item)
+{
+	if (!PickupPrompt || PickupPromptItem != Item) return;
+
+	PickupPromptItem = nullptr;
+	PickupPrompt->SetVisibility(ESlateVisibility::Collapsed);
+}
+
+void AShooterPlayerController::UpdatePickupPromptPosition()
+{
+	if (!PickupPrompt || !PickupPromptItem) return;
+
+	// Hide it once the item can't be picked up anymore
+	FVector2D ScreenPosition;
+	const bool bOnScreen{PickupPromptItem->GetItemState() == EItemState::EIS_Pickup &&
+		ProjectWorldLocationToScreen(PickupPromptItem->GetPickupPromptLocation(), ScreenPosition, true)};
+	if (!bOnScreen)
+	{
+		PickupPrompt->SetVisibility(ESlateVisibility::Collapsed);
+		return;
+	}
+
+	PickupPrompt->SetPositionInViewport(ScreenPosition, false);
+	PickupPrompt->SetVisibility(ESlateVisibility::HitTestInvisible);
+}
+
+void AShooterPlayerController::SetBot(bool bInBot)
+{
+	if (bInBot == bBot) return;
+
+	// Let go of the fire button if the bot was holding it
+	if (bBot && BotBurstElapsed < BotBurstTime)
+	{
+		InputKey(EKeys::LeftMouseButton, IE_Released, 0.f, false);
+	}
+	bBot = bInBot;
+	BotBurstElapsed = 0.f;
+}
+
+void AShooterPlayerController::UpdateBot(float DeltaTime)
+{
+	APawn* ControlledPawn = GetPawn();
+	if (!ControlledPawn) return;
+
+	AddYawInput(BotTurnRate * DeltaTime / FMath::Max(InputYawScale, KINDA_SMALL_NUMBER));
+	ControlledPawn->AddMovementInput(ControlledPawn->GetActorForwardVector());
+
+	// Pressing keys goes through the same bindings, firing and reloading as a real player
+	const bool bWasFiring{BotBurstElapsed < BotBurstTime};
+	BotBurstElapsed = FMath::Fmod(BotBurstElapsed + DeltaTime, BotBurstTime * 2.f);
+	const bool bFiring{BotBurstElapsed < BotBurstTime};
+	if (bFiring != bWasFiring)
+	{
+		InputKey(EKeys::LeftMouseButton, bFiring ? IE_Pressed : IE_Released, bFiring ? 1.f : 0.f, false);
+	}
 }
@@ -6,6 +6,11 @@
 #include "GameFramework/PlayerController.h"
 #include "ShooterPlayerController.generated.h"
 
+class AItem;
+class UHitNumberLayer;
+class UHitNumberWidget;
+class UPickupPromptWidget;
+
 /**
  * 
  */
@@ -16,10 +21,29 @@ class SHOOTER_API AShooterPlayerController : public APlayerController
 public:
 	AShooterPlayerController();
 
+	virtual void PlayerTick(float DeltaTime) override;
+
+	// Show the shared pickup prompt for this item. Returns false if there is no shared prompt
+	bool ShowPickupPrompt(AItem* Item);
+
+	// Hide the shared pickup prompt if it's showing this item
+	void HidePickupPrompt(AItem* Item);
+
+	FORCEINLINE UHitNumberLayer* GetHitNumberLayer() const { return HitNumberLayer; }
+
+	// Plays as a bot from now on, as -ShooterBot does from the start
+	void SetBot(bool bInBot);
+
 protected:
 
 	virtual void BeginPlay() override;
 
+	// Keeps the pickup prompt over its item
+	void UpdatePickupPromptPosition();
+
+	// Runs and shoots in circles through the player's own input, for load tests
+	void UpdateBot(float DeltaTime);
+
 private:
 	// Reference to the ShooterHUDOverlay blueprint class
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
@@ -28,5 +52,41 @@ private:
 	// Variable to hold the HUDOverlay widget after creating it
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
 	UUserWidget* HUDOverlay;
-	
+
+	// Widget class for the pickup prompt shared by all items
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UPickupPromptWidget> PickupPromptClass;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	UPickupPromptWidget* PickupPrompt;
+
+	// Item the pickup prompt is over, null while hidden
+	UPROPERTY()
+	AItem* PickupPromptItem;
+
+	// Hit number widget class pre-created by the hit number layer
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UHitNumberWidget> HitNumberWidgetClass;
+
+	// Most hit numbers on screen at once
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Widgets, meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxHitNumbers;
+
+	// Draws every enemy's hit numbers
+	UPROPERTY()
+	UHitNumberLayer* HitNumberLayer;
+
+	// Set by -ShooterBot on the command line
+	bool bBot;
+
+	// Degrees per second a bot turns while running
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true"))
+	float BotTurnRate;
+
+	// Seconds a bot holds and then releases the fire button
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Bot, meta = (AllowPrivateAccess = "true", ClampMin = "0.1"))
+	float BotBurstTime;
+
+	float BotBurstElapsed;
+
 };
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterPrediction.h"
+
+static_assert(SHOOTER_NUM_AMMO_TYPES == static_cast<int32>(EAmmoType::EAT_MAX), "Predicted state needs a slot per ammo type");
+
+uint16 FShooterPredictionBuffer::Add(const FShooterPredictedAction& Action)
+{
+	if (IsFull())
+	{
+		Head = (Head + 1) % Capacity;
+		--Count;
+	}
+
+	++LastSequence;
+	if (LastSequence == 0)
+	{
+		++LastSequence;
+	}
+
+	FShooterPredictedAction& Slot = Actions[(Head + Count) % Capacity];
+	Slot = Action;
+	Slot.Sequence = LastSequence;
+	++Count;
+	return LastSequence;
+}
+
+bool FShooterPredictionBuffer::Acknowledge(uint16 Sequence, TOptional<FShooterPredictedState>& OutPredictedState)
+{
+	// The newest ack already covers older ones
+	if (!IsNewerSequence(Sequence, LastAckedSequence)) return false;
+	LastAckedSequence = Sequence;
+
+	OutPredictedState.Reset();
+	while (Count > 0 && !IsNewerSequence(Actions[Head].Sequence, Sequence))
+	{
+		if (Actions[Head].Sequence == Sequence)
+		{
+			OutPredictedState = Actions[Head].State;
+		}
+		Head = (Head + 1) % Capacity;
+		--Count;
+	}
+	return true;
+}
+
+void FShooterServerShotBuffer::Add(uint16 Sequence, int32 NumShots, float ClientTime)
+{
+	if (Sequence == 0) return;
+
+	FShooterServerShot& Shot = Shots[Sequence % Capacity];
+	Shot.Sequence = Sequence;
+	Shot.NumShots = NumShots;
+	Shot.ClientTime = ClientTime;
+}
+
+bool FShooterServerShotBuffer::Take(uint16 Sequence, FShooterServerShot& OutShot)
+{
+	FShooterServerShot& Shot = Shots[Sequence % Capacity];
+	if (Sequence == 0 || Shot.Sequence != Sequence) return false;
+
+	OutShot = Shot;
+	Shot.Sequence = 0;
+	return true;
+}
@@ -0,0 +1,166 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AmmoType.h"
+#include "ShooterPrediction.generated.h"
+
+// The character's inventory capacity, the predicted state has a slot for each
+#define SHOOTER_INVENTORY_CAPACITY 6
+
+// Ammo types the character carries, all of EAmmoType but EAT_MAX
+#define SHOOTER_NUM_AMMO_TYPES 2
+
+// Weapon and inventory state a predicted action leaves behind, compared against the server's after the same action
+USTRUCT()
+struct FShooterPredictedState
+{
+	GENERATED_BODY()
+
+	// Inventory slot of the equipped weapon
+	UPROPERTY()
+	int32 SlotIndex{INDEX_NONE};
+
+	// Ammo in the equipped weapon
+	UPROPERTY()
+	int32 Ammo{0};
+
+	// Ammo carried of each type
+	UPROPERTY()
+	int32 CarriedAmmo[SHOOTER_NUM_AMMO_TYPES]{};
+
+	UPROPERTY()
+	int32 NumInventoryItems{0};
+
+	// Pickup ID of the item in each inventory slot, None for the default weapon
+	UPROPERTY()
+	FName InventoryIds[SHOOTER_INVENTORY_CAPACITY];
+
+	FORCEINLINE bool operator==(const FShooterPredictedState& Other) const
+	{
+		if (SlotIndex != Other.SlotIndex || Ammo != Other.Ammo || NumInventoryItems != Other.NumInventoryItems) return false;
+
+		for (int32 i = 0; i < SHOOTER_NUM_AMMO_TYPES; ++i)
+		{
+			if (CarriedAmmo[i] != Other.CarriedAmmo[i]) return false;
+		}
+		for (int32 i = 0; i < NumInventoryItems; ++i)
+		{
+			if (InventoryIds[i] != Other.InventoryIds[i]) return false;
+		}
+		return true;
+	}
+	FORCEINLINE bool operator!=(const FShooterPredictedState& Other) const { return !(*this == Other); }
+};
+
+// The server's state right after it handled a client action
+USTRUCT()
+struct FShooterActionAck
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	uint16 Sequence{0};
+
+	UPROPERTY()
+	FShooterPredictedState State;
+};
+
+enum class EShooterActionType : uint8
+{
+	// Param is the number of shots
+	Fire,
+	Reload,
+	// Param is the inventory slot equipped
+	Equip,
+	// Param is the ammo the pickup added, of AmmoType
+	Pickup
+};
+
+struct FShooterPredictedAction
+{
+	uint16 Sequence{0};
+	EShooterActionType Type{EShooterActionType::Fire};
+	int32 Param{0};
+
+	// Item a pickup took, to find it again when the pickup is replayed
+	FName PickupId;
+
+	// Type of the ammo a pickup added, EAT_MAX if it added none
+	EAmmoType AmmoType{EAmmoType::EAT_MAX};
+
+	// State right after the action, as the client predicted it
+	FShooterPredictedState State;
+};
+
+/**
+ * Client actions the server hasn't acknowledged yet, oldest first, in a ring of fixed capacity.
+ * Sequence numbers wrap and skip 0, which marks an action that wasn't predicted.
+ */
+class SHOOTER_API FShooterPredictionBuffer
+{
+public:
+	static constexpr int32 Capacity{64};
+
+	// Records an action under a new sequence and returns it. When full the oldest action is dropped, its ack
+	// then can't be checked and forces a rollback
+	uint16 Add(const FShooterPredictedAction& Action);
+
+	// Drops every action up to and including Sequence and returns the state predicted for it, if it
+	// was still here. Returns false for acks older than one already handled
+	bool Acknowledge(uint16 Sequence, TOptional<FShooterPredictedState>& OutPredictedState);
+
+	FORCEINLINE int32 Num() const { return Count; }
+	FORCEINLINE bool IsFull() const { return Count == Capacity; }
+
+	// Unacknowledged action by age, 0 is the oldest
+	FORCEINLINE FShooterPredictedAction& operator[](int32 Index)
+	{
+		check(Index >= 0 && Index < Count);
+		return Actions[(Head + Index) % Capacity];
+	}
+
+	// True if A was issued after B, allowing for wrap around
+	static FORCEINLINE bool IsNewerSequence(uint16 A, uint16 B) { return static_cast<int16>(A - B) > 0; }
+
+private:
+	FShooterPredictedAction Actions[Capacity];
+
+	int32 Head{0};
+
+	int32 Count{0};
+
+	uint16 LastSequence{0};
+
+	uint16 LastAckedSequence{0};
+};
+
+// Shots the server took ammo for, waiting for the client's hit
+struct FShooterServerShot
+{
+	uint16 Sequence{0};
+
+	int32 NumShots{0};
+
+	// Server world time the client had when it fired
+	float ClientTime{0.f};
+};
+
+/**
+ * Shots the server counted, kept by sequence until the client's hit for them comes in. Each sequence has a
+ * fixed slot that is reused as sequences come round, so hits more than Capacity shots late are dropped.
+ */
+class SHOOTER_API FShooterServerShotBuffer
+{
+public:
+	static constexpr int32 Capacity{64};
+
+	void Add(uint16 Sequence, int32 NumShots, float ClientTime);
+
+	// Finds the shot and removes it, so it can only hit once
+	bool Take(uint16 Sequence, FShooterServerShot& OutShot);
+
+private:
+	FShooterServerShot Shots[Capacity];
+};
@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterRandomSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
+namespace ShooterRandom
+{
+	static const TCHAR* StreamNames[] =
+	{
+		TEXT("Combat"),
+		TEXT("AI"),
+		TEXT("Loot")
+	};
+	static_assert(UE_ARRAY_COUNT(StreamNames) == static_cast<int32>(EShooterRandomStream::MAX), "Missing stream name");
+
+	static void PrintState(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const UShooterRandomSubsystem* Random = World ? World->GetSubsystem<UShooterRandomSubsystem>() : nullptr;
+		if (Random)
+		{
+			Ar.Log(Random->GetStateString());
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice StateCommand(
+		TEXT("Shooter.RandomState"),
+		TEXT("Prints the gameplay random seed and the current state of each stream."),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&PrintState));
+}
+
+void UShooterRandomSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	int32 CommandLineSeed{0};
+	if (FParse::Value(FCommandLine::Get(), TEXT("ShooterSeed="), CommandLineSeed))
+	{
+		SetSeed(CommandLineSeed);
+		bSeededFromCommandLine = true;
+	}
+	else
+	{
+		SetSeed(static_cast<int32>(FPlatformTime::Cycles()));
+	}
+}
+
+void UShooterRandomSubsystem::SetSeed(int32 InSeed)
+{
+	Seed = InSeed;
+	for (int32 i = 0; i < static_cast<int32>(EShooterRandomStream::MAX); ++i)
+	{
+		// Each stream gets its own seed so they don't repeat each other
+		Streams[i].Initialize(static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(i))));
+	}
+}
+
+void UShooterRandomSubsystem::SetDefaultSeed(int32 InSeed)
+{
+	if (!bSeededFromCommandLine)
+	{
+		SetSeed(InSeed);
+	}
+}
+
+FRandomStream& UShooterRandomSubsystem::GetStream(const UObject* WorldContextObject, EShooterRandomStream Stream)
+{
+	const UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::ReturnNull) : nullptr;
+	UShooterRandomSubsystem* Random = World ? World->GetSubsystem<UShooterRandomSubsystem>() : nullptr;
+	if (Random)
+	{
+		return Random->GetStream(Stream);
+	}
+
+	static FRandomStream Fallback{static_cast<int32>(FPlatformTime::Cycles())};
+	return Fallback;
+}
+
+FString UShooterRandomSubsystem::GetStateString() const
+{
+	FString State{FString::Printf(TEXT("Seed %d"), Seed)};
+	for (int32 i = 0; i < static_cast<int32>(EShooterRandomStream::MAX); ++i)
+	{
+		State += FString::Printf(TEXT(", %s %d"), ShooterRandom::StreamNames[i], Streams[i].GetCurrentSeed());
+	}
+	return State;
+}
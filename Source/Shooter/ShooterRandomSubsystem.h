@@ -0,0 +1,58 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Math/RandomStream.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ShooterRandomSubsystem.generated.h"
+
+// Independent random sequences, so extra rolls in one system don't shift another
+enum class EShooterRandomStream : uint8
+{
+	// Stun rolls and hit reactions
+	Combat,
+	// Attack choices
+	AI,
+	// Drops and thrown weapons
+	Loot,
+
+	MAX
+};
+
+/**
+ * Per world random streams for gameplay rolls. Seeded with -ShooterSeed=N on the command line, otherwise
+ * by the game mode, otherwise from the clock as before. With a seed and a fixed timestep (-benchmark -fps=60)
+ * two runs roll the same numbers; Shooter.RandomState prints the stream states to compare runs.
+ */
+UCLASS()
+class SHOOTER_API UShooterRandomSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// Reseeds every stream from one seed
+	void SetSeed(int32 InSeed);
+
+	// Seeds the streams unless the command line already did
+	void SetDefaultSeed(int32 InSeed);
+
+	FORCEINLINE FRandomStream& GetStream(EShooterRandomStream Stream) { return Streams[static_cast<int32>(Stream)]; }
+
+	// The world's stream, or an unseeded fallback for objects outside a world
+	static FRandomStream& GetStream(const UObject* WorldContextObject, EShooterRandomStream Stream);
+
+	FORCEINLINE int32 GetSeed() const { return Seed; }
+
+	// Seed and current state of each stream, identical between runs that rolled the same numbers
+	FString GetStateString() const;
+
+private:
+	FRandomStream Streams[static_cast<int32>(EShooterRandomStream::MAX)];
+
+	int32 Seed{0};
+
+	bool bSeededFromCommandLine{false};
+};
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterStats.h"
+
+#include "HAL/IConsoleManager.h"
+#include <atomic>
+
+#if SHOOTER_FRAME_STATS
+
+namespace ShooterFrameStats
+{
+	static const TCHAR* Names[] =
+	{
+		TEXT("Character"),
+		TEXT("Weapons"),
+		TEXT("Items"),
+		TEXT("Enemies"),
+		TEXT("AI"),
+		TEXT("Animation"),
+		TEXT("UI")
+	};
+	static_assert(UE_ARRAY_COUNT(Names) == static_cast<int32>(EShooterFrameStat::MAX), "Missing frame stat name");
+
+	// Anim updates run on worker threads, so the totals are atomic
+	static std::atomic<uint64> Cycles[static_cast<int32>(EShooterFrameStat::MAX)];
+	static std::atomic<uint32> Calls[static_cast<int32>(EShooterFrameStat::MAX)];
+	static uint64 FirstFrame{0};
+
+	// Innermost open scope on this thread
+	static thread_local FShooterFrameStatScope* CurrentScope{nullptr};
+
+	static void Dump(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		const uint64 NumFrames{FMath::Max<uint64>(GFrameCounter - FirstFrame, 1)};
+		Ar.Logf(TEXT("Shooter frame time over %llu frames (game and anim worker threads, exclusive):"), NumFrames);
+
+		double TotalMs{0.0};
+		for (int32 i = 0; i < static_cast<int32>(EShooterFrameStat::MAX); ++i)
+		{
+			const double Ms{FPlatformTime::ToMilliseconds64(Cycles[i].exchange(0)) / NumFrames};
+			const double CallsPerFrame{static_cast<double>(Calls[i].exchange(0)) / NumFrames};
+			TotalMs += Ms;
+			Ar.Logf(TEXT("  %-10s %8.3f ms  %8.1f scopes/frame"), Names[i], Ms, CallsPerFrame);
+		}
+		Ar.Logf(TEXT("  %-10s %8.3f ms"), TEXT("Total"), TotalMs);
+
+		FirstFrame = GFrameCounter;
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice DumpCommand(
+		TEXT("Shooter.DumpFrameStats"),
+		TEXT("Prints the average frame time of each Shooter system since the last dump, then resets it."),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&Dump));
+}
+
+FShooterFrameStatScope::FShooterFrameStatScope(EShooterFrameStat InFrameStat) :
+FrameStat(InFrameStat),
+StartCycles(FPlatformTime::Cycles()),
+Parent(ShooterFrameStats::CurrentScope)
+{
+	// The parent stops counting while we run
+	if (Parent)
+	{
+		Parent->Flush(StartCycles);
+	}
+	ShooterFrameStats::CurrentScope = this;
+	ShooterFrameStats::Calls[static_cast<int32>(FrameStat)].fetch_add(1, std::memory_order_relaxed);
+}
+
+FShooterFrameStatScope::~FShooterFrameStatScope()
+{
+	const uint32 NowCycles{FPlatformTime::Cycles()};
+	Flush(NowCycles);
+
+	ShooterFrameStats::CurrentScope = Parent;
+	if (Parent)
+	{
+		Parent->StartCycles = NowCycles;
+	}
+}
+
+void FShooterFrameStatScope::Flush(uint32 NowCycles)
+{
+	ShooterFrameStats::Cycles[static_cast<int32>(FrameStat)].fetch_add(NowCycles - StartCycles, std::memory_order_relaxed);
+	StartCycles = NowCycles;
+}
+
+#endif
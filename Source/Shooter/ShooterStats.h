@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Stats/Stats.h"
+
+// Stat group for the Shooter module, view with "stat Shooter"
+DECLARE_STATS_GROUP(TEXT("Shooter"), STATGROUP_Shooter, STATCAT_Advanced);
+
+// Per system frame timing for Shooter.DumpFrameStats, off in Shipping
+#ifndef SHOOTER_FRAME_STATS
+#define SHOOTER_FRAME_STATS !UE_BUILD_SHIPPING
+#endif
+
+// Systems that Shooter.DumpFrameStats reports frame time for
+enum class EShooterFrameStat : uint8
+{
+	Character,
+	Weapons,
+	Items,
+	Enemies,
+	AI,
+	Animation,
+	UI,
+
+	MAX
+};
+
+#if SHOOTER_FRAME_STATS
+// Adds the time spent in the scope to a system, minus any Shooter scopes nested inside it
+class SHOOTER_API FShooterFrameStatScope
+{
+public:
+	explicit FShooterFrameStatScope(EShooterFrameStat InFrameStat);
+	~FShooterFrameStatScope();
+
+	FShooterFrameStatScope(const FShooterFrameStatScope&) = delete;
+	FShooterFrameStatScope& operator=(const FShooterFrameStatScope&) = delete;
+
+private:
+	// Adds the cycles since StartCycles and restarts the count
+	void Flush(uint32 NowCycles);
+
+	EShooterFrameStat FrameStat;
+	uint32 StartCycles;
+	FShooterFrameStatScope* Parent;
+};
+
+// Cycle counter, Insights CPU scope and frame time for a system, all compiled out in Shipping
+#define SHOOTER_SCOPE_CYCLE_COUNTER(Stat, FrameStat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat); \
+	FShooterFrameStatScope ANONYMOUS_VARIABLE(ShooterFrameStat)(EShooterFrameStat::FrameStat)
+#else
+#define SHOOTER_SCOPE_CYCLE_COUNTER(Stat, FrameStat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
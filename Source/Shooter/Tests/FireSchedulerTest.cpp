@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterCharacter.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFireSchedulerRateTest, "Shooter.FireScheduler.Rate",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FFireSchedulerRateTest::RunTest(const FString& Parameters)
+{
+	// Holding the trigger for a minute, as the character's tick would at a fixed timestep
+	const float Duration{60.f};
+	const int32 MaxShotsPerTick{8};
+
+	// A typical automatic rate, and one faster than a frame at 30 fps
+	for (const float FireInterval : {0.1f, 0.0125f})
+	{
+		for (const float FrameRate : {30.f, 60.f, 144.f})
+		{
+			const float DeltaTime{1.f / FrameRate};
+			const int32 NumFrames{FMath::RoundToInt(Duration * FrameRate)};
+
+			// FireWeapon fires the first shot and starts the cooldown
+			int32 NumShots{1};
+			float CooldownRemaining{FireInterval};
+			float MaxShotAge{0.f};
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				float ShotAge{0.f};
+				NumShots += AShooterCharacter::AdvanceFireCooldown(CooldownRemaining, DeltaTime, FireInterval,
+					MaxShotsPerTick, ShotAge);
+				MaxShotAge = FMath::Max(MaxShotAge, ShotAge);
+			}
+
+			const float ShotsPerSecond{NumShots / Duration};
+			const float ExpectedShotsPerSecond{1.f / FireInterval};
+			const FString Case{FString::Printf(TEXT("%.4f s interval at %.0f fps"), FireInterval, FrameRate)};
+			TestEqual(*FString::Printf(TEXT("Shots per second, %s"), *Case), ShotsPerSecond, ExpectedShotsPerSecond,
+				ExpectedShotsPerSecond * 0.01f);
+			TestTrue(*FString::Printf(TEXT("Shots are due within the frame, %s"), *Case), MaxShotAge < DeltaTime);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFireSchedulerHitchTest, "Shooter.FireScheduler.Hitch",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FFireSchedulerHitchTest::RunTest(const FString& Parameters)
+{
+	const int32 MaxShotsPerTick{8};
+	const float FireInterval{0.1f};
+	const float DeltaTime{1.f / 60.f};
+
+	// Mid burst, then a two second hitch
+	float CooldownRemaining{0.05f};
+	float ShotAge{0.f};
+	const int32 HitchShots{AShooterCharacter::AdvanceFireCooldown(CooldownRemaining, 2.f, FireInterval,
+		MaxShotsPerTick, ShotAge)};
+	TestEqual(TEXT("Hitch fires at most a tick's worth of shots"), HitchShots, MaxShotsPerTick);
+	TestTrue(TEXT("No debt left after the hitch"), CooldownRemaining >= 0.f);
+
+	// The frames after the hitch go back to the normal rate instead of paying off the missed shots
+	int32 NumShots{0};
+	const int32 NumFrames{60};
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const int32 FrameShots{AShooterCharacter::AdvanceFireCooldown(CooldownRemaining, DeltaTime, FireInterval,
+			MaxShotsPerTick, ShotAge)};
+		TestTrue(TEXT("At most one shot a frame after the hitch"), FrameShots <= 1);
+		NumShots += FrameShots;
+	}
+	const int32 ExpectedShots{FMath::RoundToInt(NumFrames * DeltaTime / FireInterval)};
+	TestTrue(TEXT("Normal rate after the hitch"), FMath::Abs(NumShots - ExpectedShots) <= 1);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
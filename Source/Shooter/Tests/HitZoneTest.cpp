@@ -0,0 +1,176 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HitZone.h"
+
+#include "HitZoneSubsystem.h"
+#include "Engine/SkeletalMesh.h"
+#include "Misc/AutomationTest.h"
+#include "ReferenceSkeleton.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HitZoneTest
+{
+	static const TCHAR* HeadBone{TEXT("head")};
+
+	// A humanoid sized skeleton, the head a few bones down like on Grux
+	static USkeletalMesh* MakeTestMesh(TArray<FName>& OutBoneNames)
+	{
+		USkeletalMesh* Mesh = NewObject<USkeletalMesh>(GetTransientPackage());
+		{
+			FReferenceSkeletonModifier Modifier(Mesh->GetRefSkeleton(), nullptr);
+			const auto AddBone = [&Modifier, &OutBoneNames](const FString& Name, int32 ParentIndex)
+			{
+				const FName BoneName{*Name};
+				Modifier.Add(FMeshBoneInfo(BoneName, Name, ParentIndex), FTransform::Identity);
+				OutBoneNames.Add(BoneName);
+				return OutBoneNames.Num() - 1;
+			};
+
+			const int32 Root{AddBone(TEXT("root"), INDEX_NONE)};
+			const int32 Pelvis{AddBone(TEXT("pelvis"), Root)};
+			int32 Parent{Pelvis};
+			for (int32 i = 1; i <= 3; ++i)
+			{
+				Parent = AddBone(FString::Printf(TEXT("spine_%02d"), i), Parent);
+			}
+			const int32 Spine{Parent};
+			const int32 Neck{AddBone(TEXT("neck_01"), Spine)};
+			const int32 Head{AddBone(HeadBone, Neck)};
+			AddBone(TEXT("jaw"), Head);
+			for (const TCHAR* Side : {TEXT("l"), TEXT("r")})
+			{
+				int32 Arm{AddBone(FString::Printf(TEXT("clavicle_%s"), Side), Spine)};
+				Arm = AddBone(FString::Printf(TEXT("upperarm_%s"), Side), Arm);
+				Arm = AddBone(FString::Printf(TEXT("lowerarm_%s"), Side), Arm);
+				const int32 Hand{AddBone(FString::Printf(TEXT("hand_%s"), Side), Arm)};
+				for (int32 Finger = 0; Finger < 5; ++Finger)
+				{
+					AddBone(FString::Printf(TEXT("finger_%d_%s"), Finger, Side), Hand);
+				}
+				int32 Leg{AddBone(FString::Printf(TEXT("thigh_%s"), Side), Pelvis)};
+				Leg = AddBone(FString::Printf(TEXT("calf_%s"), Side), Leg);
+				AddBone(FString::Printf(TEXT("foot_%s"), Side), Leg);
+			}
+		}
+		return Mesh;
+	}
+
+	static TMap<EHitZone, FHitZoneSettings> MakeZoneSettings()
+	{
+		TMap<EHitZone, FHitZoneSettings> ZoneSettings;
+		FHitZoneSettings& Head = ZoneSettings.Add(EHitZone::EHZ_Head);
+		Head.Bones.Add(HeadBone);
+		Head.DamageMultiplier = 2.f;
+		FHitZoneSettings& Limb = ZoneSettings.Add(EHitZone::EHZ_Limb);
+		Limb.Bones = {TEXT("upperarm_l"), TEXT("upperarm_r"), TEXT("thigh_l"), TEXT("thigh_r")};
+		Limb.DamageMultiplier = 0.75f;
+		return ZoneSettings;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitZoneTableTest, "Shooter.HitZone.Table",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHitZoneTableTest::RunTest(const FString& Parameters)
+{
+	TArray<FName> BoneNames;
+	const USkeletalMesh* Mesh = HitZoneTest::MakeTestMesh(BoneNames);
+	const TSharedPtr<const FHitZoneTable> Table = FHitZoneTable::Build(Mesh, HitZoneTest::MakeZoneSettings());
+	if (!TestTrue(TEXT("Table built"), Table.IsValid())) return false;
+
+	const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+	TestTrue(TEXT("Head bone"), Table->GetZone(RefSkeleton.FindBoneIndex(TEXT("head"))) == EHitZone::EHZ_Head);
+	TestTrue(TEXT("Child of head"), Table->GetZone(RefSkeleton.FindBoneIndex(TEXT("jaw"))) == EHitZone::EHZ_Head);
+	TestTrue(TEXT("Finger"), Table->GetZone(RefSkeleton.FindBoneIndex(TEXT("finger_2_r"))) == EHitZone::EHZ_Limb);
+	TestTrue(TEXT("Spine"), Table->GetZone(RefSkeleton.FindBoneIndex(TEXT("spine_02"))) == EHitZone::EHZ_Torso);
+	TestTrue(TEXT("Unknown bone"), Table->GetZone(INDEX_NONE) == EHitZone::EHZ_Torso);
+	TestEqual(TEXT("Head multiplier"), Table->GetDamageMultiplier(EHitZone::EHZ_Head), 2.f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitZoneCacheTest, "Shooter.HitZone.Cache",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FHitZoneCacheTest::RunTest(const FString& Parameters)
+{
+	TArray<FName> BoneNames;
+	const USkeletalMesh* Mesh = HitZoneTest::MakeTestMesh(BoneNames);
+	UHitZoneSubsystem* HitZones = NewObject<UHitZoneSubsystem>(GetTransientPackage());
+
+	const TMap<EHitZone, FHitZoneSettings> ZoneSettings{HitZoneTest::MakeZoneSettings()};
+	const TSharedPtr<const FHitZoneTable> Table = HitZones->FindOrBuildTable(Mesh, ZoneSettings);
+	TestTrue(TEXT("Same settings share a table"), HitZones->FindOrBuildTable(Mesh, ZoneSettings) == Table);
+
+	// An enemy with its own head bone on the same mesh
+	TMap<EHitZone, FHitZoneSettings> OtherSettings{ZoneSettings};
+	OtherSettings[EHitZone::EHZ_Head].Bones = {TEXT("neck_01")};
+	const TSharedPtr<const FHitZoneTable> OtherTable = HitZones->FindOrBuildTable(Mesh, OtherSettings);
+	TestTrue(TEXT("Different settings get their own table"), OtherTable != Table);
+	TestTrue(TEXT("Own head bone"),
+		OtherTable->GetZone(Mesh->GetRefSkeleton().FindBoneIndex(TEXT("neck_01"))) == EHitZone::EHZ_Head);
+	TestEqual(TEXT("Tables cached"), HitZones->GetNumTables(), 2);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitZoneLookupBenchmark, "Shooter.HitZone.LookupBenchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FHitZoneLookupBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumHits{100000};
+
+	TArray<FName> BoneNames;
+	const USkeletalMesh* Mesh = HitZoneTest::MakeTestMesh(BoneNames);
+	const TSharedPtr<const FHitZoneTable> Table = FHitZoneTable::Build(Mesh, HitZoneTest::MakeZoneSettings());
+	if (!TestTrue(TEXT("Table built"), Table.IsValid())) return false;
+	const FReferenceSkeleton& RefSkeleton = Mesh->GetRefSkeleton();
+
+	// Same hits for both paths
+	FRandomStream Random{NumHits};
+	TArray<FName> Hits;
+	Hits.Reserve(NumHits);
+	for (int32 i = 0; i < NumHits; ++i)
+	{
+		Hits.Add(BoneNames[Random.RandHelper(BoneNames.Num())]);
+	}
+
+	// The old check: compare the bone name as a string against the head bone
+	const FString HeadBone{HitZoneTest::HeadBone};
+	int32 StringHeadShots{0};
+	const double StringStart{FPlatformTime::Seconds()};
+	for (const FName& BoneName : Hits)
+	{
+		if (BoneName.ToString() == HeadBone)
+		{
+			++StringHeadShots;
+		}
+	}
+	const double StringTime{FPlatformTime::Seconds() - StringStart};
+
+	// The table: bone index from the name, then the zone by index
+	int32 TableHeadShots{0};
+	const double TableStart{FPlatformTime::Seconds()};
+	for (const FName& BoneName : Hits)
+	{
+		if (Table->GetZone(RefSkeleton.FindBoneIndex(BoneName)) == EHitZone::EHZ_Head)
+		{
+			++TableHeadShots;
+		}
+	}
+	const double TableTime{FPlatformTime::Seconds() - TableStart};
+
+	// Only the head bone itself counts on the string path, the table also counts its children
+	int32 JawHits{0};
+	for (const FName& BoneName : Hits)
+	{
+		JawHits += BoneName == TEXT("jaw") ? 1 : 0;
+	}
+	TestEqual(TEXT("Both paths agree on the head"), TableHeadShots - JawHits, StringHeadShots);
+
+	AddInfo(FString::Printf(TEXT("%d hits: string compare %.3f ms, hit zone table %.3f ms (%.1fx)"), NumHits,
+		StringTime * 1000.0, TableTime * 1000.0, TableTime > 0.0 ? StringTime / TableTime : 0.0));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HitscanSubsystem.h"
+
+#include "ShooterTestWorld.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace HitscanTest
+{
+	static constexpr int32 NumFrames{120};
+	static constexpr float DeltaTime{1.f / 60.f};
+
+	// Shooters stand in a ring around a block, half their shots hit it and half go past
+	static void SpawnTarget(UWorld* World)
+	{
+		AActor* Target = World->SpawnActor<AActor>();
+		UBoxComponent* Box = NewObject<UBoxComponent>(Target);
+		Box->SetBoxExtent(FVector{200.f});
+		Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Target->SetRootComponent(Box);
+		Box->RegisterComponent();
+	}
+
+	struct FRunResult
+	{
+		int32 NumQueued{0};
+		int32 NumResolved{0};
+		int32 NumBeamHits{0};
+		double QueueSeconds{0.0};
+		double FrameSeconds{0.0};
+	};
+
+	static FRunResult Run(EHitscanMode Mode, int32 NumShooters, int32 NumShotsPerFrame)
+	{
+		IConsoleVariable* AsyncVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Shooter.Hitscan.Async"));
+		const int32 SavedMode{AsyncVar->GetInt()};
+		AsyncVar->Set(Mode == EHitscanMode::EHM_Asynchronous ? 1 : 0, ECVF_SetByCode);
+
+		FRunResult Result;
+		{
+			FShooterTestWorld TestWorld;
+			SpawnTarget(TestWorld.World);
+			UHitscanSubsystem* Hitscan = TestWorld.GetSubsystem<UHitscanSubsystem>();
+
+			const FOnShotResolved OnResolved = FOnShotResolved::CreateLambda(
+				[&Result](const FHitResult& BeamHitResult, bool bBeamEnd)
+				{
+					++Result.NumResolved;
+					Result.NumBeamHits += bBeamEnd ? 1 : 0;
+				});
+
+			for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+			{
+				const double FrameStart{FPlatformTime::Seconds()};
+				for (int32 Shooter = 0; Shooter < NumShooters; ++Shooter)
+				{
+					const float Angle{2.f * PI * Shooter / NumShooters};
+					const FVector Muzzle{FMath::Cos(Angle) * 2000.f, FMath::Sin(Angle) * 2000.f, 0.f};
+					for (int32 Shot = 0; Shot < NumShotsPerFrame; ++Shot)
+					{
+						// Every other shot aims to the side of the block
+						const FVector Aim{Shot % 2 == 0 ? FVector::ZeroVector : FVector{0.f, 0.f, 1000.f}};
+						Hitscan->QueueShot(Muzzle, Muzzle, Muzzle + (Aim - Muzzle) * 2.f, OnResolved);
+						++Result.NumQueued;
+					}
+				}
+				Result.QueueSeconds += FPlatformTime::Seconds() - FrameStart;
+				TestWorld.Tick(DeltaTime);
+				Result.FrameSeconds += FPlatformTime::Seconds() - FrameStart;
+			}
+
+			// Let the last shots come back, their frames aren't timed
+			for (int32 Frame = 0; Frame < 4 && Hitscan->GetNumPendingShots() > 0; ++Frame)
+			{
+				TestWorld.Tick(DeltaTime);
+			}
+		}
+
+		AsyncVar->Set(SavedMode, ECVF_SetByCode);
+		return Result;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHitscanModesTest, "Shooter.Hitscan.SyncVsAsync",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FHitscanModesTest::RunTest(const FString& Parameters)
+{
+	using namespace HitscanTest;
+	for (const int32 NumShooters : {1, 16, 64})
+	{
+		for (const int32 NumShots : {1, 8})
+		{
+			const FRunResult Sync{Run(EHitscanMode::EHM_Synchronous, NumShooters, NumShots)};
+			const FRunResult Async{Run(EHitscanMode::EHM_Asynchronous, NumShooters, NumShots)};
+
+			const FString Case{FString::Printf(TEXT("%d shots x %d shooters"), NumShots, NumShooters)};
+			TestEqual(*FString::Printf(TEXT("Every synchronous shot resolved, %s"), *Case), Sync.NumResolved,
+				Sync.NumQueued);
+			TestEqual(*FString::Printf(TEXT("Every asynchronous shot resolved, %s"), *Case), Async.NumResolved,
+				Async.NumQueued);
+			TestEqual(*FString::Printf(TEXT("Both modes hit the same, %s"), *Case), Async.NumBeamHits,
+				Sync.NumBeamHits);
+
+			AddInfo(FString::Printf(TEXT("%s per frame: synchronous %.3f ms queueing, %.3f ms frame; ")
+				TEXT("asynchronous %.3f ms queueing, %.3f ms frame"), *Case,
+				Sync.QueueSeconds * 1000.0 / NumFrames, Sync.FrameSeconds * 1000.0 / NumFrames,
+				Async.QueueSeconds * 1000.0 / NumFrames, Async.FrameSeconds * 1000.0 / NumFrames));
+		}
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,123 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemPoolSubsystem.h"
+
+#include "Item.h"
+#include "ShooterTestWorld.h"
+#include "EngineUtils.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/UObjectArray.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ItemPoolTest
+{
+	// Pickups out in the world, the ones the pool hasn't hidden
+	static TArray<AItem*> GetActiveItems(UWorld* World)
+	{
+		TArray<AItem*> Items;
+		for (TActorIterator<AItem> It(World); It; ++It)
+		{
+			if (!It->IsHidden())
+			{
+				Items.Add(*It);
+			}
+		}
+		return Items;
+	}
+
+	static int32 CountItems(UWorld* World)
+	{
+		int32 Count{0};
+		for (TActorIterator<AItem> It(World); It; ++It)
+		{
+			++Count;
+		}
+		return Count;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemPoolSoakTest, "Shooter.ItemPool.GCSoak",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FItemPoolSoakTest::RunTest(const FString& Parameters)
+{
+	FShooterTestWorld TestWorld;
+	UItemPoolSubsystem* ItemPool = TestWorld.GetSubsystem<UItemPoolSubsystem>();
+	if (!TestNotNull(TEXT("Item pool"), ItemPool)) return false;
+
+	const TSubclassOf<AItem> ItemClass{AItem::StaticClass()};
+	const int32 NumItems{32};
+	const int32 NumCycles{20};
+	const float RespawnTime{0.5f};
+	const float DeltaTime{1.f / 60.f};
+
+	ItemPool->PrewarmPool(ItemClass, NumItems);
+	TestEqual(TEXT("Prewarmed"), ItemPool->GetNumFreeItems(ItemClass), NumItems);
+
+	int32 BaselineObjects{0};
+	for (int32 Cycle = 0; Cycle < NumCycles; ++Cycle)
+	{
+		// Drop every item, as loot does, and pick each one up again
+		TArray<FTransform> DropTransforms;
+		for (int32 i = 0; i < NumItems; ++i)
+		{
+			DropTransforms.Add(FTransform{FVector(200.f * i, 100.f * Cycle, 0.f)});
+			AItem* Item = ItemPool->AcquireItem(ItemClass, DropTransforms.Last());
+			if (!TestNotNull(TEXT("Acquired an item"), Item)) return false;
+			Item->SetRespawnTime(RespawnTime);
+		}
+		TestEqual(TEXT("Acquiring reuses the pool"), ItemPool->GetNumFreeItems(ItemClass), 0);
+		for (AItem* Item : ItemPoolTest::GetActiveItems(TestWorld.World))
+		{
+			ItemPool->ReleaseItem(Item);
+		}
+		TestEqual(TEXT("Picked up items are back in the pool"), ItemPool->GetNumFreeItems(ItemClass), NumItems);
+
+		// Each one respawns where it was dropped, taken from the pool again
+		for (float Time = 0.f; Time < RespawnTime + 0.1f; Time += DeltaTime)
+		{
+			TestWorld.Tick(DeltaTime);
+		}
+		const TArray<AItem*> Respawned{ItemPoolTest::GetActiveItems(TestWorld.World)};
+		TestEqual(TEXT("Every item respawned"), Respawned.Num(), NumItems);
+		TestEqual(TEXT("Respawns come from the pool"), ItemPool->GetNumFreeItems(ItemClass), 0);
+		for (const AItem* Item : Respawned)
+		{
+			const bool bAtDropLocation{DropTransforms.ContainsByPredicate([Item](const FTransform& Transform)
+			{
+				return Transform.GetLocation().Equals(Item->GetActorLocation(), 1.f);
+			})};
+			TestTrue(TEXT("Respawned where it was dropped"), bAtDropLocation);
+		}
+
+		// Picked up for good this time
+		for (AItem* Item : Respawned)
+		{
+			Item->SetRespawnTime(0.f);
+			ItemPool->ReleaseItem(Item);
+		}
+		TestWorld.Tick(DeltaTime);
+
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		const int32 NumObjects{GUObjectArray.GetObjectArrayNumMinusAvailable()};
+		if (Cycle == 0)
+		{
+			// The first cycle creates the timers and anything else used once
+			BaselineObjects = NumObjects;
+		}
+		else if (NumObjects > BaselineObjects)
+		{
+			AddError(FString::Printf(TEXT("Cycle %d left %d more live objects than the first"), Cycle,
+				NumObjects - BaselineObjects));
+		}
+	}
+
+	TestEqual(TEXT("Nothing spawned besides the prewarmed items"), ItemPoolTest::CountItems(TestWorld.World), NumItems);
+	TestEqual(TEXT("Every item ends in the pool"), ItemPool->GetNumFreeItems(ItemClass), NumItems);
+	AddInfo(FString::Printf(TEXT("%d cycles of %d items, %d live objects after each"), NumCycles, NumItems,
+		BaselineObjects));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
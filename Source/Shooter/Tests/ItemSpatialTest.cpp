@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ItemSpatialSubsystem.h"
+
+#include "Item.h"
+#include "ShooterTestWorld.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ItemSpatialTest
+{
+	static constexpr float QueryRange{700.f};
+	static constexpr float QueryAngle{8.f};
+
+	static AActor* SpawnWall(UWorld* World, const FVector& Location, const FVector& Extent)
+	{
+		AActor* Wall = World->SpawnActor<AActor>();
+		UBoxComponent* Box = NewObject<UBoxComponent>(Wall);
+		Box->SetBoxExtent(Extent);
+		Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+		Wall->SetRootComponent(Box);
+		Box->RegisterComponent();
+		Wall->SetActorLocation(Location);
+		return Wall;
+	}
+
+	// Items in rows along +X, the way the benchmark lays out its pickup field
+	static void SpawnItemField(UWorld* World, int32 NumItems, int32 ItemsPerRow, float Spacing)
+	{
+		for (int32 i = 0; i < NumItems; ++i)
+		{
+			const FVector Location{(i / ItemsPerRow) * Spacing, (i % ItemsPerRow - ItemsPerRow / 2) * Spacing, 0.f};
+			World->SpawnActor<AItem>(AItem::StaticClass(), FTransform{Location});
+		}
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemLineOfSightTest, "Shooter.Items.LineOfSight",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FItemLineOfSightTest::RunTest(const FString& Parameters)
+{
+	using namespace ItemSpatialTest;
+	FShooterTestWorld TestWorld;
+	UItemSpatialSubsystem* ItemSpatial = TestWorld.GetSubsystem<UItemSpatialSubsystem>();
+	if (!TestNotNull(TEXT("Item spatial subsystem"), ItemSpatial)) return false;
+
+	const FVector Origin{0.f};
+	AItem* Item = TestWorld.World->SpawnActor<AItem>(AItem::StaticClass(), FTransform{FVector(500.f, 0.f, 0.f)});
+	TestEqual(TEXT("Item registered"), ItemSpatial->GetNumItems(), 1);
+
+	// The view query finds the item whether or not it's behind a wall, the trace tells them apart
+	TestEqual(TEXT("Query finds the item"), ItemSpatial->FindBestItemInView(Origin, FVector::ForwardVector, QueryRange,
+		QueryAngle), Item);
+	TestTrue(TEXT("Clear line of sight"), ItemSpatial->HasLineOfSight(Origin, Item));
+
+	AActor* Wall = SpawnWall(TestWorld.World, FVector(250.f, 0.f, 0.f), FVector(10.f, 200.f, 200.f));
+	TestEqual(TEXT("Query still finds the item behind the wall"), ItemSpatial->FindBestItemInView(Origin,
+		FVector::ForwardVector, QueryRange, QueryAngle), Item);
+	TestFalse(TEXT("Wall blocks the line of sight"), ItemSpatial->HasLineOfSight(Origin, Item));
+	TestTrue(TEXT("Ignored wall doesn't block"), ItemSpatial->HasLineOfSight(Origin, Item, Wall));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemQueryVsTraceTest, "Shooter.Items.QueryVsTrace",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FItemQueryVsTraceTest::RunTest(const FString& Parameters)
+{
+	using namespace ItemSpatialTest;
+	const int32 NumFrames{600};
+	const int32 ItemsPerRow{10};
+	const float Spacing{200.f};
+
+	for (const int32 NumItems : {1000, 10000})
+	{
+		FShooterTestWorld TestWorld;
+		SpawnItemField(TestWorld.World, NumItems, ItemsPerRow, Spacing);
+		UItemSpatialSubsystem* ItemSpatial = TestWorld.GetSubsystem<UItemSpatialSubsystem>();
+		if (!TestEqual(TEXT("Every item registered"), ItemSpatial->GetNumItems(), NumItems)) return false;
+
+		// The player walks down the field looking from side to side, as the character does every frame
+		const float FieldLength{(NumItems / ItemsPerRow) * Spacing};
+		double TraceSeconds{0.0};
+		double QuerySeconds{0.0};
+		int32 NumTraced{0};
+		int32 NumQueried{0};
+		int32 NumSightTraces{0};
+		const AItem* Candidate{nullptr};
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const float Alpha{static_cast<float>(Frame) / NumFrames};
+			const FVector Origin{Alpha * FieldLength, 0.f, 150.f};
+			const float Yaw{FMath::Sin(Alpha * 20.f * PI) * 60.f};
+			const FVector Direction{FRotator(-15.f, Yaw, 0.f).Vector()};
+
+			double Start{FPlatformTime::Seconds()};
+			FHitResult HitResult;
+			TestWorld.World->LineTraceSingleByChannel(HitResult, Origin, Origin + Direction * QueryRange,
+				ECollisionChannel::ECC_Visibility);
+			NumTraced += Cast<AItem>(HitResult.GetActor()) ? 1 : 0;
+			TraceSeconds += FPlatformTime::Seconds() - Start;
+
+			// The query, and one line of sight trace whenever it picks a different item
+			Start = FPlatformTime::Seconds();
+			const AItem* Item = ItemSpatial->FindBestItemInView(Origin, Direction, QueryRange, QueryAngle);
+			if (Item != Candidate)
+			{
+				Candidate = Item;
+				if (Item)
+				{
+					ItemSpatial->HasLineOfSight(Origin, Item);
+					++NumSightTraces;
+				}
+			}
+			NumQueried += Item ? 1 : 0;
+			QuerySeconds += FPlatformTime::Seconds() - Start;
+		}
+
+		TestTrue(TEXT("Query found items"), NumQueried > 0);
+		AddInfo(FString::Printf(TEXT("%d items: trace %.4f ms per frame (item on %d frames), query %.4f ms per frame ")
+			TEXT("(item on %d frames, %d line of sight traces)"), NumItems, TraceSeconds * 1000.0 / NumFrames, NumTraced,
+			QuerySeconds * 1000.0 / NumFrames, NumQueried, NumSightTraces));
+	}
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,215 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "LagCompensationSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterBenchmarkSubsystem.h"
+#include "ShooterCharacter.h"
+#include "ShooterEventLogSubsystem.h"
+#include "ShooterLoopbackTest.h"
+#include "Camera/PlayerCameraManager.h"
+#include "EngineUtils.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationEditorCommon.h"
+
+namespace LagCompensationTest
+{
+	// Time for the target to show up on the client before the first shot
+	static constexpr double WarmupTime{1.5};
+	static constexpr double FireTime{5.0};
+
+	// Time for the last shots to reach the server
+	static constexpr double SettleTime{1.0};
+
+	// The target strafes in front of the shooter
+	static constexpr float TargetDistance{800.f};
+	static constexpr float StrafeDistance{300.f};
+	static constexpr float StrafeSpeed{300.f};
+
+	// Share of the shots the client saw land that the server has to confirm
+	static constexpr float MinConfirmedShare{0.9f};
+
+	static int32 CountEvents(const UShooterEventLogSubsystem* EventLog, const TCHAR* Event)
+	{
+		const FString Match{FString::Printf(TEXT(" %s "), Event)};
+		return EventLog->GetEvents().FilterByPredicate([&Match](const FString& Line)
+		{
+			return Line.Contains(Match, ESearchCase::CaseSensitive);
+		}).Num();
+	}
+}
+
+// A client fires at a strafing enemy through the simulated latency, then compares the hits the server
+// confirmed with the ones it rejected
+class FLagCompensationLatencyCommand : public IAutomationLatentCommand
+{
+public:
+	FLagCompensationLatencyCommand(FAutomationTestBase* InTest, int32 InLatencyMs) :
+		Test(InTest),
+		LatencyMs(InLatencyMs)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		using namespace LagCompensationTest;
+		UWorld* ServerWorld = ShooterLoopback::GetServerWorld();
+		const TArray<UWorld*> ClientWorlds{ShooterLoopback::GetClientWorlds()};
+		AShooterCharacter* Shooter = ClientWorlds.Num() > 0 ? ShooterLoopback::GetLocalCharacter(ClientWorlds[0]) : nullptr;
+		AShooterCharacter* ServerShooter = ShooterLoopback::GetServerCharacter(ServerWorld, Shooter);
+		if (!Shooter || !ServerShooter)
+		{
+			Test->AddError(TEXT("No client character to shoot with"));
+			return true;
+		}
+
+		if (!Target)
+		{
+			Start(ServerWorld, ServerShooter);
+			return !Target;
+		}
+
+		// Strafe on the server, the client sees it late by the latency and its own interpolation
+		const double Elapsed{FPlatformTime::Seconds() - StartSeconds};
+		const float Offset{StrafeDistance * FMath::Sin(static_cast<float>(Elapsed) * StrafeSpeed / StrafeDistance)};
+		Target->SetActorLocation(TargetCenter + TargetRight * Offset);
+
+		FShooterLoopbackDriver::RefillAmmo(Shooter);
+		FShooterLoopbackDriver::RefillAmmo(ServerShooter);
+		if (Elapsed < WarmupTime + FireTime)
+		{
+			// Aim where the client sees the target, as a player would
+			const AActor* ClientTarget = FindClientTarget(ClientWorlds[0]);
+			APlayerController* PlayerController = Cast<APlayerController>(Shooter->GetController());
+			if (ClientTarget && PlayerController && PlayerController->PlayerCameraManager)
+			{
+				const FVector CameraLocation{PlayerController->PlayerCameraManager->GetCameraLocation()};
+				PlayerController->SetControlRotation((ClientTarget->GetActorLocation() - CameraLocation).Rotation());
+			}
+			FShooterLoopbackDriver::SetFiring(Shooter, Elapsed >= WarmupTime && ClientTarget);
+			return false;
+		}
+
+		FShooterLoopbackDriver::SetFiring(Shooter, false);
+		if (Elapsed < WarmupTime + FireTime + SettleTime) return false;
+
+		Finish();
+		return true;
+	}
+
+private:
+	void Start(UWorld* ServerWorld, AShooterCharacter* ServerShooter)
+	{
+		using namespace LagCompensationTest;
+		ShooterLoopback::SetPacketSimulation(LatencyMs, 0);
+
+		EventLog = ServerWorld->GetSubsystem<UShooterEventLogSubsystem>();
+		if (!EventLog)
+		{
+			Test->AddError(TEXT("No event log on the server"));
+			return;
+		}
+		EventLog->ResetEvents();
+		EventLog->SetRecording(true);
+
+		// Only the shooter's hits matter, nothing should hurt it meanwhile
+		ServerShooter->SetCanBeDamaged(false);
+		const FRotator Facing{0.f, ServerShooter->GetControlRotation().Yaw, 0.f};
+		TargetCenter = ServerShooter->GetActorLocation() + Facing.Vector() * TargetDistance;
+		TargetRight = FRotationMatrix(Facing).GetScaledAxis(EAxis::Y);
+
+		const TSoftClassPtr<AEnemy>& EnemyClass{GetDefault<UShooterBenchmarkSubsystem>()->GetEnemyClass()};
+		UClass* Class = EnemyClass.IsNull() ? AEnemy::StaticClass() : EnemyClass.LoadSynchronous();
+		const FTransform SpawnTransform{Facing + FRotator(0.f, 180.f, 0.f), TargetCenter};
+		Target = ServerWorld->SpawnActorDeferred<AEnemy>(Class, SpawnTransform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (!Target)
+		{
+			Test->AddError(TEXT("Couldn't spawn the target"));
+			return;
+		}
+		Target->SetMaxHealth(BIG_NUMBER);
+		Target->FinishSpawning(SpawnTransform);
+
+		// Only moved by the test, the server records it in the lag compensation history like any enemy
+		Target->GetCharacterMovement()->DisableMovement();
+		Test->TestTrue(TEXT("Target tracked by lag compensation"),
+			ServerWorld->GetSubsystem<ULagCompensationSubsystem>()->IsTracked(Target));
+		StartSeconds = FPlatformTime::Seconds();
+	}
+
+	// The client's copy of the target, the enemy closest to where the server has it
+	const AActor* FindClientTarget(UWorld* ClientWorld) const
+	{
+		const AActor* ClientTarget{nullptr};
+		float BestDistanceSquared{FMath::Square(LagCompensationTest::StrafeDistance * 2.f)};
+		for (TActorIterator<AEnemy> It(ClientWorld); It; ++It)
+		{
+			const float DistanceSquared{FVector::DistSquared(It->GetActorLocation(), Target->GetActorLocation())};
+			if (DistanceSquared < BestDistanceSquared)
+			{
+				BestDistanceSquared = DistanceSquared;
+				ClientTarget = *It;
+			}
+		}
+		return ClientTarget;
+	}
+
+	void Finish()
+	{
+		using namespace LagCompensationTest;
+		ShooterLoopback::SetPacketSimulation(0, 0);
+
+		const int32 NumConfirmed{CountEvents(EventLog, TEXT("HitConfirmed"))};
+		const int32 NumRejected{CountEvents(EventLog, TEXT("HitRejected"))};
+		const int32 NumHits{NumConfirmed + NumRejected};
+		EventLog->SetRecording(false);
+		Target->Destroy();
+
+		Test->TestTrue(FString::Printf(TEXT("Hits reached the server at %d ms"), LatencyMs), NumHits > 0);
+		if (NumHits == 0) return;
+
+		const float ConfirmedShare{static_cast<float>(NumConfirmed) / NumHits};
+		Test->TestTrue(FString::Printf(TEXT("%.0f%% of hits confirmed at %d ms"), ConfirmedShare * 100.f, LatencyMs),
+			ConfirmedShare >= MinConfirmedShare);
+		Test->AddInfo(FString::Printf(TEXT("%d ms: %d of %d hits confirmed"), LatencyMs, NumConfirmed, NumHits));
+	}
+
+	FAutomationTestBase* Test;
+	int32 LatencyMs;
+
+	TWeakObjectPtr<AEnemy> Target;
+	TWeakObjectPtr<UShooterEventLogSubsystem> EventLog;
+	FVector TargetCenter{FVector::ZeroVector};
+	FVector TargetRight{FVector::RightVector};
+	double StartSeconds{0.0};
+};
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FLagCompensationLatencyTest, "Shooter.Net.LagCompensation",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+void FLagCompensationLatencyTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const int32 LatencyMs : {50, 100, 200})
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%dms"), LatencyMs));
+		OutTestCommands.Add(FString::FromInt(LatencyMs));
+	}
+}
+
+bool FLagCompensationLatencyTest::RunTest(const FString& Parameters)
+{
+	// A listen server and one client in this process, the client's shots cross the simulated latency
+	ADD_LATENT_AUTOMATION_COMMAND(FEditorLoadMap(GetDefault<UShooterBenchmarkSubsystem>()->GetAutomationMap()));
+	ADD_LATENT_AUTOMATION_COMMAND(FStartLoopbackSessionCommand(this, 1));
+	ADD_LATENT_AUTOMATION_COMMAND(FLagCompensationLatencyCommand(this, FCString::Atoi(*Parameters)));
+	ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ParticlePoolSubsystem.h"
+
+#include "ShooterTestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ParticlePoolTest
+{
+	// What the component does when its last emitter is done
+	static void FinishEffect(UParticleSystemComponent* Component)
+	{
+		Component->OnSystemFinished.Broadcast(Component);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FParticlePoolTest, "Shooter.ParticlePool.Recycle",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FParticlePoolTest::RunTest(const FString& Parameters)
+{
+	// Calls the pool directly, SpawnEmitter skips cosmetics in headless runs
+	FShooterTestWorld TestWorld;
+	UParticlePoolSubsystem* ParticlePool = TestWorld.GetSubsystem<UParticlePoolSubsystem>();
+	if (!TestNotNull(TEXT("Particle pool"), ParticlePool)) return false;
+
+	UParticleSystem* Template = NewObject<UParticleSystem>(GetTransientPackage());
+	const int32 Budget{4};
+	ParticlePool->SetEffectBudget(Template, Budget);
+
+	// Prewarming creates free components up to the budget, and only once
+	ParticlePool->PrewarmPool(Template, Budget + 2);
+	TestEqual(TEXT("Prewarmed up to the budget"), ParticlePool->GetNumFreeComponents(Template), Budget);
+	ParticlePool->PrewarmPool(Template, Budget);
+	TestEqual(TEXT("Prewarming again creates nothing"), ParticlePool->GetNumFreeComponents(Template), Budget);
+
+	// Spawning hands out the prewarmed components
+	TArray<UParticleSystemComponent*> Spawned;
+	for (int32 i = 0; i < Budget; ++i)
+	{
+		Spawned.Add(ParticlePool->SpawnEmitterAtLocation(Template, FTransform{FVector(100.f * i, 0.f, 0.f)}));
+		TestNotNull(TEXT("Spawned a component"), Spawned.Last());
+	}
+	TestEqual(TEXT("No free components left"), ParticlePool->GetNumFreeComponents(Template), 0);
+	TestEqual(TEXT("All components playing"), ParticlePool->GetNumActiveComponents(Template), Budget);
+	TestEqual(TEXT("Components are distinct"), TSet<UParticleSystemComponent*>(Spawned).Num(), Budget);
+
+	// A finished effect goes back to the pool and is the next one used
+	UParticleSystemComponent* Finished = Spawned[1];
+	ParticlePoolTest::FinishEffect(Finished);
+	TestEqual(TEXT("Finished component freed"), ParticlePool->GetNumFreeComponents(Template), 1);
+	TestEqual(TEXT("Finished component no longer playing"), ParticlePool->GetNumActiveComponents(Template), Budget - 1);
+	const FVector ReuseLocation{0.f, 500.f, 0.f};
+	UParticleSystemComponent* Reused = ParticlePool->SpawnEmitterAtLocation(Template, FTransform{ReuseLocation});
+	TestEqual(TEXT("Finished component reused"), Reused, Finished);
+	TestEqual(TEXT("Reused component moved"), Reused->GetComponentLocation(), ReuseLocation);
+
+	// Finishing twice doesn't free a component twice
+	ParticlePoolTest::FinishEffect(Spawned[2]);
+	ParticlePoolTest::FinishEffect(Spawned[2]);
+	TestEqual(TEXT("Double finish frees once"), ParticlePool->GetNumFreeComponents(Template), 1);
+	ParticlePool->SpawnEmitterAtLocation(Template, FTransform::Identity);
+
+	// Over budget with nothing free, the oldest playing component is stolen instead of creating one
+	UParticleSystemComponent* Oldest = Spawned[0];
+	UParticleSystemComponent* Stolen = ParticlePool->SpawnEmitterAtLocation(Template, FTransform::Identity);
+	TestEqual(TEXT("Oldest component stolen"), Stolen, Oldest);
+	TestEqual(TEXT("Still at the budget"), ParticlePool->GetNumActiveComponents(Template), Budget);
+	TestEqual(TEXT("Nothing created"), ParticlePool->GetNumFreeComponents(Template), 0);
+
+	// The stolen component is now the newest, the next steal takes the one after it
+	UParticleSystemComponent* NextStolen = ParticlePool->SpawnEmitterAtLocation(Template, FTransform::Identity);
+	TestEqual(TEXT("Next oldest stolen"), NextStolen, Spawned[3]);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
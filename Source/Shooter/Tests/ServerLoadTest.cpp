@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ServerLoadSubsystem.h"
+
+#include "ShooterBenchmarkSubsystem.h"
+#include "ShooterLoopbackTest.h"
+#include "ShooterPlayerController.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationEditorCommon.h"
+
+namespace ServerLoadTest
+{
+	// Time for every bot to get going before the server is timed
+	static constexpr double WarmupTime{2.0};
+	static constexpr double LoadTime{10.0};
+
+	static void SetBots(bool bBots)
+	{
+		for (UWorld* ClientWorld : ShooterLoopback::GetClientWorlds())
+		{
+			if (AShooterPlayerController* PlayerController = Cast<AShooterPlayerController>(ClientWorld->GetFirstPlayerController()))
+			{
+				PlayerController->SetBot(bBots);
+			}
+		}
+	}
+}
+
+// Every client runs and shoots as a bot while the server times its frames
+class FServerLoadBotsCommand : public IAutomationLatentCommand
+{
+public:
+	FServerLoadBotsCommand(FAutomationTestBase* InTest, int32 InNumClients) :
+		Test(InTest),
+		NumClients(InNumClients)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		using namespace ServerLoadTest;
+		UWorld* ServerWorld = ShooterLoopback::GetServerWorld();
+		UServerLoadSubsystem* ServerLoad = ServerWorld ? ServerWorld->GetSubsystem<UServerLoadSubsystem>() : nullptr;
+		if (!ServerLoad)
+		{
+			Test->AddError(TEXT("No server load subsystem on the server"));
+			return true;
+		}
+
+		if (StartSeconds == 0.0)
+		{
+			SetBots(true);
+			StartSeconds = FPlatformTime::Seconds();
+			return false;
+		}
+
+		const double Elapsed{FPlatformTime::Seconds() - StartSeconds};
+		if (Elapsed < WarmupTime) return false;
+
+		// Long enough that nothing reports before the test does
+		if (!bTiming)
+		{
+			ServerLoad->SetReportInterval(LoadTime * 2.0);
+			bTiming = true;
+		}
+		if (Elapsed < WarmupTime + LoadTime) return false;
+
+		ServerLoad->Report();
+		ServerLoad->SetReportInterval(0.f);
+		SetBots(false);
+
+		const FServerLoadReport& Report{ServerLoad->GetLastReport()};
+		if (!Test->TestTrue(TEXT("Server frames timed"), Report.NumFrames > 0)) return true;
+
+		// The listen server's own player counts too
+		Test->TestTrue(TEXT("Every client stayed connected"), Report.AveragePlayers > NumClients + 0.5);
+		Test->AddInfo(FString::Printf(TEXT("%d bots: %d frames, %.2f ms average, %.2f ms max, %.3f ms per player"),
+			NumClients, Report.NumFrames, Report.AverageFrameMs, Report.MaxFrameMs, Report.GetFrameMsPerPlayer()));
+		return true;
+	}
+
+private:
+	FAutomationTestBase* Test;
+	int32 NumClients;
+
+	double StartSeconds{0.0};
+	bool bTiming{false};
+};
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FServerLoadBotsTest, "Shooter.Net.BotLoad",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+void FServerLoadBotsTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const int32 NumClients : {1, 2, 4})
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%dBots"), NumClients));
+		OutTestCommands.Add(FString::FromInt(NumClients));
+	}
+}
+
+bool FServerLoadBotsTest::RunTest(const FString& Parameters)
+{
+	// A listen server and its bots in this process, talking through the real net drivers
+	const int32 NumClients{FCString::Atoi(*Parameters)};
+	ADD_LATENT_AUTOMATION_COMMAND(FEditorLoadMap(GetDefault<UShooterBenchmarkSubsystem>()->GetAutomationMap()));
+	ADD_LATENT_AUTOMATION_COMMAND(FStartLoopbackSessionCommand(this, NumClients));
+	ADD_LATENT_AUTOMATION_COMMAND(FServerLoadBotsCommand(this, NumClients));
+	ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
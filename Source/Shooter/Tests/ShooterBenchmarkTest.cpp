@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterBenchmarkSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterBenchmarkTest
+{
+	// Longest a scenario may take in real time, the fixed timestep can run slower than the game would
+	static constexpr double MaxRunTime{1800.0};
+
+	static UWorld* GetGameWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if ((Context.WorldType == EWorldType::PIE || Context.WorldType == EWorldType::Game) && Context.World())
+			{
+				return Context.World();
+			}
+		}
+		return nullptr;
+	}
+}
+
+// Queues one scenario in the loaded map and waits for its result
+class FRunShooterBenchmarkCommand : public IAutomationLatentCommand
+{
+public:
+	FRunShooterBenchmarkCommand(FAutomationTestBase* InTest, const FString& InScenario) :
+		Test(InTest),
+		Scenario(InScenario)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		UWorld* World = ShooterBenchmarkTest::GetGameWorld();
+		UShooterBenchmarkSubsystem* Benchmark = World ? World->GetSubsystem<UShooterBenchmarkSubsystem>() : nullptr;
+		if (!Benchmark)
+		{
+			Test->AddError(TEXT("No game world to run the benchmark in"));
+			return true;
+		}
+
+		if (!bQueued)
+		{
+			bQueued = true;
+			NumResults = Benchmark->GetResults().Num();
+			if (!Benchmark->QueueBenchmarks({Scenario}))
+			{
+				Test->AddError(FString::Printf(TEXT("Unknown scenario %s"), *Scenario));
+				return true;
+			}
+			return false;
+		}
+
+		if (Benchmark->IsRunning())
+		{
+			if (GetCurrentRunTime() < ShooterBenchmarkTest::MaxRunTime) return false;
+
+			Test->AddError(FString::Printf(TEXT("%s didn't finish in %.0f seconds"), *Scenario,
+				ShooterBenchmarkTest::MaxRunTime));
+			return true;
+		}
+
+		const TArray<FShooterBenchmarkResult>& Results = Benchmark->GetResults();
+		if (!Test->TestEqual(TEXT("Scenario finished"), Results.Num(), NumResults + 1)) return true;
+
+		const FShooterBenchmarkResult& Result = Results.Last();
+		Test->TestTrue(TEXT("Frames recorded"), Result.NumFrames > 0);
+		Test->AddInfo(FString::Printf(TEXT("%s: %d frames, average game thread %.3f ms, physics %.3f ms, GC %.3f ms, memory %+.1f MB"),
+			*Result.Scenario, Result.NumFrames, Result.GameThreadMs, Result.PhysicsMs, Result.GCMs, Result.MemoryMB));
+		if (!Result.Details.IsEmpty())
+		{
+			Test->AddInfo(FString::Printf(TEXT("%s: %s"), *Result.Scenario, *Result.Details));
+		}
+		return true;
+	}
+
+private:
+	FAutomationTestBase* Test;
+	FString Scenario;
+	bool bQueued{false};
+	int32 NumResults{0};
+};
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FShooterBenchmarkTest, "Shooter.Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FShooterBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	TArray<FString> ScenarioNames;
+	UShooterBenchmarkSubsystem::GetScenarioNames(ScenarioNames);
+	OutBeautifiedNames.Append(ScenarioNames);
+	OutTestCommands.Append(ScenarioNames);
+}
+
+bool FShooterBenchmarkTest::RunTest(const FString& Parameters)
+{
+	// Same seed and timestep as the console command, timings go to the CSV and the test log
+	if (!AutomationOpenMap(GetDefault<UShooterBenchmarkSubsystem>()->GetAutomationMap()))
+	{
+		AddError(TEXT("Couldn't open the benchmark map"));
+		return false;
+	}
+	ADD_LATENT_AUTOMATION_COMMAND(FRunShooterBenchmarkCommand(this, Parameters));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
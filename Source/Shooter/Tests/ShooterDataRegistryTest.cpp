@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterDataRegistry.h"
+
+#include "Item.h"
+#include "ShooterTestWorld.h"
+#include "Weapon.h"
+#include "Engine/DataTable.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterDataRegistryTest
+{
+	static constexpr int32 NumWeapons{1000};
+
+	// What item and weapon construction did before the registry, for every spawn
+	static bool LookUpUncached(EWeaponType WeaponType, EItemRarity Rarity)
+	{
+		static const TCHAR* WeaponRowNames[] = {TEXT("SubmachineGun"), TEXT("AssaultRifle"), TEXT("Pistol")};
+		static const TCHAR* RarityRowNames[] = {TEXT("Damaged"), TEXT("Common"), TEXT("Uncommon"), TEXT("Rare"),
+			TEXT("Legendary")};
+
+		const UDataTable* RarityTable = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr,
+			TEXT("DataTable'/Game/_Game/DataTables/ItemRarityDataTable.ItemRarityDataTable'")));
+		const UDataTable* WeaponTable = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr,
+			TEXT("DataTable'/Game/_Game/DataTables/WeaponDataTable.WeaponDataTable'")));
+		if (!RarityTable || !WeaponTable) return false;
+
+		const FItemRarityTable* RarityRow = RarityTable->FindRow<FItemRarityTable>(
+			RarityRowNames[static_cast<int32>(Rarity)], TEXT(""));
+		const FWeaponDataTable* WeaponRow = WeaponTable->FindRow<FWeaponDataTable>(
+			WeaponRowNames[static_cast<int32>(WeaponType)], TEXT(""));
+		return RarityRow && WeaponRow;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterDataRegistryWeaponSpawnTest, "Shooter.DataRegistry.WeaponSpawn",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FShooterDataRegistryWeaponSpawnTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterDataRegistryTest;
+	UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
+	if (!TestNotNull(TEXT("Data registry"), DataRegistry)) return false;
+
+	const int32 NumWeaponTypes{static_cast<int32>(EWeaponType::EWT_MAX)};
+	const int32 NumRarities{static_cast<int32>(EItemRarity::EIR_MAX)};
+	for (int32 i = 0; i < NumWeaponTypes; ++i)
+	{
+		TestNotNull(*FString::Printf(TEXT("Weapon row %d"), i), DataRegistry->GetWeaponRow(static_cast<EWeaponType>(i)));
+	}
+	for (int32 i = 0; i < NumRarities; ++i)
+	{
+		TestNotNull(*FString::Printf(TEXT("Rarity row %d"), i), DataRegistry->GetRarityRow(static_cast<EItemRarity>(i)));
+	}
+
+	// The lookups one weapon construction makes, the old way and through the registry
+	double Start{FPlatformTime::Seconds()};
+	for (int32 i = 0; i < NumWeapons; ++i)
+	{
+		if (!LookUpUncached(static_cast<EWeaponType>(i % NumWeaponTypes), static_cast<EItemRarity>(i % NumRarities)))
+		{
+			AddError(TEXT("Couldn't load the data tables"));
+			return false;
+		}
+	}
+	const double UncachedSeconds{FPlatformTime::Seconds() - Start};
+
+	Start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumWeapons; ++i)
+	{
+		DataRegistry->GetRarityRow(static_cast<EItemRarity>(i % NumRarities));
+		DataRegistry->GetWeaponRow(static_cast<EWeaponType>(i % NumWeaponTypes));
+	}
+	const double RegistrySeconds{FPlatformTime::Seconds() - Start};
+
+	// Whole spawns, construction included, which now goes through the registry
+	FShooterTestWorld TestWorld;
+	Start = FPlatformTime::Seconds();
+	int32 NumSpawned{0};
+	for (int32 i = 0; i < NumWeapons; ++i)
+	{
+		const FTransform SpawnTransform{FVector(200.f * (i % 32), 200.f * (i / 32), 0.f)};
+		AWeapon* Weapon = TestWorld.World->SpawnActorDeferred<AWeapon>(AWeapon::StaticClass(), SpawnTransform);
+		if (!Weapon) continue;
+
+		Weapon->SetWeaponType(static_cast<EWeaponType>(i % NumWeaponTypes));
+		Weapon->FinishSpawning(SpawnTransform);
+		++NumSpawned;
+	}
+	const double SpawnSeconds{FPlatformTime::Seconds() - Start};
+	TestEqual(TEXT("Every weapon spawned"), NumSpawned, NumWeapons);
+
+	AddInfo(FString::Printf(TEXT("%d weapons: uncached table loads and lookups %.3f ms, registry lookups %.3f ms, ")
+		TEXT("spawning with the registry %.3f ms (%.2f us per weapon)"), NumWeapons, UncachedSeconds * 1000.0,
+		RegistrySeconds * 1000.0, SpawnSeconds * 1000.0, SpawnSeconds * 1000000.0 / NumWeapons));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
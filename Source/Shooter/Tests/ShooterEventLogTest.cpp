@@ -0,0 +1,103 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterEventLogSubsystem.h"
+
+#include "Enemy.h"
+#include "ShooterRandomSubsystem.h"
+#include "ShooterTestWorld.h"
+#include "GameFramework/DamageType.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterEventLogTest
+{
+	static constexpr int32 NumEnemies{8};
+	static constexpr int32 NumFrames{600};
+	static constexpr float FixedDeltaTime{1.f / 60.f};
+
+	// Enemies are shot one after another and pick attacks at a fixed timestep, every roll from the seed
+	static TArray<FString> RunScenario(int32 Seed)
+	{
+		FShooterTestWorld TestWorld;
+		UShooterRandomSubsystem* Random = TestWorld.GetSubsystem<UShooterRandomSubsystem>();
+		UShooterEventLogSubsystem* EventLog = TestWorld.GetSubsystem<UShooterEventLogSubsystem>();
+		if (!Random || !EventLog) return {};
+
+		Random->SetSeed(Seed);
+		EventLog->SetRecording(true);
+		FRandomStream Placement{Seed};
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		TArray<AEnemy*> Enemies;
+		for (int32 i = 0; i < NumEnemies; ++i)
+		{
+			const FVector Location{Placement.FRandRange(-2000.f, 2000.f), Placement.FRandRange(-2000.f, 2000.f), 100.f};
+			AEnemy* Enemy = TestWorld.World->SpawnActor<AEnemy>(AEnemy::StaticClass(), Location, FRotator::ZeroRotator,
+				SpawnParams);
+			if (Enemy)
+			{
+				Enemies.Add(Enemy);
+			}
+		}
+
+		for (int32 Frame = 0; Frame < NumFrames && Enemies.Num() > 0; ++Frame)
+		{
+			AEnemy* Enemy = Enemies[Frame % Enemies.Num()];
+			if (!Enemy->IsDying())
+			{
+				UGameplayStatics::ApplyDamage(Enemy, Placement.FRandRange(1.f, 10.f), nullptr, nullptr,
+					UDamageType::StaticClass());
+				Enemy->GetAttackSectionName();
+			}
+			TestWorld.Tick(FixedDeltaTime);
+		}
+		return EventLog->GetEvents();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterEventLogDeterminismTest, "Shooter.EventLog.Determinism",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FShooterEventLogDeterminismTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterEventLogTest;
+	const int32 Seed{1234};
+
+	const TArray<FString> FirstRun{RunScenario(Seed)};
+	const TArray<FString> SecondRun{RunScenario(Seed)};
+	if (!TestTrue(TEXT("Events recorded"), FirstRun.Num() > 0)) return false;
+
+	// Same seed, same timestep, same events in the same order
+	const int32 Difference{UShooterEventLogSubsystem::FindFirstDifference(FirstRun, SecondRun)};
+	if (Difference != INDEX_NONE)
+	{
+		AddError(FString::Printf(TEXT("Runs split at event %d: \"%s\" vs \"%s\""), Difference,
+			FirstRun.IsValidIndex(Difference) ? *FirstRun[Difference] : TEXT("<end>"),
+			SecondRun.IsValidIndex(Difference) ? *SecondRun[Difference] : TEXT("<end>")));
+	}
+
+	// Every kind of roll shows up, so the comparison covers them
+	const auto CountEvents = [&FirstRun](const TCHAR* Event)
+	{
+		return FirstRun.FilterByPredicate([Event](const FString& Line)
+		{
+			return Line.Contains(FString::Printf(TEXT(" %s"), Event), ESearchCase::CaseSensitive);
+		}).Num();
+	};
+	TestEqual(TEXT("Every enemy spawned"), CountEvents(TEXT("Spawn")), NumEnemies);
+	TestTrue(TEXT("Damage recorded"), CountEvents(TEXT("Damage")) > 0);
+	TestTrue(TEXT("Stuns recorded"), CountEvents(TEXT("Stunned")) > 0);
+	TestTrue(TEXT("Attack sections recorded"), CountEvents(TEXT("AttackSection")) > 0);
+
+	// Another seed plays out differently
+	TestTrue(TEXT("Another seed records other events"),
+		UShooterEventLogSubsystem::FindFirstDifference(FirstRun, RunScenario(Seed + 1)) != INDEX_NONE);
+
+	AddInfo(FString::Printf(TEXT("%d events matched between runs"), FirstRun.Num()));
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,223 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ShooterCharacter.h"
+#include "Weapon.h"
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Editor.h"
+#include "Settings/LevelEditorPlaySettings.h"
+
+// Presses the character's buttons for the loopback tests, the way input would
+struct FShooterLoopbackDriver
+{
+	static void SetFiring(AShooterCharacter* Character, bool bFiring)
+	{
+		if (bFiring == Character->bFireButtonPressed) return;
+
+		if (bFiring)
+		{
+			Character->FireButtonPressed();
+		}
+		else
+		{
+			Character->FireButtonReleased();
+		}
+	}
+
+	static void PressReload(AShooterCharacter* Character)
+	{
+		Character->ReloadButtonPressed();
+	}
+
+	static void SwapToSlot(AShooterCharacter* Character, int32 SlotIndex)
+	{
+		if (Character->GetEquippedWeapon())
+		{
+			Character->ExchangeInventoryItems(Character->GetEquippedWeapon()->GetSlotIndex(), SlotIndex);
+		}
+	}
+
+	// The client's predicted weapon and inventory state, or the server's own on the server
+	static FShooterPredictedState GetPredictedState(const AShooterCharacter* Character)
+	{
+		return Character->CapturePredictedState();
+	}
+
+	// Actions the client predicted that the server hasn't acked yet
+	static int32 GetNumUnackedActions(const AShooterCharacter* Character)
+	{
+		return Character->PredictedActions.Num();
+	}
+
+	// Keeps the magazine full, so the tests measure firing rather than reloading
+	static void RefillAmmo(AShooterCharacter* Character)
+	{
+		AWeapon* Weapon = Character->GetEquippedWeapon();
+		if (!Weapon) return;
+
+		const int32 MissingAmmo{Weapon->GetMagazineCapacity() - Weapon->GetAmmo()};
+		if (MissingAmmo > 0)
+		{
+			Weapon->ReloadAmmo(MissingAmmo);
+		}
+	}
+};
+
+/**
+ * A listen server and its clients, all running in this process as a play in editor session, so the
+ * network tests can read the server's and every client's state directly. Packets between them go through
+ * the real net drivers, with simulated lag and loss on top.
+ */
+namespace ShooterLoopback
+{
+	// Longest a session may take until every player has a character with a weapon
+	static constexpr double StartTimeout{60.0};
+
+	// Plays the map open in the editor as a listen server with NumClients clients
+	static void StartSession(int32 NumClients)
+	{
+		ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+		PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_ListenServer);
+		PlaySettings->SetPlayNumberOfClients(NumClients + 1);
+		PlaySettings->SetRunUnderOneProcess(true);
+		PlaySettings->bLaunchSeparateServer = false;
+
+		FRequestPlaySessionParams Params;
+		Params.WorldType = EPlaySessionWorldType::PlayInEditor;
+		Params.SessionDestination = EPlaySessionDestinationType::InProcess;
+		Params.EditorPlaySettings = PlaySettings;
+		GEditor->RequestPlaySession(Params);
+	}
+
+	static UWorld* GetServerWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (Context.WorldType == EWorldType::PIE && World && World->GetNetMode() == NM_ListenServer)
+			{
+				return World;
+			}
+		}
+		return nullptr;
+	}
+
+	static TArray<UWorld*> GetClientWorlds()
+	{
+		TArray<UWorld*> Worlds;
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			if (Context.WorldType == EWorldType::PIE && World && World->GetNetMode() == NM_Client)
+			{
+				Worlds.Add(World);
+			}
+		}
+		return Worlds;
+	}
+
+	// The character the world's own player controls
+	static AShooterCharacter* GetLocalCharacter(UWorld* World)
+	{
+		const APlayerController* PlayerController = World ? World->GetFirstPlayerController() : nullptr;
+		return PlayerController ? Cast<AShooterCharacter>(PlayerController->GetPawn()) : nullptr;
+	}
+
+	// The server's copy of a client's character, found by the player ID their player states share
+	static AShooterCharacter* GetServerCharacter(UWorld* ServerWorld, const AShooterCharacter* ClientCharacter)
+	{
+		const APlayerState* ClientPlayerState = ClientCharacter ? ClientCharacter->GetPlayerState() : nullptr;
+		if (!ServerWorld || !ClientPlayerState) return nullptr;
+
+		for (FConstPlayerControllerIterator It = ServerWorld->GetPlayerControllerIterator(); It; ++It)
+		{
+			const APlayerController* PlayerController = It->Get();
+			if (PlayerController && PlayerController->PlayerState &&
+				PlayerController->PlayerState->GetPlayerId() == ClientPlayerState->GetPlayerId())
+			{
+				return Cast<AShooterCharacter>(PlayerController->GetPawn());
+			}
+		}
+		return nullptr;
+	}
+
+	// Lag and loss on every packet the server and the clients send. Lag is added at both ends, so the
+	// round trip is LatencyMs
+	static void SetPacketSimulation(int32 LatencyMs, int32 LossPercent)
+	{
+#if DO_ENABLE_NET_TEST
+		FPacketSimulationSettings Settings;
+		Settings.PktLag = LatencyMs / 2;
+		Settings.PktLoss = LossPercent;
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* World = Context.World();
+			UNetDriver* NetDriver = Context.WorldType == EWorldType::PIE && World ? World->GetNetDriver() : nullptr;
+			if (NetDriver)
+			{
+				NetDriver->SetPacketSimulationSettings(Settings);
+			}
+		}
+#endif
+	}
+}
+
+// Starts a session once the map before it has loaded, then waits until the server and NumClients clients
+// each have a character holding a weapon
+class FStartLoopbackSessionCommand : public IAutomationLatentCommand
+{
+public:
+	FStartLoopbackSessionCommand(FAutomationTestBase* InTest, int32 InNumClients) :
+		Test(InTest),
+		NumClients(InNumClients)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		if (!bStarted)
+		{
+			ShooterLoopback::StartSession(NumClients);
+			bStarted = true;
+			return false;
+		}
+
+		UWorld* ServerWorld = ShooterLoopback::GetServerWorld();
+		const AShooterCharacter* ServerCharacter = ShooterLoopback::GetLocalCharacter(ServerWorld);
+		int32 NumReady{ServerCharacter && ServerCharacter->GetEquippedWeapon() ? 1 : 0};
+		for (UWorld* ClientWorld : ShooterLoopback::GetClientWorlds())
+		{
+			const AShooterCharacter* ClientCharacter = ShooterLoopback::GetLocalCharacter(ClientWorld);
+			if (ClientCharacter && ClientCharacter->GetEquippedWeapon())
+			{
+				++NumReady;
+			}
+		}
+		if (NumReady == NumClients + 1) return true;
+
+		if (GetCurrentRunTime() > ShooterLoopback::StartTimeout)
+		{
+			Test->AddError(FString::Printf(TEXT("Only %d of %d players were ready after %.0f seconds"), NumReady,
+				NumClients + 1, ShooterLoopback::StartTimeout));
+			return true;
+		}
+		return false;
+	}
+
+private:
+	FAutomationTestBase* Test;
+	int32 NumClients;
+	bool bStarted{false};
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
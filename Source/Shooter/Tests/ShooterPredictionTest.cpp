@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterPrediction.h"
+
+#include "ShooterBenchmarkSubsystem.h"
+#include "ShooterCharacter.h"
+#include "ShooterLoopbackTest.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+#include "Tests/AutomationEditorCommon.h"
+
+namespace ShooterPredictionTest
+{
+	static constexpr int32 LatencyMs{100};
+
+	// Time the client fires, reloads and swaps through the loss
+	static constexpr double PlayTime{10.0};
+
+	// Time for the last acks to come back once the loss stops
+	static constexpr double SettleTime{3.0};
+
+	// Seconds the fire button is held, then released for as long
+	static constexpr double BurstTime{0.6};
+
+	// Swaps to the next inventory slot every this many bursts, when there is one
+	static constexpr int32 BurstsPerSwap{3};
+
+	static FString DescribeState(const FShooterPredictedState& State)
+	{
+		return FString::Printf(TEXT("slot %d, %d ammo, %d/%d carried, %d items"), State.SlotIndex, State.Ammo,
+			State.CarriedAmmo[0], State.CarriedAmmo[1], State.NumInventoryItems);
+	}
+}
+
+// The client plays through lost packets, then its predicted state has to settle on the server's
+class FShooterPacketLossCommand : public IAutomationLatentCommand
+{
+public:
+	FShooterPacketLossCommand(FAutomationTestBase* InTest, int32 InLossPercent) :
+		Test(InTest),
+		LossPercent(InLossPercent)
+	{
+	}
+
+	virtual bool Update() override
+	{
+		using namespace ShooterPredictionTest;
+		UWorld* ServerWorld = ShooterLoopback::GetServerWorld();
+		const TArray<UWorld*> ClientWorlds{ShooterLoopback::GetClientWorlds()};
+		AShooterCharacter* Client = ClientWorlds.Num() > 0 ? ShooterLoopback::GetLocalCharacter(ClientWorlds[0]) : nullptr;
+		AShooterCharacter* Server = ShooterLoopback::GetServerCharacter(ServerWorld, Client);
+		if (!Client || !Server)
+		{
+			Test->AddError(TEXT("No client character to play with"));
+			return true;
+		}
+
+		if (StartSeconds == 0.0)
+		{
+			ShooterLoopback::SetPacketSimulation(LatencyMs, LossPercent);
+			Server->SetCanBeDamaged(false);
+			StartSeconds = FPlatformTime::Seconds();
+			return false;
+		}
+
+		const double Elapsed{FPlatformTime::Seconds() - StartSeconds};
+		if (Elapsed < PlayTime)
+		{
+			Play(Client, Elapsed);
+			return false;
+		}
+
+		if (!bSettling)
+		{
+			// Whatever is still in flight gets through from here on
+			FShooterLoopbackDriver::SetFiring(Client, false);
+			ShooterLoopback::SetPacketSimulation(LatencyMs, 0);
+			bSettling = true;
+		}
+		if (Elapsed < PlayTime + SettleTime) return false;
+
+		ShooterLoopback::SetPacketSimulation(0, 0);
+		Test->TestTrue(TEXT("Actions were predicted"), NumBursts > 0);
+		Test->TestEqual(TEXT("Every action acked"), FShooterLoopbackDriver::GetNumUnackedActions(Client), 0);
+
+		const FShooterPredictedState ClientState{FShooterLoopbackDriver::GetPredictedState(Client)};
+		const FShooterPredictedState ServerState{FShooterLoopbackDriver::GetPredictedState(Server)};
+		if (ClientState != ServerState)
+		{
+			Test->AddError(FString::Printf(TEXT("Client settled on %s, the server on %s"), *DescribeState(ClientState),
+				*DescribeState(ServerState)));
+		}
+		Test->AddInfo(FString::Printf(TEXT("%d%% loss: %d bursts, %d swaps, settled on %s"), LossPercent, NumBursts,
+			NumSwaps, *DescribeState(ClientState)));
+		return true;
+	}
+
+private:
+	// Bursts of fire with a reload after each, swapping weapons every few bursts
+	void Play(AShooterCharacter* Client, double Elapsed)
+	{
+		using namespace ShooterPredictionTest;
+		const int32 Burst{static_cast<int32>(Elapsed / BurstTime)};
+		const bool bFiring{Burst % 2 == 0};
+		FShooterLoopbackDriver::SetFiring(Client, bFiring);
+		if (Burst == LastBurst) return;
+
+		LastBurst = Burst;
+		if (bFiring)
+		{
+			++NumBursts;
+			return;
+		}
+
+		// A swap keeps the character busy, so it reloads on the next burst instead
+		const AWeapon* Weapon = Client->GetEquippedWeapon();
+		const int32 NumItems{FShooterLoopbackDriver::GetPredictedState(Client).NumInventoryItems};
+		if (Weapon && NumItems > 1 && NumBursts % BurstsPerSwap == 0)
+		{
+			FShooterLoopbackDriver::SwapToSlot(Client, (Weapon->GetSlotIndex() + 1) % NumItems);
+			if (Client->GetEquippedWeapon() != Weapon)
+			{
+				++NumSwaps;
+				return;
+			}
+		}
+		FShooterLoopbackDriver::PressReload(Client);
+	}
+
+	FAutomationTestBase* Test;
+	int32 LossPercent;
+
+	double StartSeconds{0.0};
+	bool bSettling{false};
+	int32 LastBurst{INDEX_NONE};
+	int32 NumBursts{0};
+	int32 NumSwaps{0};
+};
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FShooterPacketLossTest, "Shooter.Net.PacketLoss",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+void FShooterPacketLossTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const int32 LossPercent : {5, 20})
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%dPercent"), LossPercent));
+		OutTestCommands.Add(FString::FromInt(LossPercent));
+	}
+}
+
+bool FShooterPacketLossTest::RunTest(const FString& Parameters)
+{
+	// A listen server and one client in this process, every packet between them can be dropped
+	ADD_LATENT_AUTOMATION_COMMAND(FEditorLoadMap(GetDefault<UShooterBenchmarkSubsystem>()->GetAutomationMap()));
+	ADD_LATENT_AUTOMATION_COMMAND(FStartLoopbackSessionCommand(this, 1));
+	ADD_LATENT_AUTOMATION_COMMAND(FShooterPacketLossCommand(this, FCString::Atoi(*Parameters)));
+	ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
@@ -0,0 +1,76 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "ShooterRandomSubsystem.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace ShooterRandomTest
+{
+	static constexpr int32 NumRolls{1000};
+	static constexpr int32 NumStreams{static_cast<int32>(EShooterRandomStream::MAX)};
+
+	static TArray<uint32> Roll(UShooterRandomSubsystem* Random, EShooterRandomStream Stream)
+	{
+		TArray<uint32> Rolls;
+		Rolls.Reserve(NumRolls);
+		for (int32 i = 0; i < NumRolls; ++i)
+		{
+			Rolls.Add(Random->GetStream(Stream).GetUnsignedInt());
+		}
+		return Rolls;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterRandomSeedTest, "Shooter.Random.Seed",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+bool FShooterRandomSeedTest::RunTest(const FString& Parameters)
+{
+	using namespace ShooterRandomTest;
+	UShooterRandomSubsystem* Random = NewObject<UShooterRandomSubsystem>(GetTransientPackage());
+	const int32 Seed{1234};
+
+	Random->SetSeed(Seed);
+	TArray<uint32> FirstRun[NumStreams];
+	for (int32 i = 0; i < NumStreams; ++i)
+	{
+		FirstRun[i] = Roll(Random, static_cast<EShooterRandomStream>(i));
+	}
+
+	// The same seed rolls the same numbers, whatever order the streams are used in
+	Random->SetSeed(Seed);
+	for (int32 i = NumStreams - 1; i >= 0; --i)
+	{
+		TestTrue(FString::Printf(TEXT("Stream %d repeats with the seed"), i),
+			Roll(Random, static_cast<EShooterRandomStream>(i)) == FirstRun[i]);
+	}
+
+	// No stream repeats another
+	for (int32 i = 0; i < NumStreams; ++i)
+	{
+		for (int32 j = i + 1; j < NumStreams; ++j)
+		{
+			TestTrue(FString::Printf(TEXT("Streams %d and %d differ"), i, j), FirstRun[i] != FirstRun[j]);
+		}
+	}
+
+	// Extra rolls in one stream don't shift the others
+	Random->SetSeed(Seed);
+	Roll(Random, EShooterRandomStream::Combat);
+	Roll(Random, EShooterRandomStream::Combat);
+	for (int32 i = 0; i < NumStreams; ++i)
+	{
+		if (i == static_cast<int32>(EShooterRandomStream::Combat)) continue;
+		TestTrue(FString::Printf(TEXT("Stream %d unaffected by combat rolls"), i),
+			Roll(Random, static_cast<EShooterRandomStream>(i)) == FirstRun[i]);
+	}
+
+	// And a different seed rolls different numbers
+	Random->SetSeed(Seed + 1);
+	TestTrue(TEXT("Another seed rolls differently"), Roll(Random, EShooterRandomStream::Combat) != FirstRun[0]);
+	return true;
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,52 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// An empty game world for tests that need subsystems, traces or timers without loading a map. Actors
+// spawned into it begin play, and each Tick runs a whole frame, async traces and tickable objects included
+class FShooterTestWorld
+{
+public:
+	FShooterTestWorld()
+	{
+		World = UWorld::CreateWorld(EWorldType::Game, false);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		// There's no game mode to start play, so begin it on the world settings directly
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+		World->GetWorldSettings()->NotifyBeginPlay();
+	}
+
+	~FShooterTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	FShooterTestWorld(const FShooterTestWorld&) = delete;
+	FShooterTestWorld& operator=(const FShooterTestWorld&) = delete;
+
+	void Tick(float DeltaTime)
+	{
+		World->Tick(LEVELTICK_All, DeltaTime);
+	}
+
+	template<typename T>
+	T* GetSubsystem() const
+	{
+		return World->GetSubsystem<T>();
+	}
+
+	UWorld* World;
+};
+
+#endif // WITH_DEV_AUTOMATION_TESTS
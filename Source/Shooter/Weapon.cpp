@@ -3,6 +3,12 @@
 
 #include "Weapon.h"
 
+#include "ShooterDataRegistry.h"
+#include "ShooterRandomSubsystem.h"
+#include "ShooterStats.h"
+
+DECLARE_CYCLE_STAT(TEXT("Weapon Tick"), STAT_WeaponTick, STATGROUP_Shooter);
+
 AWeapon::AWeapon():
 ThrowWeaponTime(0.7f),
 bFalling(false),
@@ -18,8 +24,7 @@ bMovingSlide(false),
 MaxSlideDisplacement(4.f),
 MaxRecoilRotation(20.f),
 bAutomatic(true),
-Damage(5.f),
-HeadShotDamage(10.f)
+Damage(5.f)
 {
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -47,13 +52,14 @@ void AWeapon::ThrowWeapon()
 	// Direction in which we throw the weapon
 	FVector ImpulseDirection = MeshRight.RotateAngleAxis(-20.f, MeshForward);
 
-	float RandomRotation{FMath::FRandRange(-10.f,10.f)};
+	float RandomRotation{UShooterRandomSubsystem::GetStream(this, EShooterRandomStream::Loot).FRandRange(-10.f, 10.f)};
 	ImpulseDirection = ImpulseDirection.RotateAngleAxis(RandomRotation, FVector(0.f, 0.f, 1.f));
 	ImpulseDirection *= 20000;
 	GetItemMesh()->AddImpulse(ImpulseDirection);
 
 	bFalling = true;
 	GetWorldTimerManager().SetTimer(ThrowWeaponTimer, this, &AWeapon::StopFalling, ThrowWeaponTime);
+	UpdateTickEnabled();
 
 	EnableGlowMaterial();
 }
@@ -69,24 +75,11 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 {
 	Super::OnConstruction(Transform);
 
-	const FString WeaponTablePath{TEXT("DataTable'/Game/_Game/DataTables/WeaponDataTable.WeaponDataTable'")};
-	UDataTable* WeaponTableObject = Cast<UDataTable>(StaticLoadObject(UDataTable::StaticClass(), nullptr, *WeaponTablePath));
-	if (WeaponTableObject)
+	// Weapon data, cached by the registry
+	UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
+	if (DataRegistry)
 	{
-		FWeaponDataTable* WeaponDataRow = nullptr;
-		switch (WeaponType)
-		{
-		case EWeaponType::EWT_SubmachineGun:
-			WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("SubmachineGun"), TEXT(""));
-			break;
-		case EWeaponType::EWT_AssaultRifle:
-			WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("AssaultRifle"), TEXT(""));
-			break;
-		case EWeaponType::EWT_Pistol:
-			WeaponDataRow = WeaponTableObject->FindRow<FWeaponDataTable>(FName("Pistol"), TEXT(""));
-			break;			
-		}
-
+		const FWeaponDataTable* WeaponDataRow = DataRegistry->GetWeaponRow(WeaponType);
 		if (WeaponDataRow)
 		{
 			AmmoType = WeaponDataRow->AmmoType;
@@ -121,7 +114,6 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 			BoneToHide = WeaponDataRow->BoneToHide;
 			bAutomatic = WeaponDataRow->bAutomatic;
 			Damage = WeaponDataRow->Damage;
-			HeadShotDamage = WeaponDataRow->HeadShotDamage;
 		}
 	}
 	if (GetMaterialInstance())
@@ -136,6 +128,12 @@ void AWeapon::OnConstruction(const FTransform& Transform)
 void AWeapon::FinishMovingSlide()
 {
 	bMovingSlide = false;
+	UpdateTickEnabled();
+}
+
+bool AWeapon::ShouldTickItem() const
+{
+	return Super::ShouldTickItem() || bFalling || bMovingSlide;
 }
 
 void AWeapon::UpdateSlideDisplacement()
@@ -151,6 +149,7 @@ void AWeapon::UpdateSlideDisplacement()
 
 void AWeapon::Tick(float DeltaTime)
 {
+	SHOOTER_SCOPE_CYCLE_COUNTER(STAT_WeaponTick, Weapons);
 	Super::Tick(DeltaTime);
 
 	// Keep the weapon upright
@@ -164,6 +163,21 @@ void AWeapon::Tick(float DeltaTime)
 	UpdateSlideDisplacement();
 }
 
+void AWeapon::ResetForPool()
+{
+	bFalling = false;
+	bMovingSlide = false;
+	SlideDisplacement = 0.f;
+	RecoilRotation = 0.f;
+
+	// Full magazine, as if it were just spawned
+	UShooterDataRegistry* DataRegistry = UShooterDataRegistry::Get();
+	const FWeaponDataTable* WeaponDataRow = DataRegistry ? DataRegistry->GetWeaponRow(WeaponType) : nullptr;
+	Ammo = WeaponDataRow ? WeaponDataRow->WeaponAmmo : GetClass()->GetDefaultObject<AWeapon>()->Ammo;
+
+	Super::ResetForPool();
+}
+
 void AWeapon::DecrementAmmo()
 {
 	if (Ammo - 1 <= 0)
@@ -191,6 +205,7 @@ void AWeapon::StartSlideTimer()
 {
 	bMovingSlide = true;
 	GetWorldTimerManager().SetTimer(SlideTimer, this, &AWeapon::FinishMovingSlide, SlideDisplacementTime);
+	UpdateTickEnabled();
 }
 
 
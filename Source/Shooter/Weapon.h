@@ -85,11 +85,9 @@ struct FWeaponDataTable : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool bAutomatic;
 
+	// Base damage, scaled by the hit zone multiplier of whatever we hit
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float Damage;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	float HeadShotDamage;
 };
 
 /**
@@ -113,8 +111,13 @@ protected:
 
 	void UpdateSlideDisplacement();
 
+	// Also tick while the weapon is being thrown or the slide is moving
+	virtual bool ShouldTickItem() const override;
+
 public:
 	virtual void Tick(float DeltaTime) override;
+
+	virtual void ResetForPool() override;
 	
 private:
 	FTimerHandle ThrowWeaponTimer;
@@ -219,13 +222,9 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WeaponProperties, meta = (AllowPrivateAccess = "true"))
 	bool bAutomatic;
 
-	// Amount of damage caused by a bullet
+	// Amount of damage caused by a bullet, before the hit zone multiplier
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WeaponProperties, meta = (AllowPrivateAccess = "true"))
 	float Damage;
-
-	// Amount of damage caused by a HeadShot
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = WeaponProperties, meta = (AllowPrivateAccess = "true"))
-	float HeadShotDamage;
 	
 public:
 	// Adds an impulse to the weapon
@@ -239,6 +238,9 @@ public:
 	void DecrementAmmo();
 
 	FORCEINLINE EWeaponType GetWeaponType() const { return WeaponType; }
+
+	// Only takes effect before construction, the weapon data is read in OnConstruction
+	FORCEINLINE void SetWeaponType(EWeaponType Type) { WeaponType = Type; }
 	
 	FORCEINLINE EAmmoType GetAmmoType() const { return AmmoType; }
 
@@ -248,6 +250,9 @@ public:
 
 	void ReloadAmmo(int32 Amount);
 
+	// Overwrites the ammo count, for taking the server's count after a misprediction
+	FORCEINLINE void SetAmmo(int32 Amount) { Ammo = FMath::Clamp(Amount, 0, MagazineCapacity); }
+
 	FORCEINLINE void SetClipBoneName(FName Name) { ClipBoneName = Name; }
 	
 	FORCEINLINE FName GetClipBoneName() const { return ClipBoneName; }
@@ -267,6 +272,4 @@ public:
 	FORCEINLINE bool GetAutomatic() const { return bAutomatic; }
 
 	FORCEINLINE float GetDamage() const { return Damage; }
-
-	FORCEINLINE float GetHeadShotDamage() const { return HeadShotDamage; }
 };